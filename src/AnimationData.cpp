@@ -1,8 +1,30 @@
 #include "AnimationData.h"
+#include "SimClock.h" // secondsToTicks
 #include <stdio.h> // for printf
 
 // 初始化靜態成員變數
 std::map<std::string, std::map<AnimationType, AnimationInfo>> AnimationDataManager::characterAnimations;
+const AnimationInfo* AnimationDataManager::animationTable[CHARACTER_COUNT][ANIMATION_TYPE_COUNT] = {};
+
+namespace {
+
+// 面向右的框 -> 面向左 (以碰撞尺寸的中線翻轉)
+SDL_Rect mirrorBox(const SDL_Rect& box, int logicWidth) {
+    return {logicWidth - box.x - box.w, box.y, box.w, box.h};
+}
+
+FrameBoxes makeFrameBoxes(const FrameBoxSpec& spec, int logicWidth) {
+    FrameBoxes boxes;
+    boxes.hurtbox[0] = spec.hurtbox;
+    boxes.hurtbox[1] = mirrorBox(spec.hurtbox, logicWidth);
+    boxes.hitbox[0] = spec.hitbox;
+    boxes.hitbox[1] = mirrorBox(spec.hitbox, logicWidth);
+    boxes.hasHitbox = spec.hitbox.w > 0 && spec.hitbox.h > 0;
+    boxes.hurtboxOnGround = spec.hurtboxOnGround;
+    return boxes;
+}
+
+} // namespace
 
 void AnimationDataManager::defineAnimation(const std::string& characterId, AnimationType type,
                                          const std::vector<SDL_Rect>& frameRects,
@@ -19,13 +41,66 @@ void AnimationDataManager::defineAnimation(const std::string& characterId, Anima
     info.frameDuration = duration;
     info.loop = shouldLoop;
 
+    // 以模擬 tick 為單位的幀索引表 (每幀至少一個 tick)，播放時只查表
+    int ticksPerFrame = static_cast<int>(secondsToTicks(duration));
+    if (ticksPerFrame < 1) ticksPerFrame = 1;
+    info.frameAtTick.resize(info.frameCount * ticksPerFrame);
+    for (size_t t = 0; t < info.frameAtTick.size(); ++t) {
+        info.frameAtTick[t] = static_cast<int>(t) / ticksPerFrame;
+    }
+
+    // 預設判定框：每一幀都是整個碰撞尺寸，沒有攻擊框
+    int characterIndex = findCharacterIndex(characterId);
+    FrameBoxSpec body;
+    if (characterIndex >= 0) {
+        const CharacterTraits& traits = CHARACTER_TRAITS[characterIndex];
+        body.hurtbox = {0, 0, traits.logicWidth, traits.logicHeight};
+        info.boxes.assign(info.frameCount, makeFrameBoxes(body, traits.logicWidth));
+    } else {
+        body.hurtbox = {0, 0, 0, 0};
+        info.boxes.assign(info.frameCount, makeFrameBoxes(body, 0));
+    }
+
     // 存入 Map
-    characterAnimations[characterId][type] = info;
+    AnimationInfo& stored = characterAnimations[characterId][type];
+    stored = info;
+    if (characterIndex >= 0) {
+        animationTable[characterIndex][static_cast<int>(type)] = &stored;
+    }
 
     // printf("Defined animation for %s, type %d with %d frames.\n",
     //        characterId.c_str(), static_cast<int>(type), info.frameCount);
 }
 
+void AnimationDataManager::defineFrameBoxes(const std::string& characterId, AnimationType type,
+                                            const std::vector<FrameBoxSpec>& specs) {
+    int characterIndex = findCharacterIndex(characterId);
+    auto charIt = characterAnimations.find(characterId);
+    if (characterIndex < 0 || charIt == characterAnimations.end() || charIt->second.count(type) == 0) {
+        printf("Warning: Frame boxes for '%s' type %d defined before its animation.\n",
+               characterId.c_str(), static_cast<int>(type));
+        return;
+    }
+    AnimationInfo& info = charIt->second[type];
+    if (static_cast<int>(specs.size()) != info.frameCount) {
+        printf("Warning: '%s' type %d has %d frames but %d frame boxes.\n",
+               characterId.c_str(), static_cast<int>(type), info.frameCount, static_cast<int>(specs.size()));
+        return;
+    }
+    int logicWidth = CHARACTER_TRAITS[characterIndex].logicWidth;
+    for (int i = 0; i < info.frameCount; ++i) {
+        info.boxes[i] = makeFrameBoxes(specs[i], logicWidth);
+    }
+}
+
+const AnimationInfo* AnimationDataManager::getAnimationInfo(int characterIndex, AnimationType type) {
+    int typeIndex = static_cast<int>(type);
+    if (characterIndex < 0 || characterIndex >= CHARACTER_COUNT || typeIndex < 0 || typeIndex >= ANIMATION_TYPE_COUNT) {
+        return nullptr;
+    }
+    return animationTable[characterIndex][typeIndex];
+}
+
 const AnimationInfo* AnimationDataManager::getAnimationInfo(const std::string& characterId, AnimationType type) {
     // 找角色
     auto charIt = characterAnimations.find(characterId);
@@ -57,6 +132,9 @@ void AnimationDataManager::initializeBlockManAnimations() {
     const int BLOCK_W = 66, BLOCK_H = 115;
     const int DEATH_W = 83, DEATH_H = 103;     
 
+    // 判定框 (面向右，以碰撞尺寸 120x205 的左上角為原點)
+    const SDL_Rect BODY = {0, 0, BLOCKMAN_LOGIC_WIDTH, BLOCKMAN_LOGIC_HEIGHT};
+    const SDL_Rect PUNCH = {100, 77, 60, 51}; // 胸口高度、伸出身體前方 40 像素
 
     // Idle 動畫 (4 幀, 在 Y=0 開始)
     std::vector<SDL_Rect> idleFrames;
@@ -71,6 +149,10 @@ void AnimationDataManager::initializeBlockManAnimations() {
     // Attack 動畫 (2 幀, 在 Y=355 開始, 硬編碼)
     std::vector<SDL_Rect> attackFrames = {{190, 355, ATTACK_W, ATTACK_H}, {270, 355, ATTACK_W, ATTACK_H}};
     defineAnimation(charId, AnimationType::ATTACK, attackFrames, 0.15f, false); // 攻擊動畫通常不循環，時間可調
+    defineFrameBoxes(charId, AnimationType::ATTACK, {{BODY, PUNCH}, {BODY}}); // 第一幀出拳，第二幀收招
+
+    // 特殊技能 (擊倒對手，不靠攻擊框) 使用攻擊動畫的幀
+    defineAnimation(charId, AnimationType::SPECIAL, attackFrames, 0.15f, false);
 
     // Hurt 動畫 (3 幀, 在 Y=2145 開始, 硬編碼)
     std::vector<SDL_Rect> hurtFrames;
@@ -96,6 +178,7 @@ void AnimationDataManager::initializeBlockManAnimations() {
     // LYING 動畫 (1 幀)
     std::vector<SDL_Rect> lyingFrames = {{1170, 2210, 102, 45}};
     defineAnimation(charId, AnimationType::LYING, lyingFrames, 0.1f, false);
+    defineFrameBoxes(charId, AnimationType::LYING, {{{0, 0, BLOCKMAN_LOGIC_WIDTH, 71}, {0, 0, 0, 0}, true}}); // 身高的 35%
 
      // --- 新增 VICTORY 動畫 ---
     // vvvvv 請務必換成你實際的勝利動畫幀數據 vvvvv
@@ -120,6 +203,10 @@ void AnimationDataManager::initializeBlockManAnimations() {
 void AnimationDataManager::initializeGodonAnimations() {
     const std::string charId = "Godon"; // 定義此角色的 ID
 
+    // 判定框 (面向右，以碰撞尺寸 160x245 的左上角為原點)
+    const SDL_Rect BODY = {0, 0, GODON_LOGIC_WIDTH, GODON_LOGIC_HEIGHT};
+    const SDL_Rect PUNCH = {140, 92, 80, 61}; // 胸口高度、伸出身體前方 60 像素
+
     // IDLE animation (4 frames)
     std::vector<SDL_Rect> idleFrames = {
         {10, 14, 112, 115},    // Frame 1
@@ -143,6 +230,11 @@ void AnimationDataManager::initializeGodonAnimations() {
         {1050, 548, 115, 130}    // Frame 3
     };
     defineAnimation(charId, AnimationType::ATTACK, attackFrames, 0.15f, false); // 調整為 0.1f 使每幀播放更流暢
+    defineFrameBoxes(charId, AnimationType::ATTACK, {{BODY, PUNCH}, {BODY}, {BODY}}); // 只有第一幀有攻擊判定
+
+    // 特殊技能 (衝刺)：同樣的幀，整段衝刺都帶著攻擊框 (停在最後一幀直到衝刺結束或撞到人)
+    defineAnimation(charId, AnimationType::SPECIAL, attackFrames, 0.15f, false);
+    defineFrameBoxes(charId, AnimationType::SPECIAL, {{BODY, PUNCH}, {BODY, PUNCH}, {BODY, PUNCH}});
 
     // Hurt 動畫 (3 幀)
     std::vector<SDL_Rect> hurtFrames;
@@ -170,6 +262,7 @@ void AnimationDataManager::initializeGodonAnimations() {
     // LYING 動畫 (1 幀)
     std::vector<SDL_Rect> lyingFrames = {{137, 5534, 128, 63}};
     defineAnimation(charId, AnimationType::LYING, lyingFrames, 0.1f, false);
+    defineFrameBoxes(charId, AnimationType::LYING, {{{0, 0, GODON_LOGIC_WIDTH, 85}, {0, 0, 0, 0}, true}}); // 身高的 35%
 
     printf("Initialized animations for character: %s\n", charId.c_str());
 }
\ No newline at end of file
@@ -5,12 +5,34 @@
 #include <vector>
 #include <string>
 #include <map>
+#include "CharacterTraits.h" // CHARACTER_COUNT、碰撞尺寸
 
 // --- 角色動畫類型 ---
 enum class AnimationType {
-    IDLE, WALK, JUMP, FALL, ATTACK, HURT, BLOCK, DEATH, VICTORY, LYING
-    // 可以根據需要增加更多類型
+    IDLE, WALK, JUMP, FALL, ATTACK, HURT, BLOCK, DEATH, VICTORY, LYING,
+    SPECIAL // 特殊技能 (攻擊狀態中，判定框與普攻不同)
+    // 可以根據需要增加更多類型 (加在最後面，快照存的是數值)
 };
+const int ANIMATION_TYPE_COUNT = static_cast<int>(AnimationType::SPECIAL) + 1;
+
+// --- 單一幀的判定框 (編寫用) ---
+// 以角色面向右、碰撞尺寸 (logicWidth x logicHeight) 的左上角為原點，單位為像素
+struct FrameBoxSpec {
+    SDL_Rect hurtbox;                // 受擊框
+    SDL_Rect hitbox = {0, 0, 0, 0};  // 攻擊框 (寬為 0 表示這一幀沒有攻擊判定)
+    bool hurtboxOnGround = false;    // 受擊框貼齊地面，不跟著 y (躺下)
+};
+
+// --- 單一幀的判定框 (載入時換算好，執行時只查表) ---
+// 索引 0 為面向右、1 為面向左 (以碰撞尺寸的中線左右翻轉)，都是相對於角色 (x, y) 的偏移
+struct FrameBoxes {
+    SDL_Rect hurtbox[2];
+    SDL_Rect hitbox[2];
+    bool hasHitbox = false;
+    bool hurtboxOnGround = false;
+};
+
+inline int facingIndex(int direction) { return direction == 1 ? 0 : 1; }
 
 // --- 單一動畫的資料 ---
 struct AnimationInfo {
@@ -18,7 +40,17 @@ struct AnimationInfo {
     int frameCount = 0;                 // 幀數 (frames.size())
     float frameDuration = 0.1f;         // 每幀持續時間 (可覆寫預設值)
     bool loop = true;                   // 是否循環播放
+    std::vector<FrameBoxes> boxes;      // 每一幀的判定框 (與 frames 等長，預設為整個碰撞尺寸、沒有攻擊框)
+    std::vector<int> frameAtTick;       // 進入動畫後第 t 個 tick 顯示的幀 (播放一輪的長度，載入時算好)
     // 可以加入其他屬性，例如特定動畫的音效 ID 等
+
+    // 進入動畫後經過 ticks 個模擬 tick 時顯示的幀 (循環的動畫取餘數，不循環的停在最後一幀)
+    int frameAt(Uint32 ticks) const {
+        if (frameAtTick.empty()) return 0;
+        Uint32 length = static_cast<Uint32>(frameAtTick.size());
+        if (ticks < length) return frameAtTick[ticks];
+        return loop ? frameAtTick[ticks % length] : frameCount - 1;
+    }
 };
 
 // --- 角色動畫數據管理器 ---
@@ -34,8 +66,14 @@ public:
                                 const std::vector<SDL_Rect>& frameRects,
                                 float duration = 0.1f, bool shouldLoop = true);
 
+    // 設定每一幀的判定框 (在 defineAnimation 之後呼叫，數量必須等於幀數)
+    static void defineFrameBoxes(const std::string& characterId, AnimationType type,
+                                 const std::vector<FrameBoxSpec>& specs);
+
     // 取得特定角色、特定動畫類型的資料
     static const AnimationInfo* getAnimationInfo(const std::string& characterId, AnimationType type);
+    // 以角色索引 (CHARACTER_TRAITS) 查表，模擬中使用 (不比對字串)；找不到時回傳 nullptr
+    static const AnimationInfo* getAnimationInfo(int characterIndex, AnimationType type);
 
     // (建議) 從設定檔載入所有角色動畫 (未來擴充)
     // static bool loadAnimationsFromFile(const std::string& filePath);
@@ -50,6 +88,8 @@ public:
 private:
     // 使用巢狀 Map 來儲存: characterId -> AnimationType -> AnimationInfo
     static std::map<std::string, std::map<AnimationType, AnimationInfo>> characterAnimations;
+    // 角色索引 x 動畫類型 -> 上面 map 裡的資料 (map 的節點不會搬動)
+    static const AnimationInfo* animationTable[CHARACTER_COUNT][ANIMATION_TYPE_COUNT];
 };
 
 
@@ -0,0 +1,53 @@
+#include "Archetype.h"
+
+namespace {
+
+// 把最後一個欄位搬到 to (沒有這個元件時陣列是空的，直接跳過)
+template <typename T>
+void moveLane(std::vector<T>& lane, int to, int from) {
+    if (!lane.empty()) lane[to] = lane[from];
+}
+
+} // namespace
+
+void ArchetypeLanes::allocate(Uint16 componentMask, int newCapacity) {
+    components = componentMask;
+    capacity = newCapacity < 1 ? 1 : newCapacity;
+    count = 0;
+    int padded = (capacity + 7) / 8 * 8;
+    x.assign(has(COMPONENT_MOTION) ? padded : 0, 0.0f);
+    y.assign(has(COMPONENT_MOTION) ? padded : 0, 0.0f);
+    vx.assign(has(COMPONENT_MOTION) ? padded : 0, 0.0f);
+    vy.assign(has(COMPONENT_GRAVITY) ? padded : 0, 0.0f);
+    owner.assign(has(COMPONENT_OWNER) ? padded : 0, -1);
+    alive.assign(padded, 0);
+    hits.assign(has(COMPONENT_HITBOX) ? padded : 0, 0);
+    expiresAt.assign(has(COMPONENT_LIFETIME) ? padded : 0, 0);
+    sprite.assign(has(COMPONENT_SPRITE) ? padded : 0, 0);
+}
+
+int ArchetypeLanes::add() {
+    if (count >= capacity) return -1;
+    int i = count++;
+    alive[i] = 1;
+    return i;
+}
+
+void ArchetypeLanes::removeInactive() {
+    for (int i = 0; i < count;) {
+        if (alive[i]) {
+            ++i;
+            continue;
+        }
+        int last = --count;
+        moveLane(x, i, last);
+        moveLane(y, i, last);
+        moveLane(vx, i, last);
+        moveLane(vy, i, last);
+        moveLane(owner, i, last);
+        moveLane(alive, i, last);
+        moveLane(hits, i, last);
+        moveLane(expiresAt, i, last);
+        moveLane(sprite, i, last);
+    }
+}
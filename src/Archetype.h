@@ -0,0 +1,42 @@
+#ifndef ARCHETYPE_H
+#define ARCHETYPE_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+// --- 實體的元件 ---
+// 同一種實體 (氣功、特效粒子...) 的元件組合都相同，放在同一個 archetype 裡：每個元件是一個緊密的陣列，
+// 系統 (移動、壽命、碰撞、繪製) 只處理擁有對應元件的 archetype，每次都是線性掃過 [0, count)。
+enum ComponentBit : Uint16 {
+    COMPONENT_MOTION   = 1 << 0, // x, y, vx：水平等速移動
+    COMPONENT_GRAVITY  = 1 << 1, // vy：受重力影響的垂直速度
+    COMPONENT_OWNER    = 1 << 2, // owner：發射者 (不會打到自己)
+    COMPONENT_HITBOX   = 1 << 3, // hits：這個 tick 碰到哪些玩家
+    COMPONENT_LIFETIME = 1 << 4, // expiresAt：到期的 tick
+    COMPONENT_SPRITE   = 1 << 5  // sprite：外觀表的索引
+};
+
+// --- 一個 archetype 的 structure-of-arrays ---
+// 陣列長度補齊成 8 的倍數 (AVX2 一次 8 個)；[0, count) 是有效的實體，後面是空閒欄位。
+// 沒有的元件陣列保持空的。建立後不再配置記憶體，移除時拿最後一個補洞 (順序不保留)。
+struct ArchetypeLanes {
+    Uint16 components = 0;
+    int count = 0;
+    int capacity = 0;
+    std::vector<float> x, y, vx;
+    std::vector<float> vy;
+    std::vector<Sint32> owner;
+    std::vector<Sint32> alive;  // 1: 有效, 0: 本 tick 失效 (tick 結束前由 removeInactive 移除)
+    std::vector<Uint32> hits;   // 第 t 個位元：碰到第 t 個目標
+    std::vector<Uint32> expiresAt;
+    std::vector<Uint8> sprite;
+
+    void allocate(Uint16 componentMask, int newCapacity);
+    // 佔用下一個空閒欄位並標記為有效，回傳索引 (元件的值由呼叫者寫入)；滿了回傳 -1
+    int add();
+    void removeInactive();
+    void clear() { count = 0; }
+    bool has(Uint16 component) const { return (components & component) != 0; }
+};
+
+#endif // ARCHETYPE_H
@@ -11,6 +11,7 @@ std::map<std::string, Mix_Music*> AudioManager::musicMap;
 std::map<std::string, Mix_Chunk*> AudioManager::soundMap;
 std::vector<std::string> AudioManager::soundIds;
 bool AudioManager::isInitialized = false;
+bool AudioManager::muted = false;
 std::random_device AudioManager::rd;
 std::mt19937 AudioManager::gen(AudioManager::rd());
 
@@ -79,7 +80,7 @@ bool AudioManager::loadSound(const std::string& id, const std::string& filePath)
 }
 
 void AudioManager::playMusic(const std::string& id, int loops) {
-    if (!isInitialized) return;
+    if (!isInitialized || muted) return;
     if (musicMap.count(id)) {
         if (Mix_PlayMusic(musicMap[id], loops) == -1) {
             printf("Failed to play music '%s'! Mix_Error: %s\n", id.c_str(), Mix_GetError());
@@ -106,7 +107,7 @@ void AudioManager::resumeMusic() {
 
 
 int AudioManager::playSound(const std::string& id, int loops) {
-    if (!isInitialized) return -1;
+    if (!isInitialized || muted) return -1;
     if (soundMap.count(id)) {
         // 播放音效在第一個可用的 channel (-1) 上，重複 loops 次 (0 表示播放一次)
         int channel = Mix_PlayChannel(-1, soundMap[id], loops);
@@ -140,6 +141,10 @@ void AudioManager::setSoundVolume(const std::string& id, int volume) {
      }
 }
 
+void AudioManager::setMuted(bool mute) {
+    muted = mute;
+}
+
 void AudioManager::setMusicVolume(int volume) {
     if (!isInitialized) return;
     Mix_VolumeMusic(volume); // 設定 BGM 的音量
@@ -176,7 +181,7 @@ void AudioManager::cleanup() {
 }
 
 int AudioManager::playRandomSound(const std::string& type, int loops) {
-    if (!isInitialized) return -1;
+    if (!isInitialized || muted) return -1;
 
     // 收集所有以指定類型開頭的音效ID
     std::vector<std::string> matchingSounds;
@@ -48,6 +48,10 @@ public:
     // 設定 BGM 音量 (0-128)
     static void setMusicVolume(int volume);
 
+    // 靜音 (重播跳轉時快速重新模擬，不該發出聲音)
+    static void setMuted(bool mute);
+    static bool isMuted() { return muted; }
+
     // 清理資源
     static void cleanup();
 
@@ -59,6 +63,7 @@ private:
     static std::map<std::string, Mix_Chunk*> soundMap;
     static std::vector<std::string> soundIds; // 方便設定音量
     static bool isInitialized;
+    static bool muted;
     static std::random_device rd; // 用於生成隨機數
     static std::mt19937 gen; // Mersenne Twister 隨機數生成器
 };
@@ -0,0 +1,285 @@
+#include "BatchRunner.h"
+#include "Game.h"
+#include "Log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+namespace {
+
+// --- 矩陣的一個軸：角色 x 拳套 ---
+const int LOADOUT_COUNT = CHARACTER_COUNT * GLOVE_TYPE_COUNT;
+const int MATCHES_PER_JOB = 10; // 每個工作單位的場數 (小一點各執行緒才會差不多同時做完)
+
+std::string loadoutCharacter(int loadout) { return CHARACTER_TRAITS[loadout / GLOVE_TYPE_COUNT].id; }
+int loadoutGlove(int loadout) { return loadout % GLOVE_TYPE_COUNT; }
+
+std::string loadoutName(int loadout) {
+    return loadoutCharacter(loadout) + "/" + std::to_string(10 + 4 * loadoutGlove(loadout)) + "oz";
+}
+
+// 依名稱修改一個平衡性參數，名稱不存在時回傳 false
+bool setBalanceParam(BalanceParams& params, const std::string& name, float value) {
+    static const char* const GLOVE_SUFFIX[GLOVE_TYPE_COUNT] = {"10", "14", "18"};
+    for (int i = 0; i < GLOVE_TYPE_COUNT; ++i) {
+        if (name == std::string("glove-cooldown-") + GLOVE_SUFFIX[i]) {
+            params.gloveCooldown[i] = value;
+            return true;
+        }
+        if (name == std::string("glove-damage-") + GLOVE_SUFFIX[i]) {
+            params.gloveDamage[i] = static_cast<int>(value + 0.5f);
+            return true;
+        }
+    }
+    if (name == "projectile-damage") {
+        params.projectileDamage = static_cast<int>(value + 0.5f);
+        return true;
+    }
+    if (name == "special-cooldown") {
+        params.specialAttackCooldown = value;
+        return true;
+    }
+    if (name == "input-buffer") {
+        params.inputBufferTicks = static_cast<int>(value + 0.5f);
+        return true;
+    }
+    return false;
+}
+
+// --sweep name=v1,v2,...
+bool parseSweep(const char* text, BalanceSweep& out) {
+    const char* eq = strchr(text, '=');
+    if (!eq) return false;
+    out.name.assign(text, eq - text);
+    BalanceParams probe;
+    if (!setBalanceParam(probe, out.name, 0.0f)) return false;
+    out.values.clear();
+    const char* p = eq + 1;
+    while (*p) {
+        char* end = nullptr;
+        float value = strtof(p, &end);
+        if (end == p) return false;
+        out.values.push_back(value);
+        p = (*end == ',') ? end + 1 : end;
+        if (*end != ',' && *end != '\0') return false;
+    }
+    return !out.values.empty();
+}
+
+// --- 工作分配 ---
+struct BatchJob {
+    int paramSet;
+    int p1Loadout;
+    int p2Loadout;
+    int firstMatch;
+    int matchCount;
+};
+
+struct CellResult {
+    int wins[2] = {0, 0};
+    int unfinished = 0;
+    Uint64 ticks = 0;
+};
+
+// 每個工作執行緒擁有自己的 Game，依序領取工作；結果寫進各自的格子，不需要鎖
+void runWorker(const BatchConfig& config, const std::vector<BalanceParams>& paramSets,
+               const std::vector<BatchJob>& jobs, std::vector<CellResult>& results,
+               std::atomic<size_t>& nextJob) {
+    Game game;
+    game.isHeadless = true;
+    for (size_t j = nextJob.fetch_add(1); j < jobs.size(); j = nextJob.fetch_add(1)) {
+        const BatchJob& job = jobs[j];
+        game.balance = paramSets[job.paramSet];
+
+        HeadlessMatchSetup setup;
+        setup.characterIds[0] = loadoutCharacter(job.p1Loadout);
+        setup.characterIds[1] = loadoutCharacter(job.p2Loadout);
+        setup.gloveIndex[0] = loadoutGlove(job.p1Loadout);
+        setup.gloveIndex[1] = loadoutGlove(job.p2Loadout);
+        setup.chaosMode = config.chaosMode;
+        setup.maxTicks = config.maxTicksPerMatch;
+
+        CellResult& result = results[j];
+        for (int m = 0; m < job.matchCount; ++m) {
+            setup.seed = config.seed + static_cast<Uint32>(job.firstMatch + m);
+            int winner = game.playHeadlessMatch(setup);
+            if (winner == 0 || winner == 1) {
+                ++result.wins[winner];
+            } else {
+                ++result.unfinished;
+            }
+            result.ticks += game.matchTick;
+        }
+    }
+}
+
+} // namespace
+
+bool parseBatchArgs(int argc, char* argv[], BatchConfig& out) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "--batch") == 0) {
+            out.enabled = true;
+        } else if (strcmp(arg, "--matches") == 0 && hasValue) {
+            out.matchesPerCell = atoi(argv[++i]);
+        } else if (strcmp(arg, "--threads") == 0 && hasValue) {
+            out.threads = atoi(argv[++i]);
+        } else if (strcmp(arg, "--seed") == 0 && hasValue) {
+            out.seed = static_cast<Uint32>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(arg, "--max-ticks") == 0 && hasValue) {
+            out.maxTicksPerMatch = static_cast<Uint32>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(arg, "--out") == 0 && hasValue) {
+            out.outputPath = argv[++i];
+        } else if (strcmp(arg, "--chaos") == 0) {
+            out.chaosMode = true;
+        } else if (strcmp(arg, "--sweep") == 0 && hasValue) {
+            BalanceSweep sweep;
+            if (!parseSweep(argv[++i], sweep)) {
+                printf("Batch: invalid sweep '%s' (expected name=v1,v2,...; names: glove-cooldown-10/14/18, "
+                       "glove-damage-10/14/18, projectile-damage, special-cooldown, input-buffer)\n", argv[i]);
+                return false;
+            }
+            out.sweeps.push_back(sweep);
+        }
+    }
+
+    if (out.matchesPerCell < 1) out.matchesPerCell = 1;
+    if (out.threads < 0) out.threads = 0;
+    if (out.maxTicksPerMatch < 1) out.maxTicksPerMatch = 1;
+    return true;
+}
+
+bool runBalanceBatch(const BatchConfig& config) {
+    // --- 展開所有參數組合 (沒有 --sweep 時只有預設值這一組) ---
+    std::vector<BalanceParams> paramSets(1);
+    std::vector<std::vector<float>> paramValues(1);
+    for (const BalanceSweep& sweep : config.sweeps) {
+        std::vector<BalanceParams> expandedSets;
+        std::vector<std::vector<float>> expandedValues;
+        for (size_t s = 0; s < paramSets.size(); ++s) {
+            for (float value : sweep.values) {
+                BalanceParams params = paramSets[s];
+                setBalanceParam(params, sweep.name, value);
+                expandedSets.push_back(params);
+                expandedValues.push_back(paramValues[s]);
+                expandedValues.back().push_back(value);
+            }
+        }
+        paramSets.swap(expandedSets);
+        paramValues.swap(expandedValues);
+    }
+
+    // --- 切成工作單位 ---
+    std::vector<BatchJob> jobs;
+    for (int s = 0; s < static_cast<int>(paramSets.size()); ++s) {
+        for (int p1 = 0; p1 < LOADOUT_COUNT; ++p1) {
+            for (int p2 = 0; p2 < LOADOUT_COUNT; ++p2) {
+                for (int first = 0; first < config.matchesPerCell; first += MATCHES_PER_JOB) {
+                    int count = config.matchesPerCell - first;
+                    if (count > MATCHES_PER_JOB) count = MATCHES_PER_JOB;
+                    jobs.push_back({s, p1, p2, first, count});
+                }
+            }
+        }
+    }
+
+    int threadCount = config.threads;
+    if (threadCount == 0) threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    if (threadCount < 1) threadCount = 1;
+    size_t totalMatches = paramSets.size() * LOADOUT_COUNT * LOADOUT_COUNT * config.matchesPerCell;
+    printf("Batch: %zu parameter sets x %d x %d loadouts x %d matches = %zu matches on %d threads\n",
+           paramSets.size(), LOADOUT_COUNT, LOADOUT_COUNT, config.matchesPerCell, totalMatches, threadCount);
+
+    // --- 平行執行 ---
+    logVerbose = false; // 工作執行緒開始前設定，之後只讀
+    std::vector<CellResult> jobResults(jobs.size());
+    std::atomic<size_t> nextJob(0);
+    Uint64 start = SDL_GetPerformanceCounter();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back(runWorker, std::cref(config), std::cref(paramSets), std::cref(jobs),
+                             std::ref(jobResults), std::ref(nextJob));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = static_cast<double>(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+    // --- 彙整成 [參數組][P1][P2] ---
+    std::vector<CellResult> cells(paramSets.size() * LOADOUT_COUNT * LOADOUT_COUNT);
+    Uint64 totalTicks = 0;
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        const BatchJob& job = jobs[j];
+        CellResult& cell = cells[(job.paramSet * LOADOUT_COUNT + job.p1Loadout) * LOADOUT_COUNT + job.p2Loadout];
+        cell.wins[0] += jobResults[j].wins[0];
+        cell.wins[1] += jobResults[j].wins[1];
+        cell.unfinished += jobResults[j].unfinished;
+        cell.ticks += jobResults[j].ticks;
+        totalTicks += jobResults[j].ticks;
+    }
+
+    // --- 主控台：每組參數印一張 P1 勝率矩陣，最後一欄是該組合 (兩邊合計) 的勝率 ---
+    for (size_t s = 0; s < paramSets.size(); ++s) {
+        printf("\nBatch: set %zu/%zu", s + 1, paramSets.size());
+        for (size_t k = 0; k < config.sweeps.size(); ++k) {
+            printf(" %s=%g", config.sweeps[k].name.c_str(), paramValues[s][k]);
+        }
+        printf("\n%-14s", "P1 \\ P2");
+        for (int p2 = 0; p2 < LOADOUT_COUNT; ++p2) printf(" %13s", loadoutName(p2).c_str());
+        printf(" %8s\n", "overall");
+        for (int p1 = 0; p1 < LOADOUT_COUNT; ++p1) {
+            printf("%-14s", loadoutName(p1).c_str());
+            int won = 0, decided = 0;
+            for (int p2 = 0; p2 < LOADOUT_COUNT; ++p2) {
+                const CellResult& cell = cells[(s * LOADOUT_COUNT + p1) * LOADOUT_COUNT + p2];
+                int cellDecided = cell.wins[0] + cell.wins[1];
+                if (cellDecided > 0) {
+                    printf(" %12.1f%%", 100.0 * cell.wins[0] / cellDecided);
+                } else {
+                    printf(" %13s", "-");
+                }
+                // 這個組合當 P2 的那一格
+                const CellResult& mirror = cells[(s * LOADOUT_COUNT + p2) * LOADOUT_COUNT + p1];
+                won += cell.wins[0] + mirror.wins[1];
+                decided += cellDecided + mirror.wins[0] + mirror.wins[1];
+            }
+            printf(" %7.1f%%\n", decided > 0 ? 100.0 * won / decided : 0.0);
+        }
+    }
+    printf("\nBatch: %zu matches, %llu ticks in %.2f s, %.0f ticks/sec (%.0f per thread)\n",
+           totalMatches, static_cast<unsigned long long>(totalTicks), seconds,
+           seconds > 0.0 ? totalTicks / seconds : 0.0,
+           seconds > 0.0 ? totalTicks / seconds / threadCount : 0.0);
+
+    // --- CSV：每一格一列 ---
+    FILE* out = fopen(config.outputPath.c_str(), "w");
+    if (!out) {
+        printf("Batch: failed to open %s for writing\n", config.outputPath.c_str());
+        return false;
+    }
+    fprintf(out, "set");
+    for (const BalanceSweep& sweep : config.sweeps) fprintf(out, ",%s", sweep.name.c_str());
+    fprintf(out, ",p1_character,p1_glove,p2_character,p2_glove,matches,p1_wins,p2_wins,unfinished,p1_win_rate,avg_match_seconds\n");
+    for (size_t s = 0; s < paramSets.size(); ++s) {
+        for (int p1 = 0; p1 < LOADOUT_COUNT; ++p1) {
+            for (int p2 = 0; p2 < LOADOUT_COUNT; ++p2) {
+                const CellResult& cell = cells[(s * LOADOUT_COUNT + p1) * LOADOUT_COUNT + p2];
+                int decided = cell.wins[0] + cell.wins[1];
+                fprintf(out, "%zu", s + 1);
+                for (float value : paramValues[s]) fprintf(out, ",%g", value);
+                fprintf(out, ",%s,%doz,%s,%doz,%d,%d,%d,%d,%.4f,%.2f\n",
+                        loadoutCharacter(p1).c_str(), 10 + 4 * loadoutGlove(p1),
+                        loadoutCharacter(p2).c_str(), 10 + 4 * loadoutGlove(p2),
+                        config.matchesPerCell, cell.wins[0], cell.wins[1], cell.unfinished,
+                        decided > 0 ? static_cast<double>(cell.wins[0]) / decided : 0.0,
+                        static_cast<double>(cell.ticks) / config.matchesPerCell / SIM_TICK_RATE);
+            }
+        }
+    }
+    fclose(out);
+    printf("Batch: win-rate matrix written to %s\n", config.outputPath.c_str());
+    return true;
+}
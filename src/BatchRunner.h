@@ -0,0 +1,35 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include "Constants.h"
+
+// --- 平衡性參數掃描的一個維度 (例如 --sweep glove-damage-18=10,12,14) ---
+struct BalanceSweep {
+    std::string name;
+    std::vector<float> values;
+};
+
+// --- 批次對戰設定 (由命令列參數填入) ---
+// 每組參數都跑完整的 角色 x 拳套 勝率矩陣 (P1 六種組合 x P2 六種組合)，
+// 比賽平均分給所有 CPU 核心，每個工作執行緒擁有獨立的 Game。
+struct BatchConfig {
+    bool enabled = false;
+    int matchesPerCell = 50;                           // 矩陣每一格跑幾場
+    int threads = 0;                                   // 0: 使用所有核心
+    Uint32 seed = 1;                                   // 每一格的第 n 場使用 seed + n (結果與執行緒數無關)
+    bool chaosMode = false;
+    Uint32 maxTicksPerMatch = SIM_TICK_RATE * 60 * 10; // 超過算未完成
+    std::string outputPath = "balance.csv";
+    std::vector<BalanceSweep> sweeps;                  // 多個維度時跑所有組合
+};
+
+// 解析命令列參數 (--batch 等)，回傳 false 表示參數錯誤
+bool parseBatchArgs(int argc, char* argv[], BatchConfig& out);
+
+// 跑完所有參數組合並寫出勝率矩陣，回傳 false 表示無法寫出結果
+bool runBalanceBatch(const BatchConfig& config);
+
+#endif // BATCHRUNNER_H
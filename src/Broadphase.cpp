@@ -0,0 +1,126 @@
+#include "Broadphase.h"
+#include <algorithm>
+
+namespace {
+
+const int BROADPHASE_CELL_COUNT = (SCREEN_WIDTH + BROADPHASE_CELL_WIDTH - 1) / BROADPHASE_CELL_WIDTH;
+
+// 哪些種類需要配對，並決定誰是主動的一方 (回傳 1: a 主動, -1: b 主動, 0: 不配對)
+int pairOrder(Uint8 a, Uint8 b) {
+    if (a == BROADPHASE_ATTACK && b == BROADPHASE_HURTBOX) return 1;
+    if (a == BROADPHASE_HURTBOX && b == BROADPHASE_ATTACK) return -1;
+    if (a == BROADPHASE_PROJECTILE && b == BROADPHASE_BODY) return 1;
+    if (a == BROADPHASE_BODY && b == BROADPHASE_PROJECTILE) return -1;
+    if (a == BROADPHASE_BODY && b == BROADPHASE_BODY) return 1;
+    return 0;
+}
+
+// 單一軸的 slab 測試：a 相對 b 位移 d 時，兩段區間重疊的時間範圍 [enter, exit)
+bool sweepAxis(float aMin, float aMax, float bMin, float bMax, float d, float& enter, float& exit) {
+    if (d == 0.0f) {
+        if (!(aMin < bMax && aMax > bMin)) return false;
+        enter = 0.0f;
+        exit = 1.0f;
+        return true;
+    }
+    float t0 = (bMin - aMax) / d;
+    float t1 = (bMax - aMin) / d;
+    enter = d > 0.0f ? t0 : t1;
+    exit = d > 0.0f ? t1 : t0;
+    return true;
+}
+
+// 物件在本 tick 掃過的 x 範圍
+float sweptLeft(const BroadphaseProxy& proxy) {
+    return std::min(proxy.left, proxy.left - proxy.dx);
+}
+
+float sweptRight(const BroadphaseProxy& proxy) {
+    return std::max(proxy.right, proxy.right - proxy.dx);
+}
+
+} // namespace
+
+bool sweepProxies(const BroadphaseProxy& a, const BroadphaseProxy& b, float& toi) {
+    // 換到 b 的參考系：a 從 tick 開始的位置以相對位移移動
+    float dx = a.dx - b.dx;
+    float dy = a.dy - b.dy;
+    float enterX, exitX, enterY, exitY;
+    if (!sweepAxis(a.left - a.dx, a.right - a.dx, b.left - b.dx, b.right - b.dx, dx, enterX, exitX)) return false;
+    if (!sweepAxis(a.top - a.dy, a.bottom - a.dy, b.top - b.dy, b.bottom - b.dy, dy, enterY, exitY)) return false;
+    float enter = std::max(enterX, enterY);
+    float exit = std::min(exitX, exitY);
+    if (enter >= exit || enter > 1.0f || exit <= 0.0f) return false;
+    toi = std::max(enter, 0.0f);
+    return true;
+}
+
+BroadphaseGrid::BroadphaseGrid(int proxyCapacity) : capacity(proxyCapacity) {
+    proxies.reserve(capacity);
+    cellStart.assign(BROADPHASE_CELL_COUNT + 1, 0);
+    cellEntries.reserve(capacity * 2);
+}
+
+void BroadphaseGrid::clear() {
+    proxies.clear();
+}
+
+int BroadphaseGrid::insert(const BroadphaseProxy& proxy) {
+    if (size() >= capacity) return -1;
+    proxies.push_back(proxy);
+    return size() - 1;
+}
+
+// 畫面外的物件 (例如剛從兩側射進來的氣功) 歸到最邊邊的欄
+int BroadphaseGrid::cellOf(float x) const {
+    int cell = static_cast<int>(x) / BROADPHASE_CELL_WIDTH;
+    if (x < 0.0f) cell = 0;
+    return std::min(cell, BROADPHASE_CELL_COUNT - 1);
+}
+
+void BroadphaseGrid::findPairs(std::vector<BroadphasePair>& out) {
+    out.clear();
+
+    // 計數排序：先數每一欄有幾個物件，再依前綴和把 proxy 索引放進各欄
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    for (const BroadphaseProxy& proxy : proxies) {
+        for (int c = cellOf(sweptLeft(proxy)); c <= cellOf(sweptRight(proxy)); ++c) ++cellStart[c + 1];
+    }
+    for (int c = 0; c < BROADPHASE_CELL_COUNT; ++c) cellStart[c + 1] += cellStart[c];
+    cellEntries.resize(cellStart[BROADPHASE_CELL_COUNT]);
+    for (int i = 0; i < size(); ++i) {
+        for (int c = cellOf(sweptLeft(proxies[i])); c <= cellOf(sweptRight(proxies[i])); ++c) {
+            cellEntries[cellStart[c]++] = i;
+        }
+    }
+    // 放完之後 cellStart[c] 指向下一欄的起點，往後挪一格還原
+    for (int c = BROADPHASE_CELL_COUNT; c > 0; --c) cellStart[c] = cellStart[c - 1];
+    cellStart[0] = 0;
+
+    // 氣功之間不會配對，所以每一欄只要拿玩家的物件去跟欄內其他物件比，成本是 玩家物件數 x 欄內物件數
+    for (int c = 0; c < BROADPHASE_CELL_COUNT; ++c) {
+        for (int ea = cellStart[c]; ea < cellStart[c + 1]; ++ea) {
+            const int a = cellEntries[ea];
+            const BroadphaseProxy& pa = proxies[a];
+            if (pa.kind == BROADPHASE_PROJECTILE) continue;
+            for (int eb = cellStart[c]; eb < cellStart[c + 1]; ++eb) {
+                const int b = cellEntries[eb];
+                const BroadphaseProxy& pb = proxies[b];
+                if (pb.kind != BROADPHASE_PROJECTILE && b <= a) continue; // 兩個玩家物件的配對只從索引小的一方找
+                if (pa.owner >= 0 && pa.owner == pb.owner) continue;
+                int order = pairOrder(pa.kind, pb.kind);
+                if (order == 0) continue;
+                // 兩個物件跨了好幾欄時，只在它們共同的第一欄回報
+                if (c != std::max(cellOf(sweptLeft(pa)), cellOf(sweptLeft(pb)))) continue;
+                BroadphasePair pair;
+                pair.first = order > 0 ? a : b;
+                pair.second = order > 0 ? b : a;
+                out.push_back(pair);
+            }
+        }
+    }
+
+    std::sort(out.begin(), out.end(), [](const BroadphasePair& x, const BroadphasePair& y) {
+        return x.first != y.first ? x.first < y.first : x.second < y.second;
+    });
+}
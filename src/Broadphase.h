@@ -0,0 +1,66 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "Constants.h"
+
+// --- 碰撞粗篩 (broadphase) ---
+// 把畫面沿 x 軸切成固定寬度的欄 (格鬥遊戲的物件幾乎都在同一條水平帶上)，每個 tick 把玩家身體、
+// 受擊框、攻擊框與氣功放進去，只有落在同一欄、而且種類會互相作用的兩個物件才會成為候選配對，
+// 精確判定 (narrowphase) 交給 Game。成本隨實際重疊的數量增加，而不是物件數量的平方。
+// 每個物件也記錄本 tick 的位移，格子以整段掃掠範圍放置，精確判定用 sweepProxies 求出碰撞時間，
+// 所以高速物件 (衝刺、氣功) 在 tick 比較長時也不會穿過薄的判定框。
+
+enum BroadphaseKind : Uint8 {
+    BROADPHASE_BODY = 0,       // 玩家的邏輯身體 (推擠、被氣功打到)
+    BROADPHASE_HURTBOX = 1,    // 玩家的受擊框 (getBoundingBox，被拳打到)
+    BROADPHASE_ATTACK = 2,     // 玩家的攻擊框 (getHitboxWorld)
+    BROADPHASE_PROJECTILE = 3  // 氣功
+};
+
+struct BroadphaseProxy {
+    float left = 0.0f, top = 0.0f, right = 0.0f, bottom = 0.0f; // tick 結束時的位置
+    float dx = 0.0f, dy = 0.0f; // 本 tick 的位移 (tick 開始時的位置 = 結束位置 - 位移)
+    Uint8 kind = BROADPHASE_BODY;
+    Sint32 owner = -1; // 玩家索引 (氣功為發射者，-1 表示不屬於任何玩家)；同一個 owner 的物件不會配對
+    Sint32 index = -1; // 玩家或氣功池中的索引
+};
+
+// 候選配對：first 是主動的一方 (攻擊框/氣功/索引較小的身體)，second 是被測試的一方
+struct BroadphasePair {
+    int first = 0;
+    int second = 0;
+    float toi = 0.0f; // 碰撞時間 (0: tick 開始, 1: tick 結束)，由 sweepProxies 填入
+};
+
+// 掃掠 AABB：兩個物件在 tick 內各自等速移動，重疊 (不含邊緣相接) 時回傳 true 並寫入最早的碰撞時間。
+// tick 結束時重疊的配對一定會命中，所以結果包含只比對結束位置的判定。
+bool sweepProxies(const BroadphaseProxy& a, const BroadphaseProxy& b, float& toi);
+
+// 預設容量：整個氣功池，再加上保留給玩家物件 (身體、受擊框、攻擊框) 的空間
+const int BROADPHASE_PLAYER_HEADROOM = 64;
+
+class BroadphaseGrid {
+public:
+    explicit BroadphaseGrid(int proxyCapacity = MAX_PROJECTILES + BROADPHASE_PLAYER_HEADROOM);
+
+    void clear();
+    // 加入一個物件，回傳 proxy 索引；超過容量時回傳 -1
+    int insert(const BroadphaseProxy& proxy);
+    const BroadphaseProxy& getProxy(int index) const { return proxies[index]; }
+    int size() const { return static_cast<int>(proxies.size()); }
+
+    // 找出所有候選配對 (每對只回報一次)，依 (first, second) 的 proxy 索引排序，結果與插入順序一致
+    void findPairs(std::vector<BroadphasePair>& out);
+
+private:
+    int cellOf(float x) const;
+
+    std::vector<BroadphaseProxy> proxies;
+    std::vector<int> cellStart;   // 每一欄在 cellEntries 中的起點 (前綴和，長度為欄數 + 1)
+    std::vector<int> cellEntries; // 依欄排好的 proxy 索引 (跨欄的物件會出現多次)
+    int capacity;
+};
+
+#endif // BROADPHASE_H
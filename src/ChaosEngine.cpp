@@ -0,0 +1,241 @@
+#include "ChaosEngine.h"
+#include "Game.h"
+#include "SimClock.h"
+#include "Log.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// --- 內建事件 ---
+void applyReverse(Game&, ChaosModifiers& m) { ++m.reverseControls; }
+void revertReverse(Game&, ChaosModifiers& m) { --m.reverseControls; }
+void applyGravity(Game&, ChaosModifiers& m) { ++m.gravityShift; }
+void revertGravity(Game&, ChaosModifiers& m) { --m.gravityShift; }
+void applySpeedUp(Game&, ChaosModifiers& m) { ++m.speedUp; }
+void revertSpeedUp(Game&, ChaosModifiers& m) { --m.speedUp; }
+void applyStorm(Game&, ChaosModifiers& m) { ++m.projectileStorm; }
+void revertStorm(Game&, ChaosModifiers& m) { --m.projectileStorm; }
+
+// 血條交換：還站著的人依序輪轉血量百分比 (兩人時就是互換)
+void applyHpSwap(Game& game, ChaosModifiers&) {
+    int standing[MAX_PLAYERS];
+    float percent[MAX_PLAYERS];
+    int standingCount = 0;
+    for (size_t i = 0; i < game.players.size() && i < MAX_PLAYERS; ++i) {
+        if (!game.players[i].isAlive()) continue;
+        percent[standingCount] = game.players[i].health / PLAYER_DEFAULT_HEALTH;
+        standing[standingCount++] = static_cast<int>(i);
+    }
+    for (int k = 0; k < standingCount && standingCount >= 2; ++k) {
+        game.players[standing[k]].health = (int)(percent[(k + 1) % standingCount] * PLAYER_DEFAULT_HEALTH);
+    }
+}
+
+std::vector<ChaosEventDef>& registry() {
+    static std::vector<ChaosEventDef> events = {
+        {ChaosEventType::CONTROL_REVERSE, "control-reverse", "超級控制大混亂! (鍵位全部顛倒)", 3,
+         CHAOS_REVERSE_DURATION, ChaosStacking::REFRESH, 1, applyReverse, revertReverse},
+        {ChaosEventType::HP_SWAP, "hp-swap", "血條交換! (血量百分比互換)", 2,
+         0.0f, ChaosStacking::REFRESH, 1, applyHpSwap, nullptr},
+        {ChaosEventType::PROJECTILE_FLOOD, "projectile-storm", "氣功洪水! (躺下或格擋閃避)", 2,
+         CHAOS_FLOOD_DURATION, ChaosStacking::EXTEND, 1, applyStorm, revertStorm},
+        {ChaosEventType::GRAVITY_SHIFT, "gravity-shift", "重力異常! (跳得更高、落得更慢)", 2,
+         CHAOS_GRAVITY_DURATION, ChaosStacking::REFRESH, 1, applyGravity, revertGravity},
+        {ChaosEventType::SPEED_UP, "speed-up", "加速! (移動速度提升，可以疊加)", 2,
+         CHAOS_SPEED_UP_DURATION, ChaosStacking::STACK, CHAOS_SPEED_UP_MAX_STACKS, applySpeedUp, revertSpeedUp},
+    };
+    return events;
+}
+
+} // namespace
+
+void ChaosEngine::registerEvent(const ChaosEventDef& def) {
+    // 同一種事件重複註冊時以新的為準 (比賽進行中不要呼叫)
+    std::vector<ChaosEventDef>& events = registry();
+    for (ChaosEventDef& existing : events) {
+        if (existing.type == def.type) {
+            existing = def;
+            return;
+        }
+    }
+    events.push_back(def);
+}
+
+const ChaosEventDef* ChaosEngine::findEvent(ChaosEventType type) {
+    for (const ChaosEventDef& def : registry()) {
+        if (def.type == type) return &def;
+    }
+    return nullptr;
+}
+
+void ChaosEngine::seed(Uint32 seed) {
+    state.rngState = seed | 1u; // xorshift 的狀態不能是 0
+}
+
+// xorshift32：狀態存在快照裡，重播時會得到相同的事件
+Uint32 ChaosEngine::nextRandom() {
+    Uint32 x = state.rngState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state.rngState = x;
+    return x;
+}
+
+void ChaosEngine::clear() {
+    Uint32 rngState = state.rngState;
+    Sint32 bgIndex = state.bgIndex;
+    state = ChaosState();
+    state.rngState = rngState;
+    state.bgIndex = bgIndex;
+    wheel.reset(0);
+    for (int& timer : effectTimers) timer = -1;
+    nextEventTimer = -1;
+}
+
+void ChaosEngine::startRound(Game& game, Uint32 now) {
+    // 上一回合還沒結束的效果先還原
+    for (int slot = 0; slot < MAX_CHAOS_EFFECTS; ++slot) {
+        const ChaosEventDef* def = findEvent(static_cast<ChaosEventType>(state.effectType[slot]));
+        if (state.effectType[slot] != 0 && def && def->revert) def->revert(game, state.modifiers);
+    }
+    clear();
+    state.wheelTick = now;
+    wheel.reset(now);
+    scheduleNextEvent(now + secondsToTicks(CHAOS_FIRST_EVENT_DELAY));
+}
+
+void ChaosEngine::update(Game& game, Uint32 now) {
+    int fired[TIMER_WHEEL_CAPACITY];
+    while (state.wheelTick < now) {
+        int firedCount = wheel.advance(fired);
+        Uint32 tick = wheel.currentTick();
+        state.wheelTick = tick;
+        // 同一個 tick 到期的效果依欄位順序還原，最後才觸發下一個事件 (payload 為 MAX_CHAOS_EFFECTS)
+        std::sort(fired, fired + firedCount);
+        for (int i = 0; i < firedCount; ++i) {
+            int slot = fired[i];
+            if (slot == MAX_CHAOS_EFFECTS) {
+                nextEventTimer = -1;
+                state.nextEventTick = 0;
+                const ChaosEventDef* def = rollEvent();
+                if (def) trigger(game, def->type, tick);
+                scheduleNextEvent(tick + secondsToTicks(CHAOS_EVENT_INTERVAL));
+                continue;
+            }
+            effectTimers[slot] = -1;
+            const ChaosEventDef* def = findEvent(static_cast<ChaosEventType>(state.effectType[slot]));
+            if (def && def->revert) def->revert(game, state.modifiers);
+            DEBUG_LOG("Chaos effect %s ended at tick %u\n", def ? def->name : "?", tick);
+            state.effectType[slot] = 0;
+            state.effectExpires[slot] = 0;
+        }
+    }
+}
+
+void ChaosEngine::trigger(Game& game, ChaosEventType type, Uint32 now) {
+    const ChaosEventDef* def = findEvent(type);
+    if (!def) return;
+
+    if (def->duration > 0.0f) {
+        Uint32 ticks = secondsToTicks(def->duration);
+        int first = -1;
+        int active = countActive(type, &first);
+        if (active > 0 && def->stacking == ChaosStacking::REFRESH) {
+            state.effectExpires[first] = now + ticks;
+            scheduleEffect(first);
+        } else if (active > 0 && def->stacking == ChaosStacking::EXTEND) {
+            state.effectExpires[first] += ticks;
+            scheduleEffect(first);
+        } else if (active > 0 && (def->stacking == ChaosStacking::EXCLUSIVE || active >= def->maxStacks)) {
+            return;
+        } else {
+            int slot = 0;
+            while (slot < MAX_CHAOS_EFFECTS && state.effectType[slot] != 0) ++slot;
+            if (slot == MAX_CHAOS_EFFECTS) {
+                DEBUG_LOG("Chaos effect slots full (%d), %s skipped\n", MAX_CHAOS_EFFECTS, def->name);
+                return;
+            }
+            state.effectType[slot] = static_cast<Uint8>(type);
+            state.effectExpires[slot] = now + ticks;
+            scheduleEffect(slot);
+            def->apply(game, state.modifiers);
+        }
+    } else {
+        def->apply(game, state.modifiers);
+    }
+
+    state.lastEvent = static_cast<Uint8>(type);
+    state.bannerUntil = now + secondsToTicks(CHAOS_BANNER_DURATION);
+    state.bgIndex = 1 - state.bgIndex; // 交替背景
+    GameEvent event = makeGameEvent(GameEventType::CHAOS_EVENT, now, -1);
+    event.value = static_cast<Sint16>(type);
+    game.gameEvents.push(event);
+}
+
+void ChaosEngine::restore(const ChaosState& saved) {
+    state = saved;
+    wheel.reset(state.wheelTick);
+    for (int slot = 0; slot < MAX_CHAOS_EFFECTS; ++slot) {
+        effectTimers[slot] = -1;
+        if (state.effectType[slot] != 0) scheduleEffect(slot);
+    }
+    nextEventTimer = -1;
+    if (state.nextEventTick != 0) scheduleNextEvent(state.nextEventTick);
+}
+
+const char* ChaosEngine::bannerText(Uint32 now) const {
+    if (state.lastEvent == 0 || now >= state.bannerUntil) return nullptr;
+    const ChaosEventDef* def = findEvent(static_cast<ChaosEventType>(state.lastEvent));
+    return def ? def->message : nullptr;
+}
+
+float ChaosEngine::nextEventRatio(Uint32 now) const {
+    if (state.nextEventTick <= now) return 0.0f;
+    return std::min(1.0f, static_cast<float>(state.nextEventTick - now) / secondsToTicks(CHAOS_EVENT_INTERVAL));
+}
+
+void ChaosEngine::scheduleEffect(int slot) {
+    wheel.cancel(effectTimers[slot]);
+    effectTimers[slot] = wheel.schedule(state.effectExpires[slot], slot);
+}
+
+void ChaosEngine::scheduleNextEvent(Uint32 tick) {
+    wheel.cancel(nextEventTimer);
+    state.nextEventTick = tick;
+    nextEventTimer = wheel.schedule(tick, MAX_CHAOS_EFFECTS);
+}
+
+const ChaosEventDef* ChaosEngine::rollEvent() {
+    // 生效中不能再疊的事件不參加抽選
+    const std::vector<ChaosEventDef>& events = registry();
+    int total = 0;
+    for (const ChaosEventDef& def : events) {
+        int active = def.duration > 0.0f ? countActive(def.type, nullptr) : 0;
+        bool blocked = active > 0 && (def.stacking == ChaosStacking::EXCLUSIVE ||
+                                      (def.stacking == ChaosStacking::STACK && active >= def.maxStacks));
+        if (!blocked) total += def.weight;
+    }
+    if (total <= 0) return nullptr;
+    int pick = static_cast<int>(nextRandom() % static_cast<Uint32>(total));
+    for (const ChaosEventDef& def : events) {
+        int active = def.duration > 0.0f ? countActive(def.type, nullptr) : 0;
+        bool blocked = active > 0 && (def.stacking == ChaosStacking::EXCLUSIVE ||
+                                      (def.stacking == ChaosStacking::STACK && active >= def.maxStacks));
+        if (blocked) continue;
+        if (pick < def.weight) return &def;
+        pick -= def.weight;
+    }
+    return nullptr;
+}
+
+int ChaosEngine::countActive(ChaosEventType type, int* firstSlot) const {
+    int active = 0;
+    for (int slot = 0; slot < MAX_CHAOS_EFFECTS; ++slot) {
+        if (state.effectType[slot] != static_cast<Uint8>(type)) continue;
+        if (active == 0 && firstSlot) *firstSlot = slot;
+        ++active;
+    }
+    return active;
+}
@@ -0,0 +1,102 @@
+#ifndef CHAOS_ENGINE_H
+#define CHAOS_ENGINE_H
+
+#include <SDL2/SDL.h>
+#include "Constants.h"
+#include "TimerWheel.h"
+
+class Game;
+
+// --- 混亂模式事件型別 ---
+enum class ChaosEventType : Uint8 {
+    NONE,
+    CONTROL_REVERSE,  // 超級控制大混亂：按鍵顛倒
+    HP_SWAP,          // 血條交換 (瞬間)
+    PROJECTILE_FLOOD, // 氣功洪水：兩側湧出氣功
+    GRAVITY_SHIFT,    // 重力異常：重力變小
+    SPEED_UP          // 加速：移動速度提升 (可以疊加)
+};
+
+// --- 目前生效的規則調整 (模擬讀取的唯一介面) ---
+// 每種效果記錄目前疊了幾層，由事件的 apply/revert 加減，跟生效與結束的順序無關。
+struct ChaosModifiers {
+    Uint8 reverseControls = 0;
+    Uint8 gravityShift = 0;
+    Uint8 speedUp = 0;
+    Uint8 projectileStorm = 0;
+
+    float gravityScale() const { return gravityShift > 0 ? CHAOS_LOW_GRAVITY_SCALE : 1.0f; }
+    float speedScale() const { return 1.0f + CHAOS_SPEED_UP_STEP * speedUp; }
+};
+
+// 同一種效果已經生效時再次觸發的處理方式
+enum class ChaosStacking : Uint8 {
+    REFRESH,   // 重新計時
+    EXTEND,    // 延長一次持續時間
+    STACK,     // 再疊一層 (各自計時，最多 maxStacks 層，滿了就不會被抽中)
+    EXCLUSIVE  // 生效期間不會被抽中
+};
+
+// --- 事件定義 (外掛) ---
+// 內建事件在第一次使用時註冊；新增事件只要呼叫 ChaosEngine::registerEvent，不用修改 Game。
+struct ChaosEventDef {
+    ChaosEventType type;
+    const char* name;      // 記錄/除錯用
+    const char* message;   // 畫面提示
+    int weight;            // 被抽中的權重 (0 表示不會出現)
+    float duration;        // 持續秒數 (0 表示瞬間事件，只呼叫 apply)
+    ChaosStacking stacking;
+    int maxStacks;         // STACK 最多幾層
+    void (*apply)(Game& game, ChaosModifiers& modifiers);
+    void (*revert)(Game& game, ChaosModifiers& modifiers); // 瞬間事件為 nullptr
+};
+
+// --- 混亂模式的模擬狀態 (整份存進快照，時間輪由這裡重建) ---
+struct ChaosState {
+    Uint32 rngState = 1;              // xorshift32 (不能是 0)
+    Uint32 wheelTick = 0;             // 時間輪已經處理到的 tick
+    Uint32 nextEventTick = 0;         // 下一個事件觸發的 tick (0 表示沒有排程)
+    Uint32 bannerUntil = 0;           // 事件名稱顯示到哪個 tick
+    Uint8 lastEvent = 0;              // 最近一次觸發的 ChaosEventType
+    Sint32 bgIndex = 0;               // 背景交替 (0: image0.png, 1: image.png)
+    ChaosModifiers modifiers;
+    Uint8 effectType[MAX_CHAOS_EFFECTS] = {};    // 生效中的效果 (ChaosEventType，NONE 表示空位)
+    Uint32 effectExpires[MAX_CHAOS_EFFECTS] = {}; // 效果結束的 tick
+};
+
+// --- 混亂模式引擎 ---
+// 事件依權重以種子亂數抽選，持續型效果的結束與下一個事件都排進時間輪 (常數時間)，
+// 同一個 tick 到期的效果依欄位順序還原、最後才觸發新事件，所以重播與回滾還原後結果一致。
+class ChaosEngine {
+public:
+    ChaosEngine() { clear(); }
+
+    ChaosState state;
+
+    void seed(Uint32 seed);
+    void clear();                             // 清除所有效果、停止排程 (不呼叫 revert，亂數狀態保留)
+    void startRound(Game& game, Uint32 now);  // 還原上一回合的效果，排程第一個事件
+    void update(Game& game, Uint32 now);      // 處理到 now 為止到期的效果與事件
+    void trigger(Game& game, ChaosEventType type, Uint32 now); // 立即觸發一個事件
+    void restore(const ChaosState& saved);    // 還原快照並重建時間輪
+    Uint32 nextRandom();
+
+    const ChaosModifiers& modifiers() const { return state.modifiers; }
+    const char* bannerText(Uint32 now) const; // 事件提示 (沒有時為 nullptr)
+    float nextEventRatio(Uint32 now) const;   // 距離下一個事件的剩餘比例 (冷卻條用)
+
+    static void registerEvent(const ChaosEventDef& def);
+    static const ChaosEventDef* findEvent(ChaosEventType type);
+
+private:
+    TimerWheel wheel;
+    int effectTimers[MAX_CHAOS_EFFECTS];
+    int nextEventTimer = -1;
+
+    void scheduleEffect(int slot);
+    void scheduleNextEvent(Uint32 tick);
+    const ChaosEventDef* rollEvent();
+    int countActive(ChaosEventType type, int* firstSlot) const;
+};
+
+#endif // CHAOS_ENGINE_H
@@ -0,0 +1,9 @@
+#include "CharacterTraits.h"
+#include <SDL2/SDL.h>
+
+int findCharacterIndex(const std::string& id) {
+    for (int i = 0; i < CHARACTER_COUNT; ++i) {
+        if (SDL_strcasecmp(id.c_str(), CHARACTER_TRAITS[i].id) == 0) return i;
+    }
+    return -1;
+}
@@ -0,0 +1,52 @@
+#ifndef CHARACTER_TRAITS_H
+#define CHARACTER_TRAITS_H
+
+#include <string>
+#include "Constants.h"
+
+// --- 角色特性表 ---
+// 每個角色的尺寸、特殊技能、紋理與音效，以角色索引查表 (與角色選擇畫面相同：0 統神, 1 國動)。
+// Player 建立時查一次，之後模擬過程不再比對角色名稱字串。
+// 新增角色：在 CHARACTER_TRAITS 加一列，並載入它的動畫、紋理與音效。
+
+enum class SpecialAttackType {
+    KNOCKDOWN, // 原地發動，把對手擊倒在地
+    DASH       // 向前衝刺，撞到對手造成傷害
+};
+
+struct CharacterTraits {
+    const char* id;                 // 角色 ID (動畫資料、對戰記錄、命令列參數)
+    const char* displayName;        // 顯示名稱
+    const char* textureId;          // 精靈圖紋理
+    const char* winScreenTextureId; // 勝利畫面紋理
+    int logicWidth;                 // 碰撞尺寸
+    int logicHeight;
+    SpecialAttackType specialAttack;
+    float knockdownDuration;        // KNOCKDOWN：對手躺在地上的時間 (秒)
+    float dashSpeed;                // DASH：衝刺速度 (像素/秒)
+    float dashDuration;             // DASH：衝刺的攻擊判定時間 (秒)
+    int dashDamage;                 // DASH：撞到對手的傷害
+    // 音效前綴 (AudioManager::playRandomSound)
+    const char* hurtSound;
+    const char* fireSound;
+    const char* deathSound;
+    const char* victorySound;
+};
+
+const int CHARACTER_COUNT = 2;
+
+constexpr CharacterTraits CHARACTER_TRAITS[CHARACTER_COUNT] = {
+    {"BlockMan", "統神", "blockman_sprites", "blockman_win_screen",
+     BLOCKMAN_LOGIC_WIDTH, BLOCKMAN_LOGIC_HEIGHT,
+     SpecialAttackType::KNOCKDOWN, 0.5f, 0.0f, 0.0f, 0,
+     "blockman_hurt", "blockman_fire", "blockman_death", "blockman_victory"},
+    {"Godon", "國動", "godon_sprites", "godon_win_screen",
+     GODON_LOGIC_WIDTH, GODON_LOGIC_HEIGHT,
+     SpecialAttackType::DASH, 0.0f, 700.0f, 1.0f, 20,
+     "godon_hurt", "godon_fire", "godon_death", "godon_victory"},
+};
+
+// 依角色 ID 查索引 (不分大小寫)，找不到回傳 -1
+int findCharacterIndex(const std::string& id);
+
+#endif // CHARACTER_TRAITS_H
@@ -20,6 +20,7 @@ const float ROUND_TIME_LIMIT = 99.0f; // 回合時間限制 (秒)
 const float ROUND_DURATION = ROUND_TIME_LIMIT; // 回合持續時間
 const int   ROUNDS_TO_WIN_MATCH = 2;     // 贏得比賽所需的回合勝利數
 const float ROUND_OVER_DELAY = 3.0f;       // 回合結束後顯示結果的延遲時間 (秒)
+const int   MAX_PLAYERS = 4;             // 同一場最多的玩家數 (大亂鬥：只剩一人存活時回合結束)
 
 // --- 時間相關 ---
 const float ATTACK_DURATION = 0.3f;
@@ -32,12 +33,41 @@ const float ATTACK_HITBOX_ACTIVE_END = 0.3f;   // Hitbox 在攻擊動畫中的
 const float BLOCK_COOLDOWN = 3.0f; // 格擋冷卻時間 (3秒)
 const float ATTACK_RATE_COOLDOWN = 1.0f; // 攻擊速率冷卻時間 (1秒)
 
+// --- 固定步長模擬 ---
+const int   SIM_TICK_RATE = 60;                         // 每秒模擬 tick 數
+const float FIXED_DELTA_TIME = 1.0f / SIM_TICK_RATE;    // 每個 tick 的時間 (秒)
+const int   MAX_SIM_STEPS_PER_FRAME = 5;                // 單一畫面最多追趕的 tick 數 (避免卡頓後連鎖變慢)
+
+// --- 重播 (Replay) ---
+const int REPLAY_KEYFRAME_INTERVAL = 120;               // 每隔多少 tick 存一個關鍵幀 (2 秒)
+const int REPLAY_FULL_KEYFRAME_EVERY = 16;              // 每隔多少個關鍵幀存一次完整快照 (其餘只存與前一關鍵幀的差分)
+const int REPLAY_SEEK_STEP_TICKS = SIM_TICK_RATE * 5;   // 重播中左右鍵每次跳轉 5 秒
+
+// --- 連線對戰 (Rollback Netcode) ---
+const int NET_MAX_INPUT_DELAY = 10;                     // 輸入延遲上限 (tick)
+const int NET_MAX_ROLLBACK_WINDOW = 30;                 // 預測/回滾視窗上限 (tick)
+const int NET_FRAME_ADVANTAGE_LIMIT = 2;                // 領先對手超過這麼多 tick 就暫停一個 tick 讓對手追上
+const int NET_THROTTLE_INTERVAL = 10;                   // 兩次暫停之間至少間隔的 tick 數
+
 // --- 氣功 (Projectile) 常數 ---
 const float PROJECTILE_SPEED = 600.0f;           // 氣功飛行速度 (像素/秒)
 const int   PROJECTILE_DAMAGE = 25;              // 氣功傷害值
 const float PROJECTILE_COOLDOWN = 5.0f;          // 氣功發射冷卻時間 (秒)
+const int   MAX_PROJECTILES = 1024;              // 場上同時存在的氣功上限 (氣功池容量，氣功洪水會用到數百個)
+const float CHAOS_FLOOD_DURATION = 2.0f;         // 混亂模式「氣功洪水」持續時間 (秒)
+const int   CHAOS_FLOOD_PER_TICK = 2;            // 氣功洪水期間每個 tick 從左右兩側各射出的數量
+const int   CHAOS_FLOOD_HEIGHT_RANGE = 250;      // 氣功洪水的高度範圍 (從地面往上，像素)
 const float SPECIAL_ATTACK_COOLDOWN = 10.0f;     // 特殊技能冷卻時間 (秒)
 
+// --- 拳套 (Glove) 常數 ---
+const float LIGHT_GLOVE_COOLDOWN = 0.8f;    // 10oz 拳套冷卻時間
+const float MEDIUM_GLOVE_COOLDOWN = 1.0f;   // 14oz 拳套冷卻時間
+const float HEAVY_GLOVE_COOLDOWN = 1.2f;    // 18oz 拳套冷卻時間
+
+const int LIGHT_GLOVE_DAMAGE = 8;           // 10oz 拳套傷害
+const int MEDIUM_GLOVE_DAMAGE = 10;         // 14oz 拳套傷害
+const int HEAVY_GLOVE_DAMAGE = 12;          // 18oz 拳套傷害
+
 // 精靈圖相關 (非常重要，請務必修改!)
 const int   PROJECTILE_SRC_X = 630;                // <--- 氣功在精靈圖上的 X 起始座標
 const int   PROJECTILE_SRC_Y = 1437;                // <--- 氣功在精靈圖上的 Y 起始座標
@@ -62,4 +92,43 @@ const int GODON_LOGIC_HEIGHT = 245; // 比 BlockMan 高 40 像素
 const int PLAYER_LOGIC_WIDTH = BLOCKMAN_LOGIC_WIDTH;
 const int PLAYER_LOGIC_HEIGHT = BLOCKMAN_LOGIC_HEIGHT;
 
+// --- 特效粒子 (只有外觀，不影響模擬) ---
+const int   MAX_EFFECTS = 256;              // 場上同時存在的粒子上限
+const int   HIT_SPARK_COUNT = 8;            // 每次命中噴出的火花數
+const float HIT_SPARK_LIFETIME = 0.35f;     // 火花持續時間 (秒)
+const float HIT_SPARK_SPEED = 260.0f;       // 火花的最大初速 (像素/秒)
+
+// --- 選單按鍵重複 (以畫面時鐘 SDL_GetTicks 計算，選單不屬於模擬) ---
+const int   MENU_REPEAT_DELAY_MS = 350;     // 按住方向鍵後，開始自動重複前的等待時間 (毫秒)
+const int   MENU_REPEAT_INTERVAL_MS = 120;  // 自動重複的間隔 (毫秒)
+
+// --- 輸入延遲量測 ---
+const int   LATENCY_WINDOW = 120;           // 畫面上的平均值取最近幾筆 (有輸入的 tick)
+
+// --- 輸入記錄 (緩衝輸入與搓招，以模擬 tick 計算) ---
+const int   INPUT_HISTORY_LENGTH = 16;      // 每位玩家保留最近幾次按鍵變化
+const int   INPUT_BUFFER_TICKS = 6;         // 攻擊/受傷中按下普攻，硬直在幾個 tick 內結束仍會出拳 (最多 INPUT_HISTORY_LENGTH - 2)
+const int   MOTION_STEP_TICKS = 8;          // 搓招每一步 (以及最後一步到按鍵) 之間最多間隔幾個 tick
+
+// --- 遊戲事件 (每個 tick 由模擬寫入，tick 結束後交給音效/特效/記錄等消費者) ---
+const int   MAX_GAME_EVENTS_PER_TICK = 64;  // 單一 tick 最多記錄的事件數 (超過的丟掉並計數，氣功洪水每個 tick 約 4 筆)
+
+// --- 混亂模式 (事件的持續時間以秒為單位，觸發時換算成 tick) ---
+const float CHAOS_FIRST_EVENT_DELAY = 10.0f;    // 每回合第一個事件的等待時間
+const float CHAOS_EVENT_INTERVAL = 15.0f;       // 之後每隔多久觸發一個事件
+const float CHAOS_BANNER_DURATION = 3.0f;       // 事件名稱顯示多久
+const int   MAX_CHAOS_EFFECTS = 8;              // 同時生效的持續型效果上限 (含同一種效果疊加的層數)
+const float CHAOS_REVERSE_DURATION = 8.0f;      // 「超級控制大混亂」持續時間
+const float CHAOS_GRAVITY_DURATION = 10.0f;     // 「重力異常」持續時間
+const float CHAOS_LOW_GRAVITY_SCALE = 0.45f;    // 重力異常期間的重力倍率
+const float CHAOS_SPEED_UP_DURATION = 8.0f;     // 「加速」每一層的持續時間
+const float CHAOS_SPEED_UP_STEP = 0.5f;         // 每一層加速增加的移動速度倍率
+const int   CHAOS_SPEED_UP_MAX_STACKS = 2;      // 加速最多疊幾層
+
+// --- 手把 ---
+const int   GAMEPAD_AXIS_THRESHOLD = 16000; // 搖桿推超過這個值 (最大 32767) 才算按下方向
+
+// --- 碰撞粗篩 (Broadphase) ---
+const int BROADPHASE_CELL_WIDTH = 64;       // 沿 x 軸切格子的寬度 (像素)
+
 #endif // CONSTANTS_H
\ No newline at end of file
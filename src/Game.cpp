@@ -3,6 +3,8 @@
 #include "TextureManager.h"
 #include "AnimationData.h"
 #include "AudioManager.h"
+#include "ScriptedAI.h"
+#include "Log.h"
 #include <stdio.h>
 #include <vector>
 #include <algorithm>
@@ -10,6 +12,7 @@
 #include <SDL2/SDL_ttf.h>
 #include <ctime>
 #include <fstream>
+#include <cstring>
 
 // 添加字體相關的全局變量
 TTF_Font* buttonFont = nullptr;
@@ -19,8 +22,6 @@ Game::Game() :
     window(nullptr), renderer(nullptr), isRunning(false), lastFrameTime(0),
     currentGameState(GameState::START_SCREEN),
     currentRound(1),
-    roundTimer(ROUND_DURATION),
-    roundOverTimer(0.0f),
     roundWinnerIndex(-1),
     selectedGloveIndex{0, 0},
     gloveSelectionConfirmed{false, false},
@@ -28,17 +29,12 @@ Game::Game() :
     characterSelectionConfirmed{false, false},
     isPaused(false),
     showRecords(false),
-    menuCooldownTimer(0.0f),  // 新增：選單冷卻計時器
-    isChaosMode(false),
-    chaosEvent(ChaosEventType::NONE),
-    chaosEventTimer(0.0f),
-    chaosEventShowTimer(0.0f),
-    chaosBgIndex(0)
+    menuCooldownUntil(0),  // 新增：選單冷卻結束時間
+    isChaosMode(false)
 {
     // 初始化玩家勝利回合數
-    playerWins[0] = 0;
-    playerWins[1] = 0;
-    printf("Game constructor: Initial state set to START_SCREEN\n");
+    for (int i = 0; i < MAX_PLAYERS; ++i) playerWins[i] = 0;
+    DEBUG_LOG("Game constructor: Initial state set to START_SCREEN\n");
 
     // 初始化暫停選單按鈕位置
     int buttonWidth = 200;
@@ -129,13 +125,19 @@ Game::~Game() {
 
 bool Game::initialize() {
     printf("Initializing Game...\n");
+    ownsSubsystems = true;
 
     // --- SDL 初始化 ---
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER) < 0) {
         printf("SDL Init Error: %s\n", SDL_GetError());
         return false;
     }
 
+    // 鍵位設定 (沒有設定檔時使用預設鍵位)
+    if (!inputMap.loadFromFile("controls.cfg")) {
+        printf("Controls: using default bindings\n");
+    }
+
     // 初始化 SDL_ttf
     if (TTF_Init() < 0) {
         printf("TTF Init Error: %s\n", TTF_GetError());
@@ -262,20 +264,38 @@ bool Game::initialize() {
 void Game::run() {
     printf("Starting Game Loop...\n");
     while (isRunning) {
+        // --- 延後取樣：畫面送出 (等到 vsync) 後先等一段時間再處理輸入，這段時間內的輸入就能趕上下一個畫面 ---
+        if (frameDelayMs > 0) {
+            SDL_Delay(frameDelayMs);
+        }
+
         // --- 計算 Delta Time ---
         Uint32 currentFrameTime = SDL_GetTicks();
         float deltaTime = (currentFrameTime - lastFrameTime) / 1000.0f;
         lastFrameTime = currentFrameTime;
-        if (deltaTime > 0.05f) deltaTime = 0.05f; // Delta time capping
+        if (deltaTime > 0.25f) deltaTime = 0.25f; // Delta time capping
+        tickAccumulator += deltaTime;
 
         // --- 處理事件 ---
         handleEvents();
 
-        // --- 更新狀態 ---
-        update(deltaTime);
+        // --- 更新狀態 (固定步長，確保重播可以完全重現) ---
+        int steps = 0;
+        while (tickAccumulator >= FIXED_DELTA_TIME && steps < MAX_SIM_STEPS_PER_FRAME) {
+            latchInput();
+            update(FIXED_DELTA_TIME);
+            // 按下瞬間的事件只作用於一個 tick
+            for (Uint16& buttons : currentInput.buttons) buttons &= ~INPUT_EDGE_MASK;
+            tickAccumulator -= FIXED_DELTA_TIME;
+            ++steps;
+        }
+        if (steps == MAX_SIM_STEPS_PER_FRAME) {
+            tickAccumulator = 0.0f; // 追不上就放棄剩下的時間
+        }
 
         // --- 繪製畫面 ---
         render();
+        inputLatency.onPresent();
     }
     printf("Exiting Game Loop.\n");
 }
@@ -287,6 +307,42 @@ void Game::handleEvents() {
             isRunning = false;
             return;
         }
+        // 選單的上下鍵交給 menuInput (所有狀態都轉交，放開按鍵的事件才不會漏掉)
+        menuInput.handleEvent(event, inputMap, SDL_GetTicks());
+        // 按下瞬間的事件 (發射氣功/技能) 與手把插拔；實際的動作在下一個模擬 tick 由 applyPlayerInputs 執行
+        if (inputMap.handleEvent(event, currentInput) && currentGameState == GameState::PLAYING) {
+            inputLatency.onInputEvent(event.common.timestamp); // 事件進入 SDL 佇列的時間
+        }
+
+        // F3 切換輸入延遲的顯示
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3 && !event.key.repeat) {
+            inputLatency.overlayEnabled = !inputLatency.overlayEnabled;
+            continue;
+        }
+
+        // 觀看重播時只處理重播的按鍵
+        if (isReplayPlayback) {
+            if (event.type == SDL_KEYDOWN) {
+                handleReplayKey(event.key.keysym.sym);
+            }
+            continue;
+        }
+
+        // 比賽結束畫面：按 R 觀看重播
+        if (currentGameState == GameState::MATCH_OVER && event.type == SDL_KEYDOWN &&
+            event.key.keysym.sym == SDLK_r && !event.key.repeat && !replay.isEmpty()) {
+            startReplayPlayback();
+            continue;
+        }
+
+        // 連線對戰中無法暫停，ESC 直接中斷連線回到主選單
+        if (netSession && event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE) {
+            stopNetplay();
+            continue;
+        }
+        if (netSession && !netSession->isConnected()) {
+            continue; // 握手中不處理選單操作
+        }
 
         // 處理 ESC 鍵按下事件
         if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE) {
@@ -330,8 +386,7 @@ void Game::handleEvents() {
                      mouseY >= restartButton.y && mouseY <= restartButton.y + restartButton.h) {
                 // 重新開始遊戲，回到角色選擇畫面
                 currentRound = 1;
-                playerWins[0] = 0;
-                playerWins[1] = 0;
+                for (int i = 0; i < MAX_PLAYERS; ++i) playerWins[i] = 0;
                 // 重置角色選擇狀態
                 selectedCharacterIndex[0] = 0;
                 selectedCharacterIndex[1] = 0;
@@ -344,13 +399,13 @@ void Game::handleEvents() {
                      mouseY >= exitButton.y && mouseY <= exitButton.y + exitButton.h) {
                 // 回到開始畫面
                 currentGameState = GameState::START_SCREEN;
-                menuCooldownTimer = MENU_COOLDOWN;  // 設置冷卻時間
+                menuCooldownUntil = SDL_GetTicks() + static_cast<Uint32>(MENU_COOLDOWN * 1000.0f);  // 設置冷卻時間
                 printf("Returned to start screen\n");
             }
         }
 
         // 處理開始畫面的按鈕點擊
-        if (currentGameState == GameState::START_SCREEN && menuCooldownTimer <= 0.0f && !showRecords) {  // 添加冷卻檢查，且未顯示記錄時才處理
+        if (currentGameState == GameState::START_SCREEN && SDL_TICKS_PASSED(SDL_GetTicks(), menuCooldownUntil) && !showRecords) {  // 添加冷卻檢查，且未顯示記錄時才處理
             if (event.type == SDL_MOUSEBUTTONDOWN) {
                 // --- 修正：先計算主選單按鈕座標，確保和 renderStartScreen 一致 ---
                 int buttonWidth = 200;
@@ -373,8 +428,7 @@ void Game::handleEvents() {
                     mouseY >= continueButton.y && mouseY <= continueButton.y + continueButton.h) {
                     // 重置混亂模式狀態
                     isChaosMode = false;
-                    chaosEvent = ChaosEventType::NONE;
-                    chaosEventTimer = 0.0f;
+                    chaos.clear();
                     // 重置角色選擇狀態
                     selectedCharacterIndex[0] = 0;
                     selectedCharacterIndex[1] = 0;
@@ -416,8 +470,7 @@ void Game::handleEvents() {
                 if (mouseX >= chaosModeButton.x && mouseX <= chaosModeButton.x + chaosModeButton.w &&
                     mouseY >= chaosModeButton.y && mouseY <= chaosModeButton.y + chaosModeButton.h) {
                     isChaosMode = true;
-                    chaosEvent = ChaosEventType::NONE;
-                    chaosEventTimer = 0.0f;
+                    chaos.clear();
                     selectedCharacterIndex[0] = 0;
                     selectedCharacterIndex[1] = 0;
                     characterSelectionConfirmed[0] = false;
@@ -426,100 +479,43 @@ void Game::handleEvents() {
                     printf("Chaos mode start! Entering character selection\n");
                 }
             }
+            // F 鍵切換對戰人數 (2 人為一般對戰，3、4 人為大亂鬥)
+            if (event.type == SDL_KEYDOWN && !event.key.repeat && event.key.keysym.sym == SDLK_f) {
+                freeForAllPlayers = (freeForAllPlayers >= MAX_PLAYERS) ? 2 : freeForAllPlayers + 1;
+                printf("Match players: %d\n", freeForAllPlayers);
+            }
         }
 
-        // 處理角色選擇介面的輸入
+        // 處理角色選擇介面的輸入 (上下移動由 handleCharacterSelection 每個畫面處理)
         if (currentGameState == GameState::CHARACTER_SELECTION) {
-            if (event.type == SDL_KEYDOWN) {
-                // 玩家1控制 (W/S)
-                if (!characterSelectionConfirmed[0]) {
-                    if (event.key.keysym.sym == SDLK_w) {
-                        selectedCharacterIndex[0] = (selectedCharacterIndex[0] - 1 + 2) % 2;
-                        SDL_Delay(200);
-                        printf("Player 1 selected character %d\n", selectedCharacterIndex[0]);
-                    } else if (event.key.keysym.sym == SDLK_s) {
-                        selectedCharacterIndex[0] = (selectedCharacterIndex[0] + 1) % 2;
-                        SDL_Delay(200);
-                        printf("Player 1 selected character %d\n", selectedCharacterIndex[0]);
-                    } else if (event.key.keysym.sym == SDLK_RETURN && !event.key.repeat) {
-                        characterSelectionConfirmed[0] = true;
-                        printf("Player 1 confirmed character selection\n");
-                    }
+            if (InputMap::isPressEvent(event)) {
+                if (!characterSelectionConfirmed[0] && (inputMap.eventActions(event, 0) & INPUT_MENU_CONFIRM)) {
+                    characterSelectionConfirmed[0] = true;
+                    printf("Player 1 confirmed character selection\n");
                 }
-
-                // 玩家2控制 (上下方向鍵)
-                if (!characterSelectionConfirmed[1]) {
-                    if (event.key.keysym.sym == SDLK_UP) {
-                        selectedCharacterIndex[1] = (selectedCharacterIndex[1] - 1 + 2) % 2;
-                        SDL_Delay(200);
-                        printf("Player 2 selected character %d\n", selectedCharacterIndex[1]);
-                    } else if (event.key.keysym.sym == SDLK_DOWN) {
-                        selectedCharacterIndex[1] = (selectedCharacterIndex[1] + 1) % 2;
-                        SDL_Delay(200);
-                        printf("Player 2 selected character %d\n", selectedCharacterIndex[1]);
-                    } else if (event.key.keysym.sym == SDLK_KP_ENTER && !event.key.repeat) {
-                        characterSelectionConfirmed[1] = true;
-                        printf("Player 2 confirmed character selection\n");
-                    }
+                if (!characterSelectionConfirmed[1] && (inputMap.eventActions(event, 1) & INPUT_MENU_CONFIRM)) {
+                    characterSelectionConfirmed[1] = true;
+                    printf("Player 2 confirmed character selection\n");
                 }
 
                 // 如果兩個玩家都確認了選擇，進入拳套選擇階段
                 if (characterSelectionConfirmed[0] && characterSelectionConfirmed[1]) {
-                    // 先重置所有選擇狀態
-                    selectedGloveIndex[0] = 0;
-                    selectedGloveIndex[1] = 0;
-                    gloveSelectionConfirmed[0] = false;
-                    gloveSelectionConfirmed[1] = false;
-                    
-                    // 清除所有按鍵事件
-                    SDL_FlushEvents(SDL_KEYDOWN, SDL_KEYUP);
-                    
-                    // 添加延遲
-                    SDL_Delay(200);
-                    
-                    // 進入拳套選擇階段
                     startGameAfterCharacterSelection();
                     return; // 立即返回，避免處理其他事件
                 }
             }
         }
 
-        // 處理拳套選擇的按鍵事件
+        // 處理拳套選擇的按鍵事件 (上下移動由 handleGloveSelection 每個畫面處理)
         if (currentGameState == GameState::GLOVE_SELECTION) {
-            if (event.type == SDL_KEYDOWN) {
-                // 玩家1選擇 (W/S 鍵)
-                if (!gloveSelectionConfirmed[0]) {
-                    if (event.key.keysym.sym == SDLK_w) {
-                        selectedGloveIndex[0] = (selectedGloveIndex[0] - 1 + 3) % 3;
-                        SDL_Delay(200);
-                        printf("Player 1 selected glove %d\n", selectedGloveIndex[0]);
-                    }
-                    else if (event.key.keysym.sym == SDLK_s) {
-                        selectedGloveIndex[0] = (selectedGloveIndex[0] + 1) % 3;
-                        SDL_Delay(200);
-                        printf("Player 1 selected glove %d\n", selectedGloveIndex[0]);
-                    }
-                    else if (event.key.keysym.sym == SDLK_RETURN && !event.key.repeat) {
-                        gloveSelectionConfirmed[0] = true;
-                        printf("Player 1 confirmed glove selection\n");
-                    }
+            if (InputMap::isPressEvent(event)) {
+                if (!gloveSelectionConfirmed[0] && (inputMap.eventActions(event, 0) & INPUT_MENU_CONFIRM)) {
+                    gloveSelectionConfirmed[0] = true;
+                    printf("Player 1 confirmed glove selection\n");
                 }
-                // 玩家2選擇 (上下鍵)
-                if (!gloveSelectionConfirmed[1]) {
-                    if (event.key.keysym.sym == SDLK_UP) {
-                        selectedGloveIndex[1] = (selectedGloveIndex[1] - 1 + 3) % 3;
-                        SDL_Delay(200);
-                        printf("Player 2 selected glove %d\n", selectedGloveIndex[1]);
-                    }
-                    else if (event.key.keysym.sym == SDLK_DOWN) {
-                        selectedGloveIndex[1] = (selectedGloveIndex[1] + 1) % 3;
-                        SDL_Delay(200);
-                        printf("Player 2 selected glove %d\n", selectedGloveIndex[1]);
-                    }
-                    else if (event.key.keysym.sym == SDLK_KP_ENTER && !event.key.repeat) {
-                        gloveSelectionConfirmed[1] = true;
-                        printf("Player 2 confirmed glove selection\n");
-                    }
+                if (!gloveSelectionConfirmed[1] && (inputMap.eventActions(event, 1) & INPUT_MENU_CONFIRM)) {
+                    gloveSelectionConfirmed[1] = true;
+                    printf("Player 2 confirmed glove selection\n");
                 }
                 // 只有兩人都確認才進入遊戲
                 if (gloveSelectionConfirmed[0] && gloveSelectionConfirmed[1]) {
@@ -529,134 +525,134 @@ void Game::handleEvents() {
             }
         }
 
-        // --- 只有在 PLAYING 狀態下才處理玩家的按鍵放開事件 (如停止格擋、發射氣功) ---
-        if (currentGameState == GameState::PLAYING) {
-            if (event.type == SDL_KEYUP) {
-                // Player 1 停止格擋
-                if (players.size() >= 1 && event.key.keysym.sym == SDLK_k) {
-                    if (players[0].state == Player::PlayerState::BLOCKING) {
-                        players[0].handleAction("STOP_BLOCK");
-                    }
-                }
-                // Player 2 停止格擋
-                if (players.size() >= 2 && event.key.keysym.sym == SDLK_KP_2) {
-                    if (players[1].state == Player::PlayerState::BLOCKING) {
-                        players[1].handleAction("STOP_BLOCK");
-                    }
-                }
-            }
-            // 處理按下按鍵的瞬間觸發事件 (發射氣功/技能)
-            if (event.type == SDL_KEYDOWN) {
-                // Player 1 發射氣功
-                if (players.size() >= 1 && event.key.keysym.sym == SDLK_u && !event.key.repeat) {
-                    players[0].handleAction("FIRE_PROJECTILE");
-                }
-                // Player 1 特殊攻擊
-                if (players.size() >= 1 && event.key.keysym.sym == SDLK_i && !event.key.repeat) {
-                    if (players[0].canUseSpecialAttack()) {
-                        if (players[0].characterId == "BlockMan") {
-                            players[0].handleAction("SPECIAL_ATTACK");
-                            if (players.size() >= 2) {
-                                players[1].changeState(Player::PlayerState::LYING);
-                                players[1].hurtTimer = 0.5f;
-                            }
-                        } else if (players[0].characterId == "Godon") {
-                            players[0].handleAction("SPECIAL_ATTACK");
-                        }
-                    }
-                }
-                // Player 2 發射氣功
-                if (players.size() >= 2 && event.key.keysym.sym == SDLK_KP_4 && !event.key.repeat) {
-                    players[1].handleAction("FIRE_PROJECTILE");
-                }
-                // Player 2 特殊攻擊
-                if (players.size() >= 2 && event.key.keysym.sym == SDLK_KP_5 && !event.key.repeat) {
-                    if (players[1].canUseSpecialAttack()) {
-                        if (players[1].characterId == "BlockMan") {
-                            players[1].handleAction("SPECIAL_ATTACK");
-                            if (players.size() >= 1) {
-                                players[0].changeState(Player::PlayerState::LYING);
-                                players[0].hurtTimer = 0.5f;
-                            }
-                        } else if (players[1].characterId == "Godon") {
-                            players[1].handleAction("SPECIAL_ATTACK");
-                        }
-                    }
-                }
-            }
+    }
+
+    // --- 選單的上下移動 (按住時依畫面時鐘自動重複) ---
+    if (currentGameState == GameState::CHARACTER_SELECTION) {
+        handleCharacterSelection();
+    } else if (currentGameState == GameState::GLOVE_SELECTION) {
+        handleGloveSelection();
+    } else {
+        menuInput.reset(); // 進入選單時按住的鍵要重新按下才會移動
+    }
+
+    // --- 持續按壓的移動/攻擊等在每個 tick 模擬前才取樣 (latchInput)，其他狀態清空輸入 ---
+    if (currentGameState != GameState::PLAYING) {
+        currentInput = TickInput();
+    }
+}
+
+void Game::latchInput() {
+    // 盡量晚取樣：同一個畫面追趕多個 tick 時，每個 tick 都重新讀取按鍵狀態
+    if (currentGameState != GameState::PLAYING || isReplayPlayback) return;
+    sampleHeldInput();
+    inputLatency.onTickLatched(matchTick);
+}
+
+void Game::sampleHeldInput() {
+    inputMap.sampleHeld(currentInput);
+}
+
+void Game::resolvePlayerCommands(const TickInput& input, PlayerCommands out[MAX_PLAYERS]) const {
+    bool reverse = (isChaosMode && chaos.modifiers().reverseControls > 0);
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        Uint16 buttons = input.buttons[i];
+        PlayerCommands& commands = out[i];
+
+        // --- 按下瞬間觸發的事件 (發射氣功/技能) ---
+        commands.pressed = 0;
+        if (buttons & INPUT_FIRE_PRESSED) commands.pressed |= CMD_FIRE_PROJECTILE;
+        if (buttons & INPUT_SPECIAL_PRESSED) commands.pressed |= CMD_SPECIAL_ATTACK;
+
+        // --- 持續按壓的移動/攻擊等 ---
+        if (buttons & INPUT_BLOCK) {
+            commands.held = CMD_BLOCK | CMD_STOP_X;
+            continue;
         }
+        // --- 控制反轉 (位元置換) ---
+        if (reverse) buttons = reverseInputButtons(buttons);
+        bool left = buttons & INPUT_LEFT;
+        bool right = buttons & INPUT_RIGHT;
+        bool up = buttons & INPUT_UP;
+        bool down = buttons & INPUT_DOWN;
+        bool attack = buttons & INPUT_ATTACK;
+        bool fire = buttons & INPUT_FIRE;
+        commands.held = CMD_STOP_BLOCK;
+        if (up) commands.held |= CMD_JUMP;
+        if (attack) commands.held |= CMD_ATTACK;
+        commands.held |= down ? CMD_LYING : CMD_STAND_UP;
+        if (left) commands.held |= CMD_LEFT;
+        else if (right) commands.held |= CMD_RIGHT;
+        else commands.held |= CMD_STOP_X;
+        // 反轉時，普攻/氣功鍵互換 (兩個都按時只攻擊)
+        if (fire && !(reverse && attack)) commands.held |= CMD_FIRE_PROJECTILE;
     }
+}
 
-    // --- 只有在 PLAYING 狀態下才處理持續按壓的移動/攻擊等 ---
-    if (currentGameState == GameState::PLAYING) {
-        const Uint8* keystates = SDL_GetKeyboardState(NULL);
-        // Player 1 控制 (活著且不在受傷/死亡狀態才能控制)
-        if (players.size() >= 1 && players[0].isAlive()) {
-            Player& p1 = players[0];
-            bool isBlocking = keystates[SDL_SCANCODE_K];
-            if (isBlocking) {
-                p1.handleAction("BLOCK");
-                p1.handleAction("STOP_X");
-            } else {
-                if (p1.state == Player::PlayerState::BLOCKING) {
-                    p1.handleAction("STOP_BLOCK");
-                }
-                // --- 控制反轉 ---
-                bool reverse = (isChaosMode && chaosEvent == ChaosEventType::CONTROL_REVERSE);
-                bool p1Left = reverse ? keystates[SDL_SCANCODE_D] : keystates[SDL_SCANCODE_A];
-                bool p1Right = reverse ? keystates[SDL_SCANCODE_A] : keystates[SDL_SCANCODE_D];
-                bool p1Up = reverse ? keystates[SDL_SCANCODE_S] : keystates[SDL_SCANCODE_W];
-                bool p1Down = reverse ? keystates[SDL_SCANCODE_W] : keystates[SDL_SCANCODE_S];
-                bool p1Attack = reverse ? keystates[SDL_SCANCODE_U] : keystates[SDL_SCANCODE_J];
-                bool p1Fire = reverse ? keystates[SDL_SCANCODE_J] : keystates[SDL_SCANCODE_U];
-                if (p1Up) p1.handleAction("JUMP");
-                if (p1Attack) p1.handleAction("ATTACK");
-                if (p1Down) {
-                    p1.handleAction("LYING");
-                } else if (p1.state == Player::PlayerState::LYING) {
-                    p1.handleAction("IDLE");
-                }
-                if (p1Left) p1.handleAction("LEFT");
-                else if (p1Right) p1.handleAction("RIGHT");
-                else p1.handleAction("STOP_X");
-                // 反轉時，普攻/氣功鍵互換
-                if (reverse && p1Fire && !p1Attack) p1.handleAction("FIRE_PROJECTILE");
-                else if (!reverse && keystates[SDL_SCANCODE_U]) p1.handleAction("FIRE_PROJECTILE");
-            }
+void Game::applyPlayerInputs(const TickInput& input) {
+    PlayerCommands commands[MAX_PLAYERS];
+    resolvePlayerCommands(input, commands);
+
+    // --- 輸入記錄：搓招與緩衝輸入 (記錄的是套用控制反轉後的按鍵) ---
+    bool reverse = (isChaosMode && chaos.modifiers().reverseControls > 0);
+    for (size_t i = 0; i < players.size() && i < MAX_PLAYERS; ++i) {
+        Player& player = players[i];
+        InputHistory& history = player.inputHistory;
+        Uint16 buttons = input.buttons[i] & ~INPUT_EDGE_MASK;
+        if (reverse) buttons = reverseInputButtons(buttons);
+        history.record(matchTick, buttons);
+        history.advanceMotions(matchTick, inputDirection(buttons, player.direction));
+
+        // 下、前下、前 + 普攻：跟按特殊技能鍵相同，這次按下不再出拳
+        const MotionCommand& motion = MOTION_COMMANDS[MOTION_QUARTER_CIRCLE_FORWARD];
+        if (motionCommandsEnabled && history.pressedAt(motion.button, matchTick) &&
+            history.isMotionReady(MOTION_QUARTER_CIRCLE_FORWARD, matchTick) && player.canUseSpecialAttack()) {
+            commands[i].pressed |= CMD_SPECIAL_ATTACK;
+            commands[i].held &= ~CMD_ATTACK;
+            history.consumePress(motion.button, matchTick, 0);
+            history.resetMotion(MOTION_QUARTER_CIRCLE_FORWARD);
+            continue;
         }
-        // Player 2 控制 (活著且不在受傷/死亡狀態才能控制)
-        if (players.size() >= 2 && players[1].isAlive()) {
-            Player& p2 = players[1];
-            bool isBlocking = keystates[SDL_SCANCODE_KP_2];
-            if (isBlocking) {
-                p2.handleAction("BLOCK");
-                p2.handleAction("STOP_X");
-            } else {
-                if (p2.state == Player::PlayerState::BLOCKING) {
-                    p2.handleAction("STOP_BLOCK");
-                }
-                bool reverse = (isChaosMode && chaosEvent == ChaosEventType::CONTROL_REVERSE);
-                bool p2Left = reverse ? keystates[SDL_SCANCODE_RIGHT] : keystates[SDL_SCANCODE_LEFT];
-                bool p2Right = reverse ? keystates[SDL_SCANCODE_LEFT] : keystates[SDL_SCANCODE_RIGHT];
-                bool p2Up = reverse ? keystates[SDL_SCANCODE_DOWN] : keystates[SDL_SCANCODE_UP];
-                bool p2Down = reverse ? keystates[SDL_SCANCODE_UP] : keystates[SDL_SCANCODE_DOWN];
-                bool p2Attack = reverse ? keystates[SDL_SCANCODE_KP_4] : keystates[SDL_SCANCODE_KP_1];
-                bool p2Fire = reverse ? keystates[SDL_SCANCODE_KP_1] : keystates[SDL_SCANCODE_KP_4];
-                if (p2Up) p2.handleAction("JUMP");
-                if (p2Attack) p2.handleAction("ATTACK");
-                if (p2Down) {
-                    p2.handleAction("LYING");
-                } else if (p2.state == Player::PlayerState::LYING) {
-                    p2.handleAction("IDLE");
-                }
-                if (p2Left) p2.handleAction("LEFT");
-                else if (p2Right) p2.handleAction("RIGHT");
-                else p2.handleAction("STOP_X");
-                if (reverse && p2Fire && !p2Attack) p2.handleAction("FIRE_PROJECTILE");
-                else if (!reverse && keystates[SDL_SCANCODE_KP_4]) p2.handleAction("FIRE_PROJECTILE");
+
+        // 緩衝輸入：沒按住普攻時，最近 inputBufferTicks 內按下、還沒出過拳的普攻仍然有效
+        Uint32 pressTick;
+        if (!(commands[i].held & (CMD_ATTACK | CMD_BLOCK)) &&
+            history.findBufferedPress(INPUT_ATTACK, matchTick, player.balance.inputBufferTicks, pressTick)) {
+            commands[i].held |= CMD_ATTACK;
+        }
+    }
+
+    // --- 按下瞬間觸發的事件 (發射氣功/技能) ---
+    for (size_t i = 0; i < players.size() && i < MAX_PLAYERS; ++i) {
+        Player& player = players[i];
+        Uint16 pressed = commands[i].pressed;
+        bool special = (pressed & CMD_SPECIAL_ATTACK) && player.canUseSpecialAttack();
+        if (!special) pressed &= ~CMD_SPECIAL_ATTACK;
+        player.executeCommands(pressed);
+        if (special && player.getTraits().specialAttack == SpecialAttackType::KNOCKDOWN) {
+            int other = findNearestOpponent(static_cast<int>(i)); // 擊倒最近的對手
+            if (other >= 0) {
+                players[other].changeState(Player::PlayerState::LYING);
+                players[other].hurtTimer.start(matchTick, secondsToTicks(player.getTraits().knockdownDuration));
             }
         }
     }
+
+    // --- 持續按壓的移動/攻擊等 (活著且不在受傷/死亡狀態才能控制) ---
+    for (size_t i = 0; i < players.size() && i < MAX_PLAYERS; ++i) {
+        Player& p = players[i];
+        if (!p.isAlive()) continue;
+        Uint32 attackRateCooldown = p.attackRateCooldownTimer.expiresAt;
+        bool wasOnGround = p.isOnGround;
+        p.executeCommands(commands[i].held);
+        if (wasOnGround && !p.isOnGround) {
+            gameEvents.push(makeGameEvent(GameEventType::JUMP, matchTick, static_cast<int>(i)));
+        }
+        // 出拳了 (只有普攻會啟動出拳頻率冷卻)：這次按下已經用掉
+        if (p.attackRateCooldownTimer.expiresAt != attackRateCooldown) {
+            p.inputHistory.consumePress(INPUT_ATTACK, matchTick, p.balance.inputBufferTicks);
+        }
+    }
 }
 
 void Game::render() {
@@ -664,6 +660,20 @@ void Game::render() {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
+    // 觀看重播時畫競技場與重播控制列
+    if (isReplayPlayback) {
+        renderReplay();
+        SDL_RenderPresent(renderer);
+        return;
+    }
+
+    // 連線對戰握手中只顯示等待訊息
+    if (netSession && !netSession->isConnected()) {
+        renderNetplayInfo();
+        SDL_RenderPresent(renderer);
+        return;
+    }
+
     // 宣告所有需要的變數
     SDL_Texture* bgTex = nullptr;
     SDL_Texture* victoryTex = nullptr;
@@ -685,7 +695,7 @@ void Game::render() {
         case GameState::PAUSED:  // 暫停狀態需要先渲染遊戲畫面
             // 繪製背景
             if (isChaosMode) {
-                bgTex = TextureManager::getTexture(chaosBgIndex == 0 ? "background" : "background0");
+                bgTex = TextureManager::getTexture(chaos.state.bgIndex == 0 ? "background" : "background0");
             } else {
                 bgTex = TextureManager::getTexture("background");
             }
@@ -698,21 +708,8 @@ void Game::render() {
                 player.render(renderer);
         }
 
-        // 繪製氣功
-            for (const Projectile& proj : projectiles) {
-                if (proj.isActive) {
-                    SDL_Rect destRect = {
-                        static_cast<int>(proj.x),
-                        static_cast<int>(proj.y),
-                        PROJECTILE_HITBOX_W,
-                        PROJECTILE_HITBOX_H
-                    };
-                    SDL_Texture* projTex = TextureManager::getTexture(proj.textureId);
-                    if (projTex) {
-                        SDL_RenderCopy(renderer, projTex, &proj.srcRect, &destRect);
-                    }
-                }
-            }
+        // 繪製氣功與特效粒子
+            world.render(renderer, matchTick);
 
             // 繪製回合資訊（血條、計時器等）
         renderRoundInfo();
@@ -787,10 +784,8 @@ void Game::render() {
                 }
             }
             // --- 混亂模式事件提示 ---
-            if (isChaosMode && chaosEvent != ChaosEventType::NONE && chaosEventShowTimer > 0.0f && buttonFont) {
-                const char* chaosMsg = nullptr;
-                if (chaosEvent == ChaosEventType::CONTROL_REVERSE) chaosMsg = "超級控制大混亂! (鍵位全部顛倒)";
-                else if (chaosEvent == ChaosEventType::HP_SWAP) chaosMsg = "血條交換! (血量百分比互換)";
+            if (isChaosMode && buttonFont) {
+                const char* chaosMsg = chaos.bannerText(matchTick);
                 if (chaosMsg) {
                     SDL_Color c = {255, 0, 0, 255};
                     SDL_Surface* surf = TTF_RenderUTF8_Blended(buttonFont, chaosMsg, c);
@@ -825,9 +820,7 @@ void Game::render() {
         case GameState::MATCH_OVER:
             winTexId = "victory_screen";
             if (roundWinnerIndex >= 0 && roundWinnerIndex < players.size()) {
-                std::string cid = players[roundWinnerIndex].characterId;
-                if (cid == "BlockMan") winTexId = "blockman_win_screen";
-                else if (cid == "Godon") winTexId = "godon_win_screen";
+                winTexId = players[roundWinnerIndex].getTraits().winScreenTextureId;
             }
             victoryTex = TextureManager::getTexture(winTexId);
             if (victoryTex) {
@@ -837,7 +830,8 @@ void Game::render() {
             // 添加返回提示
             if (buttonFont) {
                 SDL_Color hintColor = {255, 255, 255, 255}; // 白色
-                SDL_Surface* hintText = TTF_RenderUTF8_Blended(buttonFont, "按 ESC 返回主選單", hintColor);
+                const char* hint = replay.isEmpty() ? "按 ESC 返回主選單" : "按 ESC 返回主選單，按 R 觀看重播";
+                SDL_Surface* hintText = TTF_RenderUTF8_Blended(buttonFont, hint, hintColor);
                 if (hintText) {
                     SDL_Texture* hintTexture = SDL_CreateTextureFromSurface(renderer, hintText);
                     SDL_Rect hintRect = {
@@ -860,39 +854,67 @@ void Game::render() {
             break;
     }
 
+    if (netSession) {
+        renderNetplayInfo();
+    }
+    if (inputLatency.overlayEnabled) {
+        renderLatencyOverlay();
+    }
+
     // 更新畫面
     SDL_RenderPresent(renderer);
 }
 
 void Game::spawnProjectile(float startX, float startY, int direction, int ownerIndex) {
-    Projectile p;
-
     // --- 水平位置計算 ---
     // 從玩家身體的 X 位置開始計算偏移
     // 如果向右 (direction=1)，氣功在玩家寬度之後；如果向左 (direction=-1)，氣功在玩家 X 座標之前
     float spawnOffsetX = (direction > 0) ? (PLAYER_LOGIC_WIDTH * 0.5f) : (-PROJECTILE_HITBOX_W - PLAYER_LOGIC_WIDTH * 0.5f);
-    p.x = startX + spawnOffsetX; // 使用傳入的 startX (這是玩家的 x 座標)
+    float x = startX + spawnOffsetX; // 使用傳入的 startX (這是玩家的 x 座標)
 
     // --- 垂直位置計算 (修正) ---
     // startY 已經是玩家的垂直中心 (player.y + PLAYER_LOGIC_HEIGHT / 2.0f)
     // 我們只需要將這個中心點減去氣功高度的一半，得到氣功的頂部 Y
-    p.y = startY - (PROJECTILE_HITBOX_H / 2.0f);
+    float y = startY - (PROJECTILE_HITBOX_H / 2.0f);
 
     // --- 其他屬性設定 ---
-    p.vx = PROJECTILE_SPEED * direction; // 設定水平速度和方向
-    p.ownerPlayerIndex = ownerIndex;
-    p.isActive = true;
-    p.textureId = "projectile_sprites"; // 確保這個 ID 和載入時一致
-
-    // 設定氣功在精靈圖上的來源矩形 (使用 Constants.h 的值)
-    p.srcRect = {PROJECTILE_SRC_X, PROJECTILE_SRC_Y, PROJECTILE_SRC_W, PROJECTILE_SRC_H};
+    float vx = PROJECTILE_SPEED * direction; // 設定水平速度和方向
+    if (world.projectiles.spawn(x, y, vx, ownerIndex) < 0) {
+        DEBUG_LOG("Projectile pool full (%d), shot from player %d dropped\n", MAX_PROJECTILES, ownerIndex);
+        return;
+    }
+    GameEvent event = makeGameEvent(GameEventType::PROJECTILE_SPAWN, matchTick, ownerIndex);
+    event.direction = static_cast<Sint8>(direction);
+    event.x = x;
+    event.y = y;
+    gameEvents.push(event);
+}
 
-    projectiles.push_back(p); // 加入到遊戲的氣功列表中
-    printf("Spawned projectile for player %d at (%.1f, %.1f) with vx=%.1f\n", ownerIndex, p.x, p.y, p.vx);
+// 混亂模式「氣功洪水」：每個 tick 從畫面左右兩側射出不屬於任何玩家的氣功 (雙方都會被打到)
+void Game::spawnChaosFlood() {
+    for (int i = 0; i < CHAOS_FLOOD_PER_TICK; ++i) {
+        for (int side = 0; side < 2; ++side) {
+            float x = (side == 0) ? static_cast<float>(-PROJECTILE_HITBOX_W) : static_cast<float>(SCREEN_WIDTH);
+            float y = static_cast<float>(GROUND_LEVEL - PROJECTILE_HITBOX_H - static_cast<int>(chaos.nextRandom() % CHAOS_FLOOD_HEIGHT_RANGE));
+            float vx = (side == 0) ? PROJECTILE_SPEED : -PROJECTILE_SPEED;
+            if (world.projectiles.spawn(x, y, vx, -1) < 0) return; // 池子滿了，這個 tick 不再發射
+            GameEvent event = makeGameEvent(GameEventType::PROJECTILE_SPAWN, matchTick, -1);
+            event.direction = static_cast<Sint8>(side == 0 ? 1 : -1);
+            event.x = x;
+            event.y = y;
+            gameEvents.push(event);
+        }
+    }
 }
 
 void Game::cleanup() {
+    // 關閉連線對戰的 socket
+    netSession.reset();
+    // SDL 與各資源管理器是全域共用的，只由初始化它們的 Game 關閉 (批次模擬的工作執行緒各有一個 Game)
+    if (!ownsSubsystems) return;
+    ownsSubsystems = false;
     printf("Cleaning up Game...\n");
+    inputMap.closeGamepads();
     // 釋放紋理 (透過 TextureManager)
     TextureManager::unloadAllTextures();
     //清理音訊
@@ -922,71 +944,56 @@ void Game::cleanup() {
 }
 
 void Game::resetPlayersForRound() {
-    printf("Resetting players for round %d\n", currentRound);
+    DEBUG_LOG("Resetting players for round %d\n", currentRound);
     if (players.size() < 2) return;
 
-    // 玩家 1 重置
-    Player& p1 = players[0];
-    p1.x = 100.0f; // 起始 X 位置
-    p1.y = GROUND_LEVEL - PLAYER_LOGIC_HEIGHT; // 地面 Y 位置
-    p1.vx = 0.0f;
-    p1.vy = 0.0f;
-    p1.health = PLAYER_DEFAULT_HEALTH; // 重置血量
-    p1.direction = 1; // 面向右
-    p1.state = Player::PlayerState::IDLE; // 初始狀態
-    p1.currentAnimationType = AnimationType::IDLE; // 初始動畫
-    p1.currentFrame = 0;
-    p1.frameTimer = 0.0f;
-    p1.invincibilityTimer = 0.0f; // 清除無敵
-    p1.attackTimer = 0.0f;
-    p1.attackCooldownTimer = 0.0f;
-    p1.hurtTimer = 0.0f;
-    p1.blockCooldownTimer = 0.0f;
-    p1.attackRateCooldownTimer = 0.0f;
-    p1.projectileCooldownTimer = 0.0f;
-    p1.isOnGround = true; // 確保在地面上
-    p1.shouldFireProjectile = false;
-
-    // 玩家 2 重置
-    Player& p2 = players[1];
-    p2.x = SCREEN_WIDTH - 100.0f - PLAYER_LOGIC_WIDTH; // 起始 X 位置
-    p2.y = GROUND_LEVEL - PLAYER_LOGIC_HEIGHT; // 地面 Y 位置
-    p2.vx = 0.0f;
-    p2.vy = 0.0f;
-    p2.health = PLAYER_DEFAULT_HEALTH; // 重置血量
-    p2.direction = -1; // 面向左
-    p2.state = Player::PlayerState::IDLE; // 初始狀態
-    p2.currentAnimationType = AnimationType::IDLE; // 初始動畫
-    p2.currentFrame = 0;
-    p2.frameTimer = 0.0f;
-    p2.invincibilityTimer = 0.0f; // 清除無敵
-    p2.attackTimer = 0.0f;
-    p2.attackCooldownTimer = 0.0f;
-    p2.hurtTimer = 0.0f;
-    p2.blockCooldownTimer = 0.0f;
-    p2.attackRateCooldownTimer = 0.0f;
-    p2.projectileCooldownTimer = 0.0f;
-    p2.isOnGround = true; // 確保在地面上
-    p2.shouldFireProjectile = false;
-
-    // 清除場上的氣功
-    projectiles.clear();
+    // 起始位置：P1 在最左、P2 在最右，大亂鬥的 P3、P4 平均分布在中間 (偶數號面向右，奇數號面向左)
+    int count = static_cast<int>(players.size());
+    static const int SPAWN_SLOTS[MAX_PLAYERS][MAX_PLAYERS] = {
+        {0}, {0, 1}, {0, 2, 1}, {0, 3, 1, 2}
+    };
+    float spawnSpan = static_cast<float>(SCREEN_WIDTH - 200 - PLAYER_LOGIC_WIDTH);
+    for (int i = 0; i < count; ++i) {
+        Player& p = players[i];
+        p.x = 100.0f + spawnSpan * SPAWN_SLOTS[count - 1][i] / (count - 1); // 起始 X 位置
+        p.y = GROUND_LEVEL - PLAYER_LOGIC_HEIGHT; // 地面 Y 位置
+        p.vx = 0.0f;
+        p.vy = 0.0f;
+        p.health = PLAYER_DEFAULT_HEALTH; // 重置血量
+        p.direction = (i % 2 == 0) ? 1 : -1;
+        p.state = Player::PlayerState::IDLE; // 初始狀態
+        p.currentAnimationType = AnimationType::IDLE; // 初始動畫
+        p.stateEnteredTick = matchTick; // 動畫從第一幀開始
+        p.invincibilityTimer.clear(); // 清除無敵
+        p.attackTimer.clear();
+        p.attackCooldownTimer.clear();
+        p.hurtTimer.clear();
+        p.blockCooldownTimer.clear();
+        p.attackRateCooldownTimer.clear();
+        p.projectileCooldownTimer.clear();
+        p.isOnGround = true; // 確保在地面上
+        p.shouldFireProjectile = false;
+        p.inputHistory.clear(); // 上一回合按的鍵不會緩衝到新回合
+    }
+
+    // 清除場上的氣功與特效
+    world.clear();
 }
 
 void Game::startNewRound() {
     currentRound++; // 回合數增加
-    printf("----- Starting Round %d -----\n", currentRound);
-    roundTimer = ROUND_TIME_LIMIT; // 重置回合時間
+    DEBUG_LOG("----- Starting Round %d -----\n", currentRound);
+    roundTimer.start(matchTick, secondsToTicks(ROUND_TIME_LIMIT)); // 重置回合時間
     roundWinnerIndex = -1; // 清除上一回合勝利者
     resetPlayersForRound(); // 重置玩家狀態
     currentGameState = GameState::PLAYING; // 設定遊戲狀態為進行中
     // 可以在這裡播放 "Round X" 或 "Fight!" 的音效
     // AudioManager::playSound("round_start_sfx");
-    // --- 混亂模式：第一回合事件倒數設為10秒 ---
+    // --- 混亂模式：每回合重新排程，第一個事件在 CHAOS_FIRST_EVENT_DELAY 秒後 ---
     if (isChaosMode) {
-        chaosEventTimer = 10.0f;
-        chaosEventShowTimer = 0.0f;
-        chaosEvent = ChaosEventType::NONE;
+        chaos.startRound(*this, matchTick);
+    } else {
+        chaos.clear();
     }
 }
 
@@ -996,115 +1003,162 @@ void Game::endRound(int winnerPlayerIndex) {
         return;
     }
 
-    printf("----- Round %d Over -----\n", currentRound);
+    DEBUG_LOG("----- Round %d Over -----\n", currentRound);
     roundWinnerIndex = winnerPlayerIndex; // 記錄勝利者索引
 
-    if (winnerPlayerIndex == 0) { // P1 獲勝
-        playerWins[0]++;
-        printf("Player 1 wins the round! Score: P1=%d, P2=%d\n", playerWins[0], playerWins[1]);
-    } else if (winnerPlayerIndex == 1) { // P2 獲勝
-        playerWins[1]++;
-        printf("Player 2 wins the round! Score: P1=%d, P2=%d\n", playerWins[0], playerWins[1]);
-    } else { // 平手
-        printf("Round Draw! Score: P1=%d, P2=%d\n", playerWins[0], playerWins[1]);
-        // 播放平手音效
-        AudioManager::playSound("draw_sfx");
+    if (winnerPlayerIndex >= 0 && winnerPlayerIndex < static_cast<int>(players.size())) {
+        playerWins[winnerPlayerIndex]++;
+        DEBUG_LOG("Player %d wins the round! (%d round wins)\n", winnerPlayerIndex + 1, playerWins[winnerPlayerIndex]);
+    } else { // 平手 (時間到血量相同，或最後的玩家同時倒下)
+        DEBUG_LOG("Round Draw!\n");
     }
+    GameEvent event = makeGameEvent(GameEventType::ROUND_END, matchTick, roundWinnerIndex);
+    event.value = static_cast<Sint16>(currentRound);
+    gameEvents.push(event);
 
     currentGameState = GameState::ROUND_OVER; // 切換到回合結束狀態
-    roundOverTimer = 3.0f; // 設定為 3 秒的等待時間
+    roundOverTimer.start(matchTick, secondsToTicks(3.0f)); // 設定為 3 秒的等待時間
 }
 
 void Game::checkForMatchWinner() {
-    int winnerIndex = -1; // 先找出勝利者索引
-    if (playerWins[0] >= ROUNDS_TO_WIN_MATCH) {
-        winnerIndex = 0;
-    } else if (playerWins[1] >= ROUNDS_TO_WIN_MATCH) {
-        winnerIndex = 1;
+    int winnerIndex = -1; // 先找出勝利者索引 (每回合只有一人加分，不會同時有兩人達標)
+    for (size_t i = 0; i < players.size() && i < MAX_PLAYERS; ++i) {
+        if (playerWins[i] >= ROUNDS_TO_WIN_MATCH) {
+            winnerIndex = static_cast<int>(i);
+            break;
+        }
     }
 
     // 如果有勝利者產生
     if (winnerIndex != -1) {
-        printf("====== Player %d Wins the Match! ======\n", winnerIndex + 1);
+        DEBUG_LOG("====== Player %d Wins the Match! ======\n", winnerIndex + 1);
         currentGameState = GameState::MATCH_OVER;
         roundWinnerIndex = winnerIndex; // 標記比賽勝利者
 
-        // --- 新增：處理勝利者和失敗者狀態，以及音效 ---
+        // --- 新增：處理勝利者和失敗者狀態 (勝利音效、停止 BGM 與對戰記錄由事件的消費者處理) ---
         if (winnerIndex >= 0 && static_cast<size_t>(winnerIndex) < players.size()) { // 確保玩家存在
             players[winnerIndex].changeState(Player::PlayerState::VICTORY); // 設定勝利者狀態
-            std::string cid = players[winnerIndex].characterId;
-            // 強制轉小寫比對避免大小寫問題
-            std::string cidLower = cid;
-            std::transform(cidLower.begin(), cidLower.end(), cidLower.begin(), ::tolower);
-            if (cidLower == "blockman")
-                AudioManager::playRandomSound("blockman_victory",-1);
-            else if (cidLower == "godon")
-                AudioManager::playRandomSound("godon_victory",-1);
 
             // (可選) 設定失敗者狀態 (如果他不是 DEATH 的話)
-            int loserIndex = 1 - winnerIndex; // 0 -> 1, 1 -> 0
-            if (loserIndex >= 0 && static_cast<size_t>(loserIndex) < players.size() && players[loserIndex].isAlive()) {
-                 printf("Match ended, loser (Player %d) was still alive.\n", loserIndex + 1);
-            } else if (loserIndex >= 0 && static_cast<size_t>(loserIndex) < players.size()) {
-                 printf("Match ended, loser (Player %d) was already defeated.\n", loserIndex + 1);
+            for (size_t loserIndex = 0; loserIndex < players.size(); ++loserIndex) {
+                if (static_cast<int>(loserIndex) == winnerIndex) continue;
+                DEBUG_LOG("Match ended, loser (Player %zu) was %s.\n", loserIndex + 1,
+                          players[loserIndex].isAlive() ? "still alive" : "already defeated");
             }
         }
+        gameEvents.push(makeGameEvent(GameEventType::MATCH_END, matchTick, winnerIndex));
+    }
+}
 
-        AudioManager::stopMusic(); // 停止 BGM
-        // 在整場比賽結束時保存記錄
-        saveGameRecord();
+namespace {
+
+// 一條冷卻條：冷卻結束時是綠色滿格，冷卻中是紅色 (長度為剩餘比例)，標籤畫在靠畫面中央的一側
+void renderCooldownBar(SDL_Renderer* renderer, TTF_Font* font, int x, int y, bool labelOnRight,
+                       const TickTimer& timer, float duration, Uint32 now, const char* label) {
+    const int barWidth = 80;
+    const int barHeight = 12;
+    SDL_Rect bg = {x, y, barWidth, barHeight};
+    SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
+    SDL_RenderFillRect(renderer, &bg);
+    if (!timer.isActive(now)) {
+        SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
+        SDL_Rect fg = {x, y, barWidth, barHeight};
+        SDL_RenderFillRect(renderer, &fg);
+    } else {
+        int fgWidth = (int)(barWidth * (timer.remainingSeconds(now) / duration));
+        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+        SDL_Rect fg = {x, y, fgWidth, barHeight};
+        SDL_RenderFillRect(renderer, &fg);
     }
+    if (!font) return;
+    SDL_Surface* txtSurf = TTF_RenderUTF8_Blended(font, label, {255, 255, 255, 255});
+    if (!txtSurf) return;
+    SDL_Texture* txtTex = SDL_CreateTextureFromSurface(renderer, txtSurf);
+    int txtX = labelOnRight ? x + barWidth + 8 : x - txtSurf->w - 8;
+    SDL_Rect txtRect = {txtX, y + (barHeight - txtSurf->h) / 2, txtSurf->w, txtSurf->h};
+    SDL_RenderCopy(renderer, txtTex, NULL, &txtRect);
+    SDL_FreeSurface(txtSurf);
+    SDL_DestroyTexture(txtTex);
 }
 
-// --- 繪製回合相關資訊 (血條、勝利標記、計時器) ---
-void Game::renderRoundInfo() {
-    // --- 繪製血條 ---
+} // namespace
+
+// --- 繪製一位玩家的血條、勝利標記與冷卻條 ---
+// 偶數號玩家排在左上、奇數號排在右上；大亂鬥的 P3、P4 各自往畫面中央再排一欄
+void Game::renderPlayerHud(int playerIndex) {
+    const Player& player = players[playerIndex];
     int healthBarWidth = 200;
     int healthBarHeight = 15;
     int healthBarY = 10;
     int winMarkY = healthBarY + healthBarHeight + 5; // 勝利標記 Y 座標
     int winMarkSize = 10;
     int winMarkSpacing = 5;
+    int columnOffset = (playerIndex / 2) * (healthBarWidth + 10);
+    bool leftSide = (playerIndex % 2 == 0);
+
+    // 血條 (左側從左往右畫，右側從右往左畫)
+    int healthBarX = leftSide ? 10 + columnOffset : SCREEN_WIDTH - 10 - healthBarWidth - columnOffset;
+    SDL_Rect healthBg = {healthBarX, healthBarY, healthBarWidth, healthBarHeight};
+    SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
+    SDL_RenderFillRect(renderer, &healthBg);
+    int fgWidth = (int)(healthBarWidth * std::max(0.0f, (float)player.health) / PLAYER_DEFAULT_HEALTH);
+    SDL_Rect healthFg = {leftSide ? healthBarX : healthBarX + healthBarWidth - fgWidth, healthBarY, fgWidth, healthBarHeight};
+    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
+    SDL_RenderFillRect(renderer, &healthFg);
+
+    // 勝利標記 (金色)
+    SDL_SetRenderDrawColor(renderer, 255, 215, 0, 255);
+    for (int i = 0; i < playerWins[playerIndex]; ++i) {
+        int markX = leftSide ? healthBarX + i * (winMarkSize + winMarkSpacing)
+                             : healthBarX + healthBarWidth - (i + 1) * (winMarkSize + winMarkSpacing) + winMarkSpacing;
+        SDL_Rect mark = {markX, winMarkY, winMarkSize, winMarkSize};
+        SDL_RenderFillRect(renderer, &mark);
+    }
 
-    // 玩家 1 血條和勝利標記
-    if (players.size() >= 1) {
-        Player& p1 = players[0];
-        // 背景
-        SDL_Rect p1HealthBg = {10, healthBarY, healthBarWidth, healthBarHeight};
-        SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-        SDL_RenderFillRect(renderer, &p1HealthBg);
-        // 前景
-        int p1FgWidth = (int)(healthBarWidth * std::max(0.0f, (float)p1.health) / PLAYER_DEFAULT_HEALTH);
-        SDL_Rect p1HealthFg = {10, healthBarY, p1FgWidth, healthBarHeight};
-        SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-        SDL_RenderFillRect(renderer, &p1HealthFg);
-        // 勝利標記 (金色)
-        SDL_SetRenderDrawColor(renderer, 255, 215, 0, 255);
-        for (int i = 0; i < playerWins[0]; ++i) {
-            SDL_Rect p1Mark = {10 + i * (winMarkSize + winMarkSpacing), winMarkY, winMarkSize, winMarkSize};
-            SDL_RenderFillRect(renderer, &p1Mark);
+    // 冷卻條（Block、Punch、Projectile、Skill）
+    if (players.size() < 2) return;
+    int barWidth = 80;
+    int barHeight = 12;
+    int gapY = 8;
+    int baseY = 50;
+
+    // 載入小字體（只載入一次）
+    static TTF_Font* smallFont = nullptr;
+    if (!smallFont) {
+        smallFont = TTF_OpenFont("assets/fonts/msjh.ttf", 16);
+    }
+    TTF_Font* labelFont = smallFont ? smallFont : buttonFont;
+
+    // 大亂鬥時在勝利標記那一行的另一端標上玩家編號
+    if (players.size() > 2 && labelFont) {
+        char tag[16];
+        snprintf(tag, sizeof(tag), "P%d", playerIndex + 1);
+        SDL_Surface* tagSurf = TTF_RenderUTF8_Blended(labelFont, tag, {255, 255, 255, 255});
+        if (tagSurf) {
+            SDL_Texture* tagTex = SDL_CreateTextureFromSurface(renderer, tagSurf);
+            SDL_Rect tagRect = {leftSide ? healthBarX + healthBarWidth - tagSurf->w : healthBarX, winMarkY - 2, tagSurf->w, tagSurf->h};
+            SDL_RenderCopy(renderer, tagTex, NULL, &tagRect);
+            SDL_FreeSurface(tagSurf);
+            SDL_DestroyTexture(tagTex);
         }
     }
 
-    // 玩家 2 血條和勝利標記
-    if (players.size() >= 2) {
-        Player& p2 = players[1];
-        // 背景
-        SDL_Rect p2HealthBg = {SCREEN_WIDTH - 10 - healthBarWidth, healthBarY, healthBarWidth, healthBarHeight};
-        SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-        SDL_RenderFillRect(renderer, &p2HealthBg);
-        // 前景 (從右往左畫)
-        int p2FgWidth = (int)(healthBarWidth * std::max(0.0f, (float)p2.health) / PLAYER_DEFAULT_HEALTH);
-        SDL_Rect p2HealthFg = {SCREEN_WIDTH - 10 - p2FgWidth, healthBarY, p2FgWidth, healthBarHeight};
-        SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-        SDL_RenderFillRect(renderer, &p2HealthFg);
-        // 勝利標記 (金色)
-        SDL_SetRenderDrawColor(renderer, 255, 215, 0, 255);
-        for (int i = 0; i < playerWins[1]; ++i) {
-            // 從右邊開始排列
-            SDL_Rect p2Mark = {SCREEN_WIDTH - 10 - (i + 1) * (winMarkSize + winMarkSpacing) + winMarkSpacing, winMarkY, winMarkSize, winMarkSize};
-            SDL_RenderFillRect(renderer, &p2Mark);
-        }
+    int barX = leftSide ? 50 + columnOffset : SCREEN_WIDTH - 50 - barWidth - columnOffset;
+    renderCooldownBar(renderer, labelFont, barX, baseY, leftSide,
+                      player.blockCooldownTimer, BLOCK_COOLDOWN, matchTick, "Block");
+    renderCooldownBar(renderer, labelFont, barX, baseY + (barHeight + gapY), leftSide,
+                      player.attackCooldownTimer, player.getAttackCooldown(), matchTick, "Punch");
+    renderCooldownBar(renderer, labelFont, barX, baseY + (barHeight + gapY) * 2, leftSide,
+                      player.projectileCooldownTimer, PROJECTILE_COOLDOWN, matchTick, "Projectile");
+    renderCooldownBar(renderer, labelFont, barX, baseY + (barHeight + gapY) * 3, leftSide,
+                      player.specialAttackCooldownTimer, player.balance.specialAttackCooldown, matchTick, "Skill");
+}
+
+// --- 繪製回合相關資訊 (血條、勝利標記、計時器) ---
+void Game::renderRoundInfo() {
+    // --- 每位玩家的血條、勝利標記與冷卻條 ---
+    for (size_t i = 0; i < players.size() && i < MAX_PLAYERS; ++i) {
+        renderPlayerHud(static_cast<int>(i));
     }
 
     // --- 繪製回合計時器 ---
@@ -1120,7 +1174,7 @@ void Game::renderRoundInfo() {
 
     // 繪製計時器前景 (模擬時間流逝)
     if (currentGameState == GameState::PLAYING || currentGameState == GameState::PAUSED) { // 在遊戲進行中和暫停時都顯示時間條
-        float timeRatio = std::max(0.0f, roundTimer) / ROUND_TIME_LIMIT; // 時間比例 (0.0 ~ 1.0)
+        float timeRatio = roundTimer.remainingSeconds(matchTick) / ROUND_TIME_LIMIT; // 時間比例 (0.0 ~ 1.0)
         SDL_Rect timerFg = {timerPosX, timerPosY, (int)(timerMaxWidth * timeRatio), timerHeight};
         SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255); // 黃色
         SDL_RenderFillRect(renderer, &timerFg);
@@ -1144,251 +1198,13 @@ void Game::renderRoundInfo() {
         }
     }
 
-    // 顯示冷卻條（Block、Punch、Projectile）
-    if (players.size() >= 2) {
-        // 冷卻條尺寸與間距
-        int barWidth = 80;
-        int barHeight = 12;
-        int gapY = 8;
-        int baseY = 50;
-
-        // 載入小字體（只載入一次）
-        static TTF_Font* smallFont = nullptr;
-        if (!smallFont) {
-            smallFont = TTF_OpenFont("assets/fonts/msjh.ttf", 16);
-        }
-        TTF_Font* labelFont = smallFont ? smallFont : buttonFont;
-
-        // --- 玩家1（左上）---
-        int leftX = 50;
-        // Block 冷卻條
-        {
-            SDL_Rect blockBg = {leftX, baseY, barWidth, barHeight};
-            SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-            SDL_RenderFillRect(renderer, &blockBg);
-            float blockRatio = players[0].blockCooldownTimer / BLOCK_COOLDOWN;
-            if (players[0].blockCooldownTimer <= 0) {
-                SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                SDL_Rect fg = {leftX, baseY, barWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            } else {
-                int fgWidth = (int)(barWidth * blockRatio);
-                SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-                SDL_Rect fg = {leftX, baseY, fgWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            }
-            if (labelFont) {
-                SDL_Color c = {255,255,255,255};
-                SDL_Surface* txtSurf = TTF_RenderUTF8_Blended(labelFont, "Block", c);
-                SDL_Texture* txtTex = SDL_CreateTextureFromSurface(renderer, txtSurf);
-                SDL_Rect txtRect = {leftX + barWidth + 8, baseY + (barHeight-txtSurf->h)/2, txtSurf->w, txtSurf->h};
-                SDL_RenderCopy(renderer, txtTex, NULL, &txtRect);
-                SDL_FreeSurface(txtSurf);
-                SDL_DestroyTexture(txtTex);
-            }
-        }
-        // Punch 冷卻條
-        {
-            int y = baseY + barHeight + gapY;
-            SDL_Rect atkBg = {leftX, y, barWidth, barHeight};
-            SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-            SDL_RenderFillRect(renderer, &atkBg);
-            float atkRatio = players[0].attackCooldownTimer / players[0].getAttackCooldown();
-            if (players[0].attackCooldownTimer <= 0) {
-                SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                SDL_Rect fg = {leftX, y, barWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            } else {
-                int fgWidth = (int)(barWidth * atkRatio);
-                SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-                SDL_Rect fg = {leftX, y, fgWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            }
-            if (labelFont) {
-                SDL_Color c = {255,255,255,255};
-                SDL_Surface* txtSurf = TTF_RenderUTF8_Blended(labelFont, "Punch", c);
-                SDL_Texture* txtTex = SDL_CreateTextureFromSurface(renderer, txtSurf);
-                SDL_Rect txtRect = {leftX + barWidth + 8, y + (barHeight-txtSurf->h)/2, txtSurf->w, txtSurf->h};
-                SDL_RenderCopy(renderer, txtTex, NULL, &txtRect);
-                SDL_FreeSurface(txtSurf);
-                SDL_DestroyTexture(txtTex);
-            }
-        }
-        // Projectile 冷卻條
-        {
-            int y = baseY + (barHeight + gapY) * 2;
-            SDL_Rect qgBg = {leftX, y, barWidth, barHeight};
-            SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-            SDL_RenderFillRect(renderer, &qgBg);
-            float qgRatio = players[0].projectileCooldownTimer / PROJECTILE_COOLDOWN;
-            if (players[0].projectileCooldownTimer <= 0) {
-                SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                SDL_Rect fg = {leftX, y, barWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            } else {
-                int fgWidth = (int)(barWidth * qgRatio);
-                SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-                SDL_Rect fg = {leftX, y, fgWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            }
-            if (labelFont) {
-                SDL_Color c = {255,255,255,255};
-                SDL_Surface* txtSurf = TTF_RenderUTF8_Blended(labelFont, "Projectile", c);
-                SDL_Texture* txtTex = SDL_CreateTextureFromSurface(renderer, txtSurf);
-                SDL_Rect txtRect = {leftX + barWidth + 8, y + (barHeight-txtSurf->h)/2, txtSurf->w, txtSurf->h};
-                SDL_RenderCopy(renderer, txtTex, NULL, &txtRect);
-                SDL_FreeSurface(txtSurf);
-                SDL_DestroyTexture(txtTex);
-            }
-        }
-
-        // Special Attack 冷卻條
-        {
-            int y = baseY + (barHeight + gapY) * 3;
-            SDL_Rect skillBg = {leftX, y, barWidth, barHeight};
-            SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-            SDL_RenderFillRect(renderer, &skillBg);
-            float skillRatio = players[0].specialAttackCooldownTimer / SPECIAL_ATTACK_COOLDOWN;
-            if (players[0].specialAttackCooldownTimer <= 0) {
-                SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                SDL_Rect fg = {leftX, y, barWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            } else {
-                int fgWidth = (int)(barWidth * skillRatio);
-                SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-                SDL_Rect fg = {leftX, y, fgWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            }
-            if (labelFont) {
-                SDL_Color c = {255,255,255,255};
-                SDL_Surface* txtSurf = TTF_RenderUTF8_Blended(labelFont, "Skill", c);
-                SDL_Texture* txtTex = SDL_CreateTextureFromSurface(renderer, txtSurf);
-                SDL_Rect txtRect = {leftX + barWidth + 8, y + (barHeight-txtSurf->h)/2, txtSurf->w, txtSurf->h};
-                SDL_RenderCopy(renderer, txtTex, NULL, &txtRect);
-                SDL_FreeSurface(txtSurf);
-                SDL_DestroyTexture(txtTex);
-            }
-        }
-
-        // --- 玩家2（右上）---
-        int rightX = SCREEN_WIDTH - 50 - barWidth;
-        // Block 冷卻條
-        {
-            SDL_Rect blockBg = {rightX, baseY, barWidth, barHeight};
-            SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-            SDL_RenderFillRect(renderer, &blockBg);
-            float blockRatio = players[1].blockCooldownTimer / BLOCK_COOLDOWN;
-            if (players[1].blockCooldownTimer <= 0) {
-                SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                SDL_Rect fg = {rightX, baseY, barWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            } else {
-                int fgWidth = (int)(barWidth * blockRatio);
-                SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-                SDL_Rect fg = {rightX, baseY, fgWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            }
-            if (labelFont) {
-                SDL_Color c = {255,255,255,255};
-                SDL_Surface* txtSurf = TTF_RenderUTF8_Blended(labelFont, "Block", c);
-                SDL_Texture* txtTex = SDL_CreateTextureFromSurface(renderer, txtSurf);
-                SDL_Rect txtRect = {rightX - txtSurf->w - 8, baseY + (barHeight-txtSurf->h)/2, txtSurf->w, txtSurf->h};
-                SDL_RenderCopy(renderer, txtTex, NULL, &txtRect);
-                SDL_FreeSurface(txtSurf);
-                SDL_DestroyTexture(txtTex);
-            }
-        }
-        // Punch 冷卻條
-        {
-            int y = baseY + barHeight + gapY;
-            SDL_Rect atkBg = {rightX, y, barWidth, barHeight};
-            SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-            SDL_RenderFillRect(renderer, &atkBg);
-            float atkRatio = players[1].attackCooldownTimer / players[1].getAttackCooldown();
-            if (players[1].attackCooldownTimer <= 0) {
-                SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                SDL_Rect fg = {rightX, y, barWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            } else {
-                int fgWidth = (int)(barWidth * atkRatio);
-                SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-                SDL_Rect fg = {rightX, y, fgWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            }
-            if (labelFont) {
-                SDL_Color c = {255,255,255,255};
-                SDL_Surface* txtSurf = TTF_RenderUTF8_Blended(labelFont, "Punch", c);
-                SDL_Texture* txtTex = SDL_CreateTextureFromSurface(renderer, txtSurf);
-                SDL_Rect txtRect = {rightX - txtSurf->w - 8, y + (barHeight-txtSurf->h)/2, txtSurf->w, txtSurf->h};
-                SDL_RenderCopy(renderer, txtTex, NULL, &txtRect);
-                SDL_FreeSurface(txtSurf);
-                SDL_DestroyTexture(txtTex);
-            }
-        }
-        // Projectile 冷卻條
-        {
-            int y = baseY + (barHeight + gapY) * 2;
-            SDL_Rect qgBg = {rightX, y, barWidth, barHeight};
-            SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-            SDL_RenderFillRect(renderer, &qgBg);
-            float qgRatio = players[1].projectileCooldownTimer / PROJECTILE_COOLDOWN;
-            if (players[1].projectileCooldownTimer <= 0) {
-                SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                SDL_Rect fg = {rightX, y, barWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            } else {
-                int fgWidth = (int)(barWidth * qgRatio);
-                SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-                SDL_Rect fg = {rightX, y, fgWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            }
-            if (labelFont) {
-                SDL_Color c = {255,255,255,255};
-                SDL_Surface* txtSurf = TTF_RenderUTF8_Blended(labelFont, "Projectile", c);
-                SDL_Texture* txtTex = SDL_CreateTextureFromSurface(renderer, txtSurf);
-                SDL_Rect txtRect = {rightX - txtSurf->w - 8, y + (barHeight-txtSurf->h)/2, txtSurf->w, txtSurf->h};
-                SDL_RenderCopy(renderer, txtTex, NULL, &txtRect);
-                SDL_FreeSurface(txtSurf);
-                SDL_DestroyTexture(txtTex);
-            }
-        }
-
-        // Special Attack 冷卻條
-        {
-            int y = baseY + (barHeight + gapY) * 3;
-            SDL_Rect skillBg = {rightX, y, barWidth, barHeight};
-            SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-            SDL_RenderFillRect(renderer, &skillBg);
-            float skillRatio = players[1].specialAttackCooldownTimer / SPECIAL_ATTACK_COOLDOWN;
-            if (players[1].specialAttackCooldownTimer <= 0) {
-                SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                SDL_Rect fg = {rightX, y, barWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            } else {
-                int fgWidth = (int)(barWidth * skillRatio);
-                SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-                SDL_Rect fg = {rightX, y, fgWidth, barHeight};
-                SDL_RenderFillRect(renderer, &fg);
-            }
-            if (labelFont) {
-                SDL_Color c = {255,255,255,255};
-                SDL_Surface* txtSurf = TTF_RenderUTF8_Blended(labelFont, "Skill", c);
-                SDL_Texture* txtTex = SDL_CreateTextureFromSurface(renderer, txtSurf);
-                SDL_Rect txtRect = {rightX - txtSurf->w - 8, y + (barHeight-txtSurf->h)/2, txtSurf->w, txtSurf->h};
-                SDL_RenderCopy(renderer, txtTex, NULL, &txtRect);
-                SDL_FreeSurface(txtSurf);
-                SDL_DestroyTexture(txtTex);
-            }
-        }
-    }
-
     // --- 混亂模式冷卻條 ---
     if (isChaosMode && currentGameState == GameState::PLAYING) {
         int chaosBarWidth = 80;
         int chaosBarHeight = 10;
         int chaosBarX = SCREEN_WIDTH / 2 - chaosBarWidth / 2;
         int chaosBarY = timerPosY + timerHeight + 8; // 在回合計時條下方
-        float ratio = std::min(1.0f, std::max(0.0f, chaosEventTimer / 15.0f));
+        float ratio = chaos.nextEventRatio(matchTick);
         SDL_SetRenderDrawColor(renderer, 80, 80, 80, 255);
         SDL_Rect bg = {chaosBarX, chaosBarY, chaosBarWidth, chaosBarHeight};
         SDL_RenderFillRect(renderer, &bg);
@@ -1400,9 +1216,16 @@ void Game::renderRoundInfo() {
 }
 
 void Game::update(float deltaTime) {
-    // 更新選單冷卻計時器
-    if (menuCooldownTimer > 0.0f) {
-        menuCooldownTimer -= deltaTime;
+    // 觀看重播時由重播驅動模擬
+    if (isReplayPlayback) {
+        updateReplayPlayback();
+        return;
+    }
+
+    // 連線對戰由 updateNetplay 驅動 (包含回滾與等待對手)
+    if (netSession) {
+        updateNetplay();
+        return;
     }
 
     // 根據遊戲狀態更新
@@ -1414,27 +1237,161 @@ void Game::update(float deltaTime) {
             // 拳套選擇狀態不需要特殊更新
             break;
         case GameState::PLAYING:
-            // 檢查玩家是否死亡 (移到最前面，優先處理)
-            for (size_t i = 0; i < players.size(); ++i) {
-                if (players[i].health <= 0 && players[i].state == Player::PlayerState::DEATH) {
-                    printf("Player %zu died, ending round...\n", i + 1);
-                    endRound(1 - i); // 對手獲勝
+        case GameState::ROUND_OVER:
+            // 大亂鬥：P3 之後的玩家由腳本 AI 決定這個 tick 的按鍵 (跟真人輸入一起記進重播)
+            for (size_t i = 2; i < players.size() && i - 2 < freeForAllAIs.size(); ++i) {
+                currentInput.buttons[i] = freeForAllAIs[i - 2].decide(*this, static_cast<int>(i));
+            }
+            // 錄製重播：先存關鍵幀 (模擬前的狀態)，再記錄本 tick 的輸入
+            if (isRecordingReplay) {
+                if (replay.needsKeyframe()) {
+                    MatchSnapshot snapshot;
+                    captureSnapshot(snapshot);
+                    replay.addKeyframe(snapshot);
+                }
+                replay.addInput(currentInput);
+            }
+            simulateMatchTick(currentInput, deltaTime);
+            stateHashLog.record(stateHashScratch, stateHash);
+            // 比賽結束就停止錄製
+            if (isRecordingReplay && currentGameState == GameState::MATCH_OVER) {
+                isRecordingReplay = false;
+                replay.printStats();
+                stateHashLog.endRecording();
+                printStateHashStats();
+            }
+            break;
+
+        case GameState::MATCH_OVER:
+            // 在比賽結束狀態下，只更新玩家的動畫
+            for (Player& player : players) {
+                player.update(deltaTime);
+            }
+            break;
+
+        case GameState::PAUSED:
+            // 暫停狀態下不更新遊戲邏輯
+            break;
+
+        case GameState::START_SCREEN:
+        case GameState::ROUND_STARTING:
+        case GameState::CHARACTER_INFO:
+            // 這些狀態不需要更新遊戲邏輯
+            break;
+    }
+}
+
+void Game::simulateMatchTick(const TickInput& input, float deltaTime) {
+    gameEvents.clear();
+    advanceMatchState(input, deltaTime);
+    // 每個 tick 結束都更新狀態雜湊 (重播/連線對戰用來偵測不同步)
+    ++matchTick;
+    stateHash = computeStateHash();
+    // 模擬與雜湊都完成後才處理音效、特效、記錄等副作用
+    dispatchGameEvents();
+}
+
+void Game::dispatchGameEvents() {
+    Uint32 consumers = gameEventConsumers & (isHeadless ? EVENT_CONSUMERS_HEADLESS : EVENT_CONSUMERS_ALL);
+    if (consumers == 0 || gameEvents.size() == 0) return;
+    if (consumers & EVENT_CONSUMER_STATS) gameEventStats.add(gameEvents);
+    for (int i = 0; i < gameEvents.size(); ++i) {
+        const GameEvent& event = gameEvents[i];
+        if (consumers & EVENT_CONSUMER_LOG) logGameEvent(event);
+        if (consumers & EVENT_CONSUMER_AUDIO) playEventSound(event);
+        if ((consumers & EVENT_CONSUMER_EFFECTS) &&
+            (event.type == GameEventType::HIT || event.type == GameEventType::BLOCK)) {
+            world.spawnHitSparks(event.x, event.y, event.direction, event.type == GameEventType::BLOCK, event.tick);
+        }
+        // 在整場比賽結束時保存記錄 (觀看重播時不保存)
+        if ((consumers & EVENT_CONSUMER_RECORDS) && event.type == GameEventType::MATCH_END && !isReplayPlayback) {
+            saveGameRecord();
+        }
+    }
+}
+
+void Game::playEventSound(const GameEvent& event) {
+    const Player* player = (event.player >= 0 && event.player < static_cast<int>(players.size())) ? &players[event.player] : nullptr;
+    switch (event.type) {
+        case GameEventType::JUMP:
+            AudioManager::playRandomSound("jump");
+            break;
+        case GameEventType::PROJECTILE_SPAWN:
+            if (player) AudioManager::playRandomSound(player->getTraits().fireSound); // 氣功洪水沒有音效
+            break;
+        case GameEventType::HIT:
+            if (player && event.value > 0 && event.health > 0) AudioManager::playRandomSound(player->getTraits().hurtSound);
+            break;
+        case GameEventType::KO:
+            if (player) AudioManager::playRandomSound(player->getTraits().deathSound);
+            break;
+        case GameEventType::ROUND_END:
+            if (!player) AudioManager::playSound("draw_sfx"); // 平手
+            break;
+        case GameEventType::MATCH_END:
+            if (player) AudioManager::playRandomSound(player->getTraits().victorySound, -1);
+            AudioManager::stopMusic(); // 停止 BGM
+            break;
+        default:
+            break;
+    }
+}
+
+void Game::logGameEvent(const GameEvent& event) {
+    switch (event.type) {
+        case GameEventType::PROJECTILE_SPAWN:
+            if (event.player >= 0) {
+                DEBUG_LOG("Spawned projectile for player %d at (%.1f, %.1f) facing %d\n", event.player, event.x, event.y, event.direction);
+            }
+            break;
+        case GameEventType::KO:
+        case GameEventType::ROUND_END:
+        case GameEventType::MATCH_END:
+        case GameEventType::CHAOS_EVENT:
+            DEBUG_LOG("Event %s at tick %u: player %d, value %d\n", gameEventName(event.type), event.tick, event.player, event.value);
+            break;
+        default:
+            break;
+    }
+}
+
+void Game::advanceMatchState(const TickInput& input, float deltaTime) {
+    switch (currentGameState) {
+        case GameState::PLAYING:
+            // 先把本 tick 的輸入轉成玩家動作
+            applyPlayerInputs(input);
+
+            // 檢查玩家是否死亡 (移到最前面，優先處理)：只剩一人 (或沒有人) 還站著時回合結束
+            {
+                int survivor = -1;
+                int survivorCount = 0;
+                for (size_t i = 0; i < players.size(); ++i) {
+                    if (players[i].health <= 0 && players[i].state == Player::PlayerState::DEATH) continue;
+                    survivor = static_cast<int>(i);
+                    ++survivorCount;
+                }
+                if (players.size() >= 2 && survivorCount <= 1) {
+                    DEBUG_LOG("%d player(s) left standing, ending round...\n", survivorCount);
+                    endRound(survivorCount == 1 ? survivor : -1); // 最後站著的人獲勝
                     return; // 立即返回，不執行其他更新
                 }
             }
 
-            // 更新回合計時器
-            roundTimer -= deltaTime;
-            if (roundTimer <= 0) {
-                // 時間到，判斷血量決定勝負
+            // 回合時間到 (計時器只記錄到期的 tick)
+            if (!roundTimer.isActive(matchTick)) {
+                // 時間到，血量最高的人獲勝，最高血量有兩人以上時平手
                 if (players.size() >= 2) {
-                    if (players[0].health > players[1].health) {
-                        endRound(0); // P1 勝
-                    } else if (players[1].health > players[0].health) {
-                        endRound(1); // P2 勝
-                    } else {
-                        endRound(-1); // 平手
+                    int leader = 0;
+                    bool tied = false;
+                    for (size_t i = 1; i < players.size(); ++i) {
+                        if (players[i].health > players[leader].health) {
+                            leader = static_cast<int>(i);
+                            tied = false;
+                        } else if (players[i].health == players[leader].health) {
+                            tied = true;
+                        }
                     }
+                    endRound(tied ? -1 : leader);
                 }
             }
 
@@ -1450,74 +1407,27 @@ void Game::update(float deltaTime) {
                 }
             }
 
-            // 更新氣功
-            for (Projectile& proj : projectiles) {
-                if (proj.isActive) {
-                    proj.x += proj.vx * deltaTime;
-                    
-                    // 檢查是否超出畫面
-                    if (proj.x < -PROJECTILE_HITBOX_W || proj.x > SCREEN_WIDTH) {
-                        proj.isActive = false;
-                    }
-                }
+            // 混亂模式的氣功洪水
+            if (chaos.modifiers().projectileStorm > 0) {
+                spawnChaosFlood();
             }
 
-            // 檢查氣功碰撞
-            for (Projectile& proj : projectiles) {
-                if (!proj.isActive) continue;
-
-                for (size_t i = 0; i < players.size(); ++i) {
-                    if (i == static_cast<size_t>(proj.ownerPlayerIndex)) continue; // 跳過發射者
-                    if (!players[i].isAlive()) continue; // 跳過已死亡的玩家
-
-                    // 檢查碰撞
-                    if (this->checkProjectilePlayerCollision(proj, players[i])) {
-                        proj.isActive = false; // 氣功消失
-                        break;
-                    }
-                }
-            }
+            // 更新氣功與特效粒子 (整批移動，飛出畫面或壽命到期的標記為失效)
+            world.integrate(deltaTime, matchTick);
 
-            // 檢查玩家之間的碰撞
-            if (players.size() >= 2) {
-                this->checkPlayerCollision(players[0], players[1]);
-            }
+            // 氣功命中與玩家之間的碰撞 (先用 broadphase 找出候選配對)
+            resolveCollisions(deltaTime);
+            world.removeInactive(); // 飛出畫面、命中或到期的實體從各自的 archetype 移除
 
-            // --- 混亂模式事件觸發 ---
+            // --- 混亂模式：到期的效果還原、時間到就觸發下一個事件 ---
             if (isChaosMode) {
-                chaosEventTimer -= deltaTime;
-                if (chaosEventTimer <= 0.0f) {
-                    int eventType = rand() % 2;
-                    if (eventType == 0) {
-                        chaosEvent = ChaosEventType::CONTROL_REVERSE;
-                    } else {
-                        chaosEvent = ChaosEventType::HP_SWAP;
-                        // 立即執行血條交換
-                        if (players.size() >= 2) {
-                            float p1Percent = players[0].health / PLAYER_DEFAULT_HEALTH;
-                            float p2Percent = players[1].health / PLAYER_DEFAULT_HEALTH;
-                            int p1New = (int)(p2Percent * PLAYER_DEFAULT_HEALTH);
-                            int p2New = (int)(p1Percent * PLAYER_DEFAULT_HEALTH);
-                            players[0].health = p1New;
-                            players[1].health = p2New;
-                        }
-                    }
-                    chaosEventTimer = 15.0f;
-                    chaosEventShowTimer = 3.0f;
-                    chaosBgIndex = 1 - chaosBgIndex; // 交替背景
-                }
-                // 混亂事件名稱顯示倒數
-                if (chaosEventShowTimer > 0.0f) {
-                    chaosEventShowTimer -= deltaTime;
-                    if (chaosEventShowTimer < 0.0f) chaosEventShowTimer = 0.0f;
-                }
+                chaos.update(*this, matchTick);
             }
             break;
 
         case GameState::ROUND_OVER:
-            // 更新回合結束計時器
-            roundOverTimer -= deltaTime;
-            if (roundOverTimer <= 0) {
+            // 等待回合結束計時器到期
+            if (!roundOverTimer.isActive(matchTick)) {
                 checkForMatchWinner(); // 檢查是否有比賽勝利者
                 if (currentGameState != GameState::MATCH_OVER) {
                     startNewRound(); // 開始新回合
@@ -1525,108 +1435,222 @@ void Game::update(float deltaTime) {
             }
             break;
 
-        case GameState::MATCH_OVER:
-            // 在比賽結束狀態下，只更新玩家的動畫
-            for (Player& player : players) {
-                player.update(deltaTime);
-            }
+        default:
             break;
+    }
+}
 
-        case GameState::PAUSED:
-            // 暫停狀態下不更新遊戲邏輯
-            break;
+// 玩家的邏輯身體 (推擠與氣功命中使用，寬高固定為 PLAYER_LOGIC_WIDTH/HEIGHT)
+static BroadphaseProxy makeBodyProxy(const Player& player, int index) {
+    BroadphaseProxy proxy;
+    proxy.left = player.x;
+    proxy.top = player.y;
+    proxy.right = player.x + PLAYER_LOGIC_WIDTH;
+    proxy.bottom = player.y + PLAYER_LOGIC_HEIGHT;
+    proxy.dx = player.x - player.prevX;
+    proxy.dy = player.y - player.prevY;
+    proxy.kind = BROADPHASE_BODY;
+    proxy.owner = index;
+    proxy.index = index;
+    return proxy;
+}
 
-        case GameState::START_SCREEN:
-        case GameState::ROUND_STARTING:
-        case GameState::CHARACTER_INFO:
-            // 這些狀態不需要更新遊戲邏輯
-            break;
-    }
+// 受擊框/攻擊框跟著玩家移動，位移與玩家本身相同
+static BroadphaseProxy makeRectProxy(const SDL_Rect& rect, const Player& player, Uint8 kind, int index) {
+    BroadphaseProxy proxy;
+    proxy.left = static_cast<float>(rect.x);
+    proxy.top = static_cast<float>(rect.y);
+    proxy.right = static_cast<float>(rect.x + rect.w);
+    proxy.bottom = static_cast<float>(rect.y + rect.h);
+    proxy.dx = player.x - player.prevX;
+    proxy.dy = player.y - player.prevY;
+    proxy.kind = kind;
+    proxy.owner = index;
+    proxy.index = index;
+    return proxy;
 }
 
-bool Game::checkProjectilePlayerCollision(const Projectile& proj, Player& player) {
-    // 躺下時不會被氣功打到
-    if (player.state == Player::PlayerState::LYING) return false;
-    if (!proj.isActive || !player.isAlive()) return false;
+// 依碰撞時間排序，同時發生時依配對順序 (玩家索引/氣功在池中的順序)
+static bool contactBefore(const BroadphasePair& a, const BroadphasePair& b) {
+    if (a.toi != b.toi) return a.toi < b.toi;
+    return a.first != b.first ? a.first < b.first : a.second < b.second;
+}
 
-    // 檢查氣功和玩家的碰撞
-    if (!proj.isActive || !player.isAlive()) return false;
+void Game::resolveCollisions(float deltaTime) {
+    // 每位玩家最多放進 3 個物件 (身體、受擊框、攻擊框)，改動下面的迴圈時要一起更新
+    const int proxiesPerPlayer = 3;
+    static_assert(MAX_PLAYERS * proxiesPerPlayer <= BROADPHASE_PLAYER_HEADROOM,
+                  "broadphase headroom must hold every player's proxies next to a full projectile pool");
+    // --- broadphase：把這個 tick 的所有碰撞物件放進格子 ---
+    broadphase.clear();
+    for (size_t i = 0; i < players.size(); ++i) {
+        const Player& player = players[i];
+        broadphase.insert(makeBodyProxy(player, static_cast<int>(i)));
+        broadphase.insert(makeRectProxy(player.getBoundingBox(), player, BROADPHASE_HURTBOX, static_cast<int>(i)));
+        SDL_Rect hitbox = player.getHitboxWorld();
+        if (player.state == Player::PlayerState::ATTACKING && hitbox.w > 0) {
+            broadphase.insert(makeRectProxy(hitbox, player, BROADPHASE_ATTACK, static_cast<int>(i)));
+        }
+    }
+    // 池裡的氣功在 tick 開始時都是有效的 (失效的在上個 tick 結束時已移除)，
+    // 這個 tick 才飛出畫面的氣功也要測試它掃過的路徑
+    for (int i = 0; i < world.projectiles.size(); ++i) {
+        const Projectile proj = world.projectiles.get(i);
+        BroadphaseProxy proxy;
+        proxy.left = proj.x;
+        proxy.top = proj.y;
+        proxy.right = proj.x + PROJECTILE_HITBOX_W;
+        proxy.bottom = proj.y + PROJECTILE_HITBOX_H;
+        proxy.dx = proj.vx * deltaTime;
+        proxy.kind = BROADPHASE_PROJECTILE;
+        proxy.owner = proj.ownerPlayerIndex;
+        proxy.index = i;
+        if (broadphase.insert(proxy) < 0) {
+            DEBUG_LOG("Broadphase full (%d), %d projectile(s) skip collision this tick\n",
+                      broadphase.size(), world.projectiles.size() - i);
+            break;
+        }
+    }
+    broadphase.findPairs(collisionPairs);
+
+    // --- narrowphase：掃掠 AABB 求出碰撞時間，命中依時間先後結算 ---
+    // 精確判定一律讀玩家目前的狀態，因為較早的命中可能已經把玩家打倒或擊倒在地。
+    collisionContacts.clear();
+    for (const BroadphasePair& pair : collisionPairs) {
+        const BroadphaseProxy& first = broadphase.getProxy(pair.first);
+        if (first.kind == BROADPHASE_BODY) continue; // 推擠只看結束位置
+        BroadphasePair contact = pair;
+        if (sweepProxies(first, broadphase.getProxy(pair.second), contact.toi)) {
+            collisionContacts.push_back(contact);
+        }
+    }
+    std::sort(collisionContacts.begin(), collisionContacts.end(), contactBefore);
+
+    // 1. 氣功命中 (每個氣功最多命中一人)
+    shotConsumed.assign(world.projectiles.size(), 0);
+    for (const BroadphasePair& contact : collisionContacts) {
+        const BroadphaseProxy& shot = broadphase.getProxy(contact.first);
+        if (shot.kind != BROADPHASE_PROJECTILE || shotConsumed[shot.index]) continue;
+        Player& player = players[broadphase.getProxy(contact.second).index];
+        if (!player.isAlive()) continue; // 跳過已死亡的玩家
+        if (player.state == Player::PlayerState::LYING) continue; // 躺下時不會被氣功打到
+        int shotDirection = shot.dx >= 0.0f ? 1 : -1;
+        bool blocked = player.state == Player::PlayerState::BLOCKING;
+        int healthBefore = player.health;
+        applyProjectileHit(player);
+        recordHit(broadphase.getProxy(contact.second).index, shot.owner, healthBefore,
+                  player.x + player.logicWidth / 2.0f - shotDirection * player.logicWidth / 4.0f,
+                  (shot.top + shot.bottom) / 2.0f, blocked ? -shotDirection : shotDirection, blocked);
+        shotConsumed[shot.index] = 1;
+        world.projectiles.deactivate(shot.index); // 氣功消失
+    }
 
-    // 簡單的矩形碰撞檢測
-    float projLeft = proj.x;
-    float projRight = proj.x + PROJECTILE_HITBOX_W;
-    float projTop = proj.y;
-    float projBottom = proj.y + PROJECTILE_HITBOX_H;
+    // 近身攻擊與推擠只發生在氣功結算後仍然存活的玩家之間
+    Uint32 aliveMask = 0;
+    for (size_t i = 0; i < players.size() && i < 32; ++i) {
+        if (players[i].isAlive()) aliveMask |= 1u << i;
+    }
+    // 2. 近身攻擊
+    for (const BroadphasePair& contact : collisionContacts) {
+        const BroadphaseProxy& attack = broadphase.getProxy(contact.first);
+        if (attack.kind != BROADPHASE_ATTACK) continue;
+        int target = broadphase.getProxy(contact.second).index;
+        if (!(aliveMask & (1u << attack.index)) || !(aliveMask & (1u << target))) continue;
+        resolveMeleeHit(players[attack.index], players[target], contact.toi);
+    }
+    // 3. 防止玩家重疊
+    for (const BroadphasePair& pair : collisionPairs) {
+        const BroadphaseProxy& a = broadphase.getProxy(pair.first);
+        const BroadphaseProxy& b = broadphase.getProxy(pair.second);
+        if (a.kind != BROADPHASE_BODY || b.kind != BROADPHASE_BODY) continue;
+        if (!(aliveMask & (1u << a.index)) || !(aliveMask & (1u << b.index))) continue;
+        separatePlayers(players[a.index], players[b.index]);
+    }
+}
 
-    float playerLeft = player.x;
-    float playerRight = player.x + PLAYER_LOGIC_WIDTH;
-    float playerTop = player.y;
-    float playerBottom = player.y + PLAYER_LOGIC_HEIGHT;
+void Game::applyProjectileHit(Player& player) {
+    // 如果玩家正在格擋，則不受傷害 (氣功仍然消失)
+    if (player.state == Player::PlayerState::BLOCKING) {
+        return;
+    }
 
-    // 檢查是否發生碰撞
-    if (projRight > playerLeft && projLeft < playerRight &&
-        projBottom > playerTop && projTop < playerBottom) {
-        
-        // 如果玩家正在格擋，則不受傷害
-        if (player.state == Player::PlayerState::BLOCKING) {
-            return true; // 氣功消失，但玩家不受傷害
-        }
+    // 造成傷害
+    player.takeDamage(balance.projectileDamage);
+}
 
-        // 造成傷害
-        player.takeDamage(PROJECTILE_DAMAGE);
-        return true;
-    }
-
-    return false;
-}
-
-void Game::checkPlayerCollision(Player& p1, Player& p2) {
-    if (!p1.isAlive() || !p2.isAlive()) return;
-    SDL_Rect p1Hitbox = p1.getHitboxWorld();
-    SDL_Rect p2Hitbox = p2.getHitboxWorld();
-    // 玩家1攻擊
-    if (p1.state == Player::PlayerState::ATTACKING && p1Hitbox.w > 0) {
-        SDL_Rect p2Box = p2.getBoundingBox();
-        if (p1Hitbox.x < p2Box.x + p2Box.w &&
-            p1Hitbox.x + p1Hitbox.w > p2Box.x &&
-            p1Hitbox.y < p2Box.y + p2Box.h &&
-            p1Hitbox.y + p1Hitbox.h > p2Box.y) {
-            if (p2.state != Player::PlayerState::BLOCKING) {
-                // Godon 衝刺技能
-                if (p1.characterId == "Godon" && p1.isSpecialAttacking && !p1.hasHitDuringDash) {
-                    p2.takeDamage(20);
-                    p1.hasHitDuringDash = true;
-                    p1.vx = 0; // 立即停止衝刺
-                    p1.isSpecialAttacking = false;
-                    p1.attackTimer = 0; // 立即結束攻擊狀態
-                } else if (!p1.isSpecialAttacking) {
-                    p2.takeDamage(p1.getAttackDamage());
-                }
-            }
+void Game::resolveMeleeHit(Player& attacker, Player& target, float toi) {
+    // 碰撞時間較早的命中可能已經打斷這次攻擊
+    if (attacker.state != Player::PlayerState::ATTACKING || attacker.getHitboxWorld().w <= 0) return;
+    int attackerIndex = static_cast<int>(&attacker - &players[0]);
+    int targetIndex = static_cast<int>(&target - &players[0]);
+    float sparkX = target.x + target.logicWidth / 2.0f - attacker.direction * target.logicWidth / 4.0f;
+    float sparkY = target.y + target.logicHeight / 3.0f;
+    int healthBefore = target.health;
+    if (target.state == Player::PlayerState::BLOCKING) {
+        // 攻擊框重疊的每個 tick 都會進來，同一次攻擊對同一人只記一次格擋
+        if (!(attacker.blockedByMask & (1u << targetIndex))) {
+            attacker.blockedByMask |= 1u << targetIndex;
+            recordHit(targetIndex, attackerIndex, healthBefore, sparkX, sparkY, -attacker.direction, true);
         }
+        return;
     }
-    // 玩家2攻擊
-    if (p2.state == Player::PlayerState::ATTACKING && p2Hitbox.w > 0) {
-        SDL_Rect p1Box = p1.getBoundingBox();
-        if (p2Hitbox.x < p1Box.x + p1Box.w &&
-            p2Hitbox.x + p2Hitbox.w > p1Box.x &&
-            p2Hitbox.y < p1Box.y + p1Box.h &&
-            p2Hitbox.y + p2Hitbox.h > p1Box.y) {
-            if (p1.state != Player::PlayerState::BLOCKING) {
-                // Godon 衝刺技能
-                if (p2.characterId == "Godon" && p2.isSpecialAttacking && !p2.hasHitDuringDash) {
-                    p1.takeDamage(20);
-                    p2.hasHitDuringDash = true;
-                    p2.vx = 0; // 立即停止衝刺
-                    p2.isSpecialAttacking = false;
-                    p2.attackTimer = 0; // 立即結束攻擊狀態
-                } else if (!p2.isSpecialAttacking) {
-                    p1.takeDamage(p2.getAttackDamage());
-                }
-            }
+    if (attacker.isSpecialAttacking && (attacker.getTraits().specialAttack != SpecialAttackType::DASH || attacker.hasHitDuringDash)) {
+        return; // 技能期間的一般攻擊框不造成傷害
+    }
+    // 衝刺技能
+    if (attacker.getTraits().specialAttack == SpecialAttackType::DASH && attacker.isSpecialAttacking && !attacker.hasHitDuringDash) {
+        target.takeDamage(attacker.getTraits().dashDamage);
+        attacker.hasHitDuringDash = true;
+        attacker.x = attacker.prevX + (attacker.x - attacker.prevX) * toi; // 停在撞到的位置
+        attacker.vx = 0; // 立即停止衝刺
+        attacker.isSpecialAttacking = false;
+        attacker.attackTimer.clear(); // 立即結束攻擊狀態
+    } else if (!attacker.isSpecialAttacking) {
+        target.takeDamage(attacker.getAttackDamage());
+    }
+    recordHit(targetIndex, attackerIndex, healthBefore, sparkX, sparkY, attacker.direction, false);
+}
+
+int Game::findNearestOpponent(int playerIndex) const {
+    // 優先找還活著的對手；都倒下了就回傳最近的一位 (兩人對戰時永遠是另一位)
+    int nearest = -1;
+    bool nearestAlive = false;
+    float nearestDistance = 0.0f;
+    const Player& self = players[playerIndex];
+    float selfCenter = self.x + self.logicWidth / 2.0f;
+    for (size_t i = 0; i < players.size(); ++i) {
+        if (static_cast<int>(i) == playerIndex) continue;
+        const Player& other = players[i];
+        float distance = std::fabs(other.x + other.logicWidth / 2.0f - selfCenter);
+        bool alive = other.isAlive();
+        if (nearest < 0 || (alive && !nearestAlive) || (alive == nearestAlive && distance < nearestDistance)) {
+            nearest = static_cast<int>(i);
+            nearestAlive = alive;
+            nearestDistance = distance;
         }
     }
-    // 防止玩家重疊
+    return nearest;
+}
+
+void Game::recordHit(int target, int source, int healthBefore, float x, float y, int direction, bool blocked) {
+    const Player& player = players[target];
+    // 無敵時間內的接觸不造成傷害，不算命中 (不產生火花也不計入統計)
+    if (!blocked && healthBefore - player.health <= 0) return;
+    GameEvent event = makeGameEvent(blocked ? GameEventType::BLOCK : GameEventType::HIT, matchTick, target);
+    event.source = static_cast<Sint8>(source);
+    event.direction = static_cast<Sint8>(direction);
+    event.value = static_cast<Sint16>(healthBefore - player.health);
+    event.health = static_cast<Sint16>(player.health);
+    event.x = x;
+    event.y = y;
+    gameEvents.push(event);
+    if (healthBefore > 0 && player.health <= 0) {
+        event.type = GameEventType::KO;
+        gameEvents.push(event);
+    }
+}
+
+void Game::separatePlayers(Player& p1, Player& p2) {
     float p1Right = p1.x + PLAYER_LOGIC_WIDTH;
     float p2Left = p2.x;
     float p1Left = p1.x;
@@ -1642,7 +1666,13 @@ void Game::checkPlayerCollision(Player& p1, Player& p2) {
 }
 
 void Game::handleGloveSelection() {
-    // 已廢棄，保留空函數避免連結錯誤
+    menuInput.update(SDL_GetTicks());
+    for (int i = 0; i < 2; ++i) {
+        int steps = menuInput.takeSteps(i);
+        if (steps == 0 || gloveSelectionConfirmed[i]) continue;
+        selectedGloveIndex[i] = ((selectedGloveIndex[i] + steps) % 3 + 3) % 3;
+        printf("Player %d selected glove %d\n", i + 1, selectedGloveIndex[i]);
+    }
 }
 
 void Game::renderGloveSelection() {
@@ -1783,16 +1813,23 @@ void Game::renderGloveSelection() {
 void Game::startGameAfterGloveSelection() {
     // 重置所有遊戲數據
     currentRound = 1;
-    playerWins[0] = 0;
-    playerWins[1] = 0;
-    roundTimer = ROUND_DURATION;
-    roundOverTimer = 0.0f;
+    for (int i = 0; i < MAX_PLAYERS; ++i) playerWins[i] = 0;
     roundWinnerIndex = -1;
     isPaused = false;
-
-    // 設置玩家的拳套
-    players[0].setGlove(static_cast<Player::GloveType>(selectedGloveIndex[0]));
-    players[1].setGlove(static_cast<Player::GloveType>(selectedGloveIndex[1]));
+    matchTick = 0; // 模擬時鐘歸零，所有計時器都以新的時鐘重新啟動
+    roundOverTimer.clear();
+
+    // 設置玩家的拳套 (大亂鬥的 P3、P4 沿用 P1、P2 的選擇)
+    for (size_t i = 0; i < players.size(); ++i) {
+        players[i].setGlove(static_cast<Player::GloveType>(selectedGloveIndex[i % 2]));
+        // 時鐘歸零後，上一場留下的到期 tick 已經沒有意義 (其他計時器在 resetPlayersForRound 清除)
+        players[i].specialAttackCooldownTimer.clear();
+    }
+    // P3 之後的腳本 AI 每場重新開始 (種子固定，同樣的輸入得到同樣的比賽)
+    freeForAllAIs.clear();
+    for (size_t i = 2; i < players.size(); ++i) {
+        freeForAllAIs.emplace_back(static_cast<Uint32>(i) * 7919u);
+    }
 
     // 重置選擇狀態
     gloveSelectionConfirmed[0] = false;
@@ -1801,63 +1838,25 @@ void Game::startGameAfterGloveSelection() {
     // 開始遊戲
     currentGameState = GameState::PLAYING;
     startNewRound();
+
+    // 混亂事件亂數種子 (xorshift 的狀態不能是 0)
+    chaos.seed(static_cast<Uint32>(time(0)));
+    currentInput = TickInput();
+    stateHashCounterTotal = 0;
+    stateHashSamples = 0;
+    if (!isHeadless) {
+        beginReplayRecording();
+    }
+    stateHashLog.beginRecording();
 }
 
 void Game::handleCharacterSelection() {
-    SDL_Event event;
-    while (SDL_PollEvent(&event)) {
-        if (event.type == SDL_KEYDOWN) {
-            // 玩家1控制 (W/S)
-            if (!characterSelectionConfirmed[0]) {
-                if (event.key.keysym.sym == SDLK_w) {
-                    selectedCharacterIndex[0] = (selectedCharacterIndex[0] - 1 + 2) % 2;
-                    SDL_Delay(200);
-                    printf("Player 1 selected character %d\n", selectedCharacterIndex[0]);
-                } else if (event.key.keysym.sym == SDLK_s) {
-                    selectedCharacterIndex[0] = (selectedCharacterIndex[0] + 1) % 2;
-                    SDL_Delay(200);
-                    printf("Player 1 selected character %d\n", selectedCharacterIndex[0]);
-                } else if (event.key.keysym.sym == SDLK_RETURN && !event.key.repeat) {
-                    characterSelectionConfirmed[0] = true;
-                    printf("Player 1 confirmed character selection\n");
-                }
-            }
-
-            // 玩家2控制 (上下方向鍵)
-            if (!characterSelectionConfirmed[1]) {
-                if (event.key.keysym.sym == SDLK_UP) {
-                    selectedCharacterIndex[1] = (selectedCharacterIndex[1] - 1 + 2) % 2;
-                    SDL_Delay(200);
-                    printf("Player 2 selected character %d\n", selectedCharacterIndex[1]);
-                } else if (event.key.keysym.sym == SDLK_DOWN) {
-                    selectedCharacterIndex[1] = (selectedCharacterIndex[1] + 1) % 2;
-                    SDL_Delay(200);
-                    printf("Player 2 selected character %d\n", selectedCharacterIndex[1]);
-                } else if (event.key.keysym.sym == SDLK_KP_ENTER && !event.key.repeat) {
-                    characterSelectionConfirmed[1] = true;
-                    printf("Player 2 confirmed character selection\n");
-                }
-            }
-
-            // 如果兩個玩家都確認了選擇，進入拳套選擇階段
-            if (characterSelectionConfirmed[0] && characterSelectionConfirmed[1]) {
-                // 先重置所有選擇狀態
-                selectedGloveIndex[0] = 0;
-                selectedGloveIndex[1] = 0;
-                gloveSelectionConfirmed[0] = false;
-                gloveSelectionConfirmed[1] = false;
-                
-                // 清除所有按鍵事件
-                SDL_FlushEvents(SDL_KEYDOWN, SDL_KEYUP);
-                
-                // 添加延遲
-                SDL_Delay(200);
-                
-                // 進入拳套選擇階段
-                startGameAfterCharacterSelection();
-                return; // 立即返回，避免處理其他事件
-            }
-        }
+    menuInput.update(SDL_GetTicks());
+    for (int i = 0; i < 2; ++i) {
+        int steps = menuInput.takeSteps(i);
+        if (steps == 0 || characterSelectionConfirmed[i]) continue;
+        selectedCharacterIndex[i] = ((selectedCharacterIndex[i] + steps) % CHARACTER_COUNT + CHARACTER_COUNT) % CHARACTER_COUNT;
+        printf("Player %d selected character %d\n", i + 1, selectedCharacterIndex[i]);
     }
 }
 
@@ -1995,28 +1994,17 @@ void Game::renderCharacterSelection() {
 }
 
 void Game::startGameAfterCharacterSelection() {
-    // 清除所有按鍵狀態
+    // 清除所有按鍵狀態 (選角時按住的方向鍵不會在拳套選擇畫面繼續重複)
     SDL_FlushEvents(SDL_KEYDOWN, SDL_KEYUP);
-    
-    // 添加延遲
-    SDL_Delay(200);
-
-    // 根據選擇的角色創建玩家
-    players.clear();
-    
-    // 玩家1
-    if (selectedCharacterIndex[0] == 0) {
-        players.emplace_back(100.0f, GROUND_LEVEL - PLAYER_LOGIC_HEIGHT, 1, "BlockMan", "blockman_sprites");
-    } else {
-        players.emplace_back(100.0f, GROUND_LEVEL - PLAYER_LOGIC_HEIGHT, 1, "Godon", "godon_sprites");
-    }
+    menuInput.reset();
 
-    // 玩家2
-    if (selectedCharacterIndex[1] == 0) {
-        players.emplace_back(SCREEN_WIDTH - 100.0f - PLAYER_LOGIC_WIDTH, GROUND_LEVEL - PLAYER_LOGIC_HEIGHT, -1, "BlockMan", "blockman_sprites");
-    } else {
-        players.emplace_back(SCREEN_WIDTH - 100.0f - PLAYER_LOGIC_WIDTH, GROUND_LEVEL - PLAYER_LOGIC_HEIGHT, -1, "Godon", "godon_sprites");
+    // 根據選擇的角色創建玩家 (大亂鬥的 P3、P4 使用另一位角色，讓場上兩種角色都有)
+    std::string characterIds[MAX_PLAYERS];
+    for (int i = 0; i < freeForAllPlayers; ++i) {
+        int index = selectedCharacterIndex[i % 2];
+        characterIds[i] = CHARACTER_TRAITS[(i < 2) ? index : (index + 1) % CHARACTER_COUNT].id;
     }
+    createPlayers(characterIds, freeForAllPlayers);
 
     // 重置拳套選擇狀態
     selectedGloveIndex[0] = 0;
@@ -2033,6 +2021,30 @@ void Game::startGameAfterCharacterSelection() {
     printf("Entering glove selection phase\n");
 }
 
+void Game::createPlayers(const std::string& p1CharacterId, const std::string& p2CharacterId) {
+    const std::string characterIds[2] = {p1CharacterId, p2CharacterId};
+    createPlayers(characterIds, 2);
+}
+
+void Game::createPlayers(const std::string* characterIds, int count) {
+    if (count < 2) count = 2;
+    if (count > MAX_PLAYERS) count = MAX_PLAYERS;
+    players.clear();
+    // 位置與朝向在 resetPlayersForRound 依人數重新安排
+    for (int i = 0; i < count; ++i) {
+        float x = (i % 2 == 0) ? 100.0f : SCREEN_WIDTH - 100.0f - PLAYER_LOGIC_WIDTH;
+        players.emplace_back(x, GROUND_LEVEL - PLAYER_LOGIC_HEIGHT, (i % 2 == 0) ? 1 : -1, characterIds[i], "");
+    }
+    for (Player& player : players) {
+        player.textureId = player.getTraits().textureId; // 紋理由角色特性表決定
+    }
+    for (Player& player : players) {
+        player.balance = balance;
+        player.clock = &matchTick; // 玩家的計時器以比賽的模擬時鐘為準
+        player.chaosModifiers = &chaos.state.modifiers;
+    }
+}
+
 void Game::renderStartScreen() {
     // 繪製背景
     SDL_RenderCopy(renderer, TextureManager::getTexture("start_screen"), nullptr, nullptr);
@@ -2123,6 +2135,23 @@ void Game::renderStartScreen() {
         SDL_FreeSurface(chaosText);
         SDL_FreeSurface(infoText);
         SDL_FreeSurface(recordText);
+
+        // 大亂鬥人數 (在按鈕下方)
+        char playersLabel[64];
+        snprintf(playersLabel, sizeof(playersLabel), "對戰人數：%d 人 (F 切換)", freeForAllPlayers);
+        SDL_Surface* playersText = TTF_RenderUTF8_Blended(buttonFont, playersLabel, {255, 255, 255, 255});
+        if (playersText) {
+            SDL_Texture* playersTexture = SDL_CreateTextureFromSurface(renderer, playersText);
+            SDL_Rect playersRect = {
+                SCREEN_WIDTH / 2 - playersText->w / 2,
+                recordButton.y + recordButton.h + buttonGap,
+                playersText->w,
+                playersText->h
+            };
+            SDL_RenderCopy(renderer, playersTexture, NULL, &playersRect);
+            SDL_DestroyTexture(playersTexture);
+            SDL_FreeSurface(playersText);
+        }
     }
 }
 
@@ -2244,7 +2273,7 @@ void Game::saveGameRecord() {
     record.winnerIndex = roundWinnerIndex;
     
     // 記錄遊戲時間
-    record.gameTime = ROUND_DURATION - roundTimer;
+    record.gameTime = ROUND_DURATION - roundTimer.remainingSeconds(matchTick);
     
     // 添加到記錄列表
     gameRecords.push_front(record);
@@ -2375,8 +2404,10 @@ void Game::renderGameRecords() {
         int lineHeight = 40;
         for (const auto& record : gameRecords) {
             // 轉換角色名稱為中文
-            std::string p1Name = (record.p1Character == "BlockMan") ? "統神" : "國動";
-            std::string p2Name = (record.p2Character == "BlockMan") ? "統神" : "國動";
+            int p1Index = findCharacterIndex(record.p1Character);
+            int p2Index = findCharacterIndex(record.p2Character);
+            std::string p1Name = CHARACTER_TRAITS[p1Index < 0 ? 0 : p1Index].displayName;
+            std::string p2Name = CHARACTER_TRAITS[p2Index < 0 ? 0 : p2Index].displayName;
             std::string vsText = p1Name + " vs " + p2Name;
             
             // 轉換勝利者名稱為中文
@@ -2385,8 +2416,10 @@ void Game::renderGameRecords() {
                 winnerText = "平手";
             } else if (record.winnerIndex == 0) {
                 winnerText = p1Name;
-            } else {
+            } else if (record.winnerIndex == 1) {
                 winnerText = p2Name;
+            } else {
+                winnerText = "P" + std::to_string(record.winnerIndex + 1); // 大亂鬥的 P3、P4
             }
 
             SDL_Surface* timeSurf = TTF_RenderUTF8_Blended(buttonFont, record.timestamp.c_str(), textColor);
@@ -2422,5 +2455,600 @@ void Game::renderGameRecords() {
     SDL_DestroyTexture(hintTexture);
 }
 
+// --- 重播 ---
 
+void Game::captureSnapshot(MatchSnapshot& out) const {
+    out.tick = matchTick;
+    out.gameState = static_cast<Uint8>(currentGameState);
+    out.currentRound = currentRound;
+    out.playerCount = static_cast<Sint32>(std::min<size_t>(players.size(), MAX_PLAYERS));
+    for (int i = 0; i < out.playerCount; ++i) {
+        out.playerWins[i] = playerWins[i];
+    }
+    out.roundTimer = roundTimer.expiresAt;
+    out.roundOverTimer = roundOverTimer.expiresAt;
+    out.roundWinnerIndex = roundWinnerIndex;
+    out.chaos = chaos.state;
+    for (int i = 0; i < out.playerCount; ++i) {
+        players[i].saveState(out.players[i]);
+    }
+    // 只保存還在場上的氣功
+    out.projectiles.clear();
+    for (int i = 0; i < world.projectiles.size(); ++i) {
+        const Projectile proj = world.projectiles.get(i);
+        if (!proj.isActive) continue;
+        ProjectileSnapshot p;
+        p.x = proj.x;
+        p.y = proj.y;
+        p.vx = proj.vx;
+        p.ownerPlayerIndex = proj.ownerPlayerIndex;
+        out.projectiles.push_back(p);
+    }
+}
 
+void Game::restoreSnapshot(const MatchSnapshot& snapshot) {
+    matchTick = snapshot.tick;
+    currentGameState = static_cast<GameState>(snapshot.gameState);
+    currentRound = snapshot.currentRound;
+    for (int i = 0; i < snapshot.playerCount; ++i) {
+        playerWins[i] = snapshot.playerWins[i];
+    }
+    roundTimer.expiresAt = snapshot.roundTimer;
+    roundOverTimer.expiresAt = snapshot.roundOverTimer;
+    roundWinnerIndex = snapshot.roundWinnerIndex;
+    chaos.restore(snapshot.chaos);
+    for (size_t i = 0; i < players.size() && static_cast<int>(i) < snapshot.playerCount; ++i) {
+        players[i].loadState(snapshot.players[i]);
+    }
+    world.clear(); // 特效粒子不在快照裡，回滾或跳轉時直接清掉
+    for (const ProjectileSnapshot& p : snapshot.projectiles) {
+        if (world.projectiles.spawn(p.x, p.y, p.vx, p.ownerPlayerIndex) < 0) break;
+    }
+}
+
+void Game::beginReplayRecording() {
+    if (players.size() < 2) return;
+    ReplayHeader header;
+    header.playerCount = static_cast<int>(std::min<size_t>(players.size(), MAX_PLAYERS));
+    for (int i = 0; i < header.playerCount; ++i) {
+        header.characterIds[i] = players[i].characterId;
+        header.gloveIndex[i] = static_cast<int>(players[i].currentGlove);
+    }
+    header.chaosMode = isChaosMode;
+    header.keyframeInterval = REPLAY_KEYFRAME_INTERVAL;
+    replay.begin(header);
+    isRecordingReplay = true;
+    printf("Replay recording started (keyframe every %d ticks)\n", header.keyframeInterval);
+}
+
+void Game::startReplayPlayback() {
+    if (replay.isEmpty()) return;
+    const ReplayHeader& header = replay.getHeader();
+
+    // 依照重播記錄重建玩家
+    createPlayers(header.characterIds, header.playerCount);
+    for (int i = 0; i < header.playerCount; ++i) {
+        players[i].setGlove(static_cast<Player::GloveType>(header.gloveIndex[i]));
+    }
+    isChaosMode = header.chaosMode;
+
+    isReplayPlayback = true;
+    replayPaused = false;
+    stateHashLog.beginCheck();
+    AudioManager::stopAllSounds();
+    AudioManager::playMusic("bgm", -1);
+    seekReplay(0);
+    printf("Replay playback started\n");
+    replay.printStats();
+}
+
+void Game::stopReplayPlayback() {
+    isReplayPlayback = false;
+    replayPaused = false;
+    AudioManager::stopAllSounds();
+    AudioManager::stopMusic();
+    AudioManager::playMusic("bgm", -1);
+    currentGameState = GameState::START_SCREEN;
+    menuCooldownUntil = SDL_GetTicks() + static_cast<Uint32>(MENU_COOLDOWN * 1000.0f);
+    printf("Replay playback stopped, returned to start screen\n");
+}
+
+void Game::seekReplay(Uint32 targetTick) {
+    if (targetTick > replay.getTickCount()) targetTick = replay.getTickCount();
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    MatchSnapshot snapshot;
+    if (!replay.getKeyframeForTick(targetTick, snapshot)) return;
+    restoreSnapshot(snapshot);
+
+    // 從關鍵幀模擬到目標 tick (不處理事件，避免快轉時音效亂響、特效堆積)
+    Uint32 consumers = gameEventConsumers;
+    gameEventConsumers = 0;
+    for (Uint32 t = snapshot.tick; t < targetTick; ++t) {
+        simulateMatchTick(replay.getInput(t), FIXED_DELTA_TIME);
+        stateHashLog.check(stateHashScratch, stateHash);
+    }
+    gameEventConsumers = consumers;
+    replayTick = targetTick;
+
+    double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+    printf("Replay seek to tick %u: restored keyframe at tick %u, simulated %u ticks in %.2f ms\n",
+           targetTick, snapshot.tick, targetTick - snapshot.tick, ms);
+}
+
+void Game::updateReplayPlayback() {
+    if (replayPaused) return;
+    if (replayTick < replay.getTickCount()) {
+        simulateMatchTick(replay.getInput(replayTick), FIXED_DELTA_TIME);
+        stateHashLog.check(stateHashScratch, stateHash);
+        ++replayTick;
+    } else if (currentGameState == GameState::MATCH_OVER) {
+        // 播完後只更新勝利動畫
+        for (Player& player : players) {
+            player.update(FIXED_DELTA_TIME);
+        }
+    }
+}
+
+void Game::handleReplayKey(SDL_Keycode key) {
+    Uint32 step = REPLAY_SEEK_STEP_TICKS;
+    switch (key) {
+        case SDLK_ESCAPE:
+            stopReplayPlayback();
+            break;
+        case SDLK_SPACE:
+            replayPaused = !replayPaused;
+            break;
+        case SDLK_LEFT:
+            seekReplay(replayTick > step ? replayTick - step : 0);
+            break;
+        case SDLK_RIGHT:
+            seekReplay(replayTick + step);
+            break;
+        case SDLK_HOME:
+            seekReplay(0);
+            break;
+        case SDLK_END:
+            seekReplay(replay.getTickCount());
+            break;
+        default:
+            break;
+    }
+}
+
+void Game::renderReplay() {
+    // 繪製背景
+    SDL_Texture* bgTex = nullptr;
+    if (isChaosMode) {
+        bgTex = TextureManager::getTexture(chaos.state.bgIndex == 0 ? "background" : "background0");
+    } else {
+        bgTex = TextureManager::getTexture("background");
+    }
+    if (bgTex) {
+        SDL_RenderCopy(renderer, bgTex, NULL, NULL);
+    }
+
+    // 繪製玩家
+    for (Player& player : players) {
+        player.render(renderer);
+    }
+
+    // 繪製氣功與特效粒子
+    world.render(renderer, matchTick);
+
+    renderRoundInfo();
+
+    // --- 重播進度條 ---
+    int barWidth = SCREEN_WIDTH - 200;
+    int barHeight = 10;
+    int barX = 100;
+    int barY = SCREEN_HEIGHT - 50;
+    Uint32 totalTicks = replay.getTickCount();
+    float progress = totalTicks > 0 ? (float)replayTick / totalTicks : 0.0f;
+    SDL_SetRenderDrawColor(renderer, 80, 80, 80, 255);
+    SDL_Rect bg = {barX, barY, barWidth, barHeight};
+    SDL_RenderFillRect(renderer, &bg);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_Rect fg = {barX, barY, (int)(barWidth * progress), barHeight};
+    SDL_RenderFillRect(renderer, &fg);
+
+    // --- 重播資訊文字 ---
+    if (buttonFont) {
+        char info[224];
+        int cur = replayTick / SIM_TICK_RATE;
+        int total = totalTicks / SIM_TICK_RATE;
+        snprintf(info, sizeof(info), "重播 %s %02d:%02d / %02d:%02d  記憶體 %.1f KB (%.1f KB/分)  雜湊 %08x",
+                 replayPaused ? "(暫停)" : "", cur / 60, cur % 60, total / 60, total % 60,
+                 replay.getMemoryUsage() / 1024.0f, replay.getBytesPerMinute() / 1024.0f, stateHash);
+        if (stateHashLog.hasDivergence()) {
+            char warn[64];
+            snprintf(warn, sizeof(warn), "  不同步 @ tick %u", stateHashLog.getDivergentTick());
+            strncat(info, warn, sizeof(info) - strlen(info) - 1);
+        }
+        SDL_Color c = {255, 255, 255, 255};
+        SDL_Surface* infoSurf = TTF_RenderUTF8_Blended(buttonFont, info, c);
+        if (infoSurf) {
+            SDL_Texture* infoTex = SDL_CreateTextureFromSurface(renderer, infoSurf);
+            SDL_Rect infoRect = {barX, barY - infoSurf->h - 6, infoSurf->w, infoSurf->h};
+            SDL_RenderCopy(renderer, infoTex, NULL, &infoRect);
+            SDL_DestroyTexture(infoTex);
+            SDL_FreeSurface(infoSurf);
+        }
+        SDL_Surface* hintSurf = TTF_RenderUTF8_Blended(buttonFont, "←/→ 跳轉 5 秒  Home/End 開頭/結尾  空白鍵 暫停  ESC 離開", c);
+        if (hintSurf) {
+            SDL_Texture* hintTex = SDL_CreateTextureFromSurface(renderer, hintSurf);
+            SDL_Rect hintRect = {SCREEN_WIDTH / 2 - hintSurf->w / 2, barY + barHeight + 4, hintSurf->w, hintSurf->h};
+            SDL_RenderCopy(renderer, hintTex, NULL, &hintRect);
+            SDL_DestroyTexture(hintTex);
+            SDL_FreeSurface(hintSurf);
+        }
+    }
+}
+
+// --- 連線對戰 (Rollback Netcode) ---
+
+bool Game::startNetplay(const NetplayConfig& config) {
+    netSession.reset(new NetSession(config));
+    if (!netSession->open()) {
+        netSession.reset();
+        return false;
+    }
+    currentGameState = GameState::START_SCREEN;
+    printf("Netplay: waiting for peer...\n");
+    return true;
+}
+
+void Game::stopNetplay() {
+    if (!netSession) return;
+    printf("Netplay: session ended at tick %u, %d rollbacks (max depth %d), %d stalled ticks%s\n",
+           netTick, netRollbackCount, netMaxRollbackDepth, netStallCount,
+           netSession->hasDesync() ? ", DESYNC detected" : "");
+    netSession.reset();
+    stateHashLog.endRecording();
+    AudioManager::stopAllSounds();
+    AudioManager::stopMusic();
+    AudioManager::playMusic("bgm", -1);
+    currentGameState = GameState::START_SCREEN;
+    menuCooldownUntil = SDL_GetTicks() + static_cast<Uint32>(MENU_COOLDOWN * 1000.0f);
+}
+
+void Game::startNetplayMatch() {
+    const NetplayConfig& config = netSession->getConfig();
+    int local = config.localPlayerIndex;
+    int remote = 1 - local;
+
+    // 沿用本地對戰的流程建立玩家與開始比賽
+    selectedCharacterIndex[local] = config.characterIndex;
+    selectedCharacterIndex[remote] = netSession->getRemoteCharacterIndex();
+    startGameAfterCharacterSelection();
+    selectedGloveIndex[local] = config.gloveIndex;
+    selectedGloveIndex[remote] = netSession->getRemoteGloveIndex();
+    isChaosMode = netSession->getChaosMode();
+    startGameAfterGloveSelection();
+
+    // 雙方必須用同一個亂數種子；輸入可能被回滾修正，這裡不錄製重播
+    chaos.seed(netSession->getMatchSeed());
+    isRecordingReplay = false;
+    replay.clear();
+
+    netTick = 0;
+    netSnapshots.assign(config.rollbackWindow + 2, MatchSnapshot());
+    nextNetChecksumTick = 0;
+    netThrottleCooldown = 0;
+    netPendingEdges = 0;
+    netRollbackCount = 0;
+    netMaxRollbackDepth = 0;
+    netStallCount = 0;
+    printf("Netplay: match started as player %d\n", local + 1);
+}
+
+void Game::saveNetSnapshot(Uint32 tick) {
+    MatchSnapshot& snapshot = netSnapshots[tick % netSnapshots.size()];
+    captureSnapshot(snapshot);
+    snapshot.tick = tick;
+}
+
+void Game::updateNetplay() {
+    netSession->poll();
+
+    if (!netSession->isConnected()) {
+        netSession->updateHandshake();
+        if (netSession->isConnected()) {
+            startNetplayMatch();
+        }
+        return;
+    }
+
+    const NetplayConfig& config = netSession->getConfig();
+
+    // --- 1. 對手的實際輸入跟預測不同：還原到那個 tick，用正確的輸入重新模擬到現在 ---
+    int rollbackFrom = netSession->takeRollbackTick();
+    if (rollbackFrom >= 0 && static_cast<Uint32>(rollbackFrom) < netTick) {
+        const MatchSnapshot& snapshot = netSnapshots[rollbackFrom % netSnapshots.size()];
+        if (snapshot.tick == static_cast<Uint32>(rollbackFrom)) {
+            restoreSnapshot(snapshot);
+            // 重新模擬的 tick 已經播過音效、產生過特效 (也不重複存記錄)，事件不再處理
+            Uint32 consumers = gameEventConsumers;
+            gameEventConsumers = 0;
+            for (Uint32 t = rollbackFrom; t < netTick; ++t) {
+                if (t != static_cast<Uint32>(rollbackFrom)) saveNetSnapshot(t);
+                simulateMatchTick(netSession->buildTickInput(t), FIXED_DELTA_TIME);
+            }
+            gameEventConsumers = consumers;
+
+            int depth = static_cast<int>(netTick) - rollbackFrom;
+            ++netRollbackCount;
+            if (depth > netMaxRollbackDepth) netMaxRollbackDepth = depth;
+        } else {
+            printf("Netplay: snapshot for tick %d is gone, cannot roll back\n", rollbackFrom);
+        }
+    }
+
+    // --- 2. 雙方輸入都已確認的 tick，送出狀態雜湊比對是否不同步 (並寫入 --hash-log) ---
+    while (nextNetChecksumTick < netTick &&
+           static_cast<int>(nextNetChecksumTick) <= netSession->getRemoteConfirmedThrough() + 1) {
+        const MatchSnapshot& snapshot = netSnapshots[nextNetChecksumTick % netSnapshots.size()];
+        if (snapshot.tick == nextNetChecksumTick) {
+            Uint32 hash = hashSnapshot(snapshot);
+            netSession->submitChecksum(snapshot.tick, hash, snapshot);
+            stateHashLog.record(snapshot, hash);
+        }
+        ++nextNetChecksumTick;
+    }
+
+    // --- 3. 比賽結束後只播動畫 (仍然要持續回應對手，讓對手也能確認最後的輸入) ---
+    if (currentGameState == GameState::MATCH_OVER) {
+        for (Player& player : players) {
+            player.update(FIXED_DELTA_TIME);
+        }
+        netSession->sendInputs(netTick);
+        return;
+    }
+
+    // --- 4. 預測超過回滾視窗就等待對手 ---
+    if (static_cast<int>(netTick) > netSession->getRemoteConfirmedThrough() + config.rollbackWindow) {
+        ++netStallCount;
+        netPendingEdges |= currentInput.buttons[0] & INPUT_EDGE_MASK; // 這個 tick 不送出本地輸入，按下的事件不能丟
+        netSession->sendInputs(netTick);
+        return;
+    }
+
+    // --- 5. 領先對手太多就暫停一個 tick，避免對手一直回滾 ---
+    if (netThrottleCooldown > 0) {
+        --netThrottleCooldown;
+    } else if (netSession->getFrameAdvantage(netTick) > NET_FRAME_ADVANTAGE_LIMIT) {
+        netThrottleCooldown = NET_THROTTLE_INTERVAL;
+        netPendingEdges |= currentInput.buttons[0] & INPUT_EDGE_MASK;
+        netSession->sendInputs(netTick);
+        return;
+    }
+
+    // --- 6. 本地輸入 (一律使用 P1 的按鍵配置) 延遲 inputDelay 個 tick 生效 ---
+    netSession->setLocalInput(netTick + config.inputDelay, currentInput.buttons[0] | netPendingEdges);
+    netPendingEdges = 0;
+
+    // --- 7. 保存模擬前的狀態，再用 (可能是預測的) 輸入模擬一個 tick ---
+    saveNetSnapshot(netTick);
+    simulateMatchTick(netSession->buildTickInput(netTick), FIXED_DELTA_TIME);
+    ++netTick;
+    netSession->sendInputs(netTick);
+}
+
+void Game::renderNetplayInfo() {
+    if (!buttonFont || !netSession) return;
+
+    char info[200];
+    const NetplayConfig& config = netSession->getConfig();
+    if (!netSession->isConnected()) {
+        snprintf(info, sizeof(info), "等待對手連線... (UDP %d → %s:%d，ESC 取消)",
+                 config.localPort, config.remoteHost.c_str(), config.remotePort);
+    } else {
+        snprintf(info, sizeof(info), "P%d  RTT %d ms  延遲 %d  回滾 %d 次 (最多 %d)  等待 %d",
+                 config.localPlayerIndex + 1, netSession->getRoundTripMs(), config.inputDelay,
+                 netRollbackCount, netMaxRollbackDepth, netStallCount);
+    }
+
+    SDL_Color c = {255, 255, 255, 255};
+    SDL_Surface* surf = TTF_RenderUTF8_Blended(buttonFont, info, c);
+    if (surf) {
+        SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
+        int y = netSession->isConnected() ? 40 : SCREEN_HEIGHT / 2 - surf->h / 2;
+        SDL_Rect rect = {SCREEN_WIDTH / 2 - surf->w / 2, y, surf->w, surf->h};
+        SDL_RenderCopy(renderer, tex, NULL, &rect);
+        SDL_DestroyTexture(tex);
+        SDL_FreeSurface(surf);
+    }
+
+    // 不同步時顯示警告
+    if (netSession->hasDesync()) {
+        const std::vector<std::string>& diff = netSession->getDesyncDiff();
+        snprintf(info, sizeof(info), "不同步! (tick %u) %s", netSession->getDesyncTick(),
+                 diff.empty() ? "" : diff[0].c_str());
+        SDL_Color red = {255, 60, 60, 255};
+        SDL_Surface* warn = TTF_RenderUTF8_Blended(buttonFont, info, red);
+        if (warn) {
+            SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, warn);
+            SDL_Rect rect = {SCREEN_WIDTH / 2 - warn->w / 2, 72, warn->w, warn->h};
+            SDL_RenderCopy(renderer, tex, NULL, &rect);
+            SDL_DestroyTexture(tex);
+            SDL_FreeSurface(warn);
+        }
+    }
+}
+
+void Game::setupLatency(const LatencyOptions& options) {
+    frameDelayMs = options.frameDelayMs;
+    inputLatency.overlayEnabled = options.overlay;
+    if (!options.csvPath.empty()) {
+        inputLatency.openCsv(options.csvPath);
+    }
+    if (frameDelayMs > 0) {
+        printf("Latency: delaying input sampling by %d ms after each present\n", frameDelayMs);
+    }
+}
+
+void Game::renderLatencyOverlay() {
+    if (!buttonFont) return;
+
+    char info[200];
+    if (inputLatency.getSampleCount() == 0) {
+        snprintf(info, sizeof(info), "輸入延遲：尚無資料 (對戰中按鍵後顯示)");
+    } else {
+        float eventToTick = inputLatency.getAverageEventToTickMs();
+        float tickToPresent = inputLatency.getAverageTickToPresentMs();
+        snprintf(info, sizeof(info), "事件→tick %.1f ms  tick→畫面 %.1f ms  合計 %.1f ms (最近 %d 筆，延後 %d ms)",
+                 eventToTick, tickToPresent, eventToTick + tickToPresent, inputLatency.getSampleCount(), frameDelayMs);
+    }
+
+    SDL_Color c = {255, 255, 0, 255};
+    SDL_Surface* surf = TTF_RenderUTF8_Blended(buttonFont, info, c);
+    if (surf) {
+        SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
+        SDL_Rect rect = {SCREEN_WIDTH / 2 - surf->w / 2, SCREEN_HEIGHT - surf->h - 8, surf->w, surf->h};
+        SDL_RenderCopy(renderer, tex, NULL, &rect);
+        SDL_DestroyTexture(tex);
+        SDL_FreeSurface(surf);
+    }
+}
+
+// --- 狀態雜湊 ---
+
+Uint32 Game::computeStateHash() {
+    Uint64 start = SDL_GetPerformanceCounter();
+    captureSnapshot(stateHashScratch);
+    Uint32 hash = hashSnapshot(stateHashScratch);
+    stateHashCounterTotal += SDL_GetPerformanceCounter() - start;
+    ++stateHashSamples;
+    return hash;
+}
+
+void Game::setupStateHashLog(const StateHashOptions& options) {
+    if (!options.logPath.empty()) {
+        stateHashLog.setLogPath(options.logPath);
+    }
+    if (!options.comparePath.empty()) {
+        stateHashLog.loadReference(options.comparePath);
+    }
+}
+
+void Game::printStateHashStats() {
+    if (stateHashSamples == 0) return;
+    double ns = stateHashCounterTotal * 1e9 / SDL_GetPerformanceFrequency() / stateHashSamples;
+    printf("StateHash: %u ticks hashed, %.0f ns per tick, last hash %08x\n", stateHashSamples, ns, stateHash);
+}
+
+// --- 無畫面模擬 ---
+bool Game::initializeHeadless() {
+    printf("Initializing headless simulation...\n");
+    ownsSubsystems = true;
+    // 只需要計時器；不初始化影像/字型/音訊，所以沒有顯示器或音效卡也能跑。
+    // TextureManager/AudioManager 沒有初始化時所有查詢與播放都是空操作。
+    if (SDL_Init(SDL_INIT_TIMER) < 0) {
+        printf("SDL Init Error: %s\n", SDL_GetError());
+        return false;
+    }
+    isHeadless = true;
+
+    AnimationDataManager::initializeBlockManAnimations();
+    AnimationDataManager::initializeGodonAnimations();
+
+    isRunning = true;
+    return true;
+}
+
+void Game::startHeadlessMatch(const HeadlessMatchSetup& setup) {
+    createPlayers(setup.characterIds, setup.playerCount);
+    selectedGloveIndex[0] = setup.gloveIndex[0];
+    selectedGloveIndex[1] = setup.gloveIndex[1];
+    isChaosMode = setup.chaosMode;
+    startGameAfterGloveSelection();
+    chaos.seed(setup.seed * 2654435761u); // 混亂事件也依種子決定，整批結果可重現
+}
+
+int Game::playHeadlessMatch(const HeadlessMatchSetup& setup) {
+    startHeadlessMatch(setup);
+
+    // 每位玩家一個 AI；P1、P2 的種子跟兩人對戰時相同
+    ScriptedAI ai[MAX_PLAYERS];
+    int count = static_cast<int>(players.size());
+    for (int i = 0; i < count; ++i) {
+        Uint32 aiSeed = setup.seed * 2 + 1 + static_cast<Uint32>(i);
+        ai[i] = ScriptedAI(i < 2 ? aiSeed : aiSeed * 2654435761u);
+    }
+    TickInput input;
+    while (currentGameState != GameState::MATCH_OVER && matchTick < setup.maxTicks) {
+        for (int i = 0; i < count; ++i) {
+            input.buttons[i] = ai[i].decide(*this, i);
+        }
+        simulateMatchTick(input, FIXED_DELTA_TIME);
+        stateHashLog.record(stateHashScratch, stateHash);
+    }
+    stateHashLog.endRecording();
+    return (currentGameState == GameState::MATCH_OVER) ? roundWinnerIndex : -1;
+}
+
+void Game::runHeadless(const HeadlessConfig& config) {
+    logVerbose = config.verbose;
+    const HeadlessMatchSetup& base = config.match;
+    std::string lineup;
+    for (int i = 0; i < base.playerCount; ++i) {
+        char fighter[64];
+        snprintf(fighter, sizeof(fighter), "%s%s (%doz)", i > 0 ? " vs " : "",
+                 base.characterIds[i].c_str(), 10 + 4 * base.gloveIndex[i % 2]);
+        lineup += fighter;
+    }
+    printf("Headless: %d matches, %s%s, seed %u\n", config.matches, lineup.c_str(),
+           base.chaosMode ? ", chaos mode" : "", base.seed);
+
+    int wins[MAX_PLAYERS] = {};
+    int unfinished = 0;
+    Uint64 totalTicks = 0;
+    gameEventStats.clear();
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    for (int match = 0; match < config.matches && isRunning; ++match) {
+        HeadlessMatchSetup setup = base;
+        setup.seed = base.seed + static_cast<Uint32>(match);
+        int winner = playHeadlessMatch(setup);
+        totalTicks += matchTick;
+        if (winner >= 0 && winner < setup.playerCount) {
+            ++wins[winner];
+        } else {
+            ++unfinished;
+        }
+        if (config.verbose) {
+            char result[24] = "unfinished";
+            if (winner >= 0) snprintf(result, sizeof(result), "P%d wins", winner + 1);
+            std::string rounds;
+            for (int i = 0; i < setup.playerCount; ++i) {
+                rounds += (i > 0 ? "-" : "") + std::to_string(playerWins[i]);
+            }
+            printf("Headless: match %d seed %u -> %s after %u ticks (rounds %s), hash %08x\n",
+                   match + 1, setup.seed, result, matchTick, rounds.c_str(), stateHash);
+        }
+    }
+
+    double seconds = static_cast<double>(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    int played = unfinished;
+    std::string tally;
+    for (int i = 0; i < base.playerCount; ++i) {
+        played += wins[i];
+        tally += "P" + std::to_string(i + 1) + " " + std::to_string(wins[i]) + " wins, ";
+    }
+    printf("Headless: %s%d unfinished\n", tally.c_str(), unfinished);
+    if (played > 0) {
+        printf("Headless: average match length %.1f s (%.0f ticks)\n",
+               static_cast<double>(totalTicks) / played / SIM_TICK_RATE, static_cast<double>(totalTicks) / played);
+        const Uint64* counts = gameEventStats.counts;
+        printf("Headless: per match %.1f hits, %.1f blocks, %.1f projectiles, %.1f KOs\n",
+               static_cast<double>(counts[static_cast<int>(GameEventType::HIT)]) / played,
+               static_cast<double>(counts[static_cast<int>(GameEventType::BLOCK)]) / played,
+               static_cast<double>(counts[static_cast<int>(GameEventType::PROJECTILE_SPAWN)]) / played,
+               static_cast<double>(counts[static_cast<int>(GameEventType::KO)]) / played);
+    }
+    if (seconds > 0.0) {
+        printf("Headless: %llu ticks in %.3f s, %.0f ticks/sec (%.0fx real time)\n",
+               static_cast<unsigned long long>(totalTicks), seconds, totalTicks / seconds,
+               totalTicks / seconds / SIM_TICK_RATE);
+    }
+}
@@ -5,7 +5,21 @@
 #include <vector>
 #include <string> 
 #include "Player.h" // 包含 Player
+#include "World.h" // 氣功與特效粒子 (archetype 元件陣列)
+#include "Broadphase.h" // 碰撞粗篩
+#include "MenuInput.h" // 選單上下鍵的重複
+#include "InputMap.h" // 按鍵/手把 -> 玩家輸入位元的對應表
+#include "InputLatency.h" // 輸入延遲量測
+#include "GameEvent.h" // 每個 tick 的遊戲事件
+#include "ChaosEngine.h" // 混亂模式事件
 #include "AudioManager.h"
+#include "Input.h"
+#include "Replay.h"
+#include "NetSession.h"
+#include "StateHash.h"
+#include "Headless.h"
+#include "ScriptedAI.h"
+#include <memory>
 #include <fstream>
 #include <ctime>
 #include <deque>
@@ -23,50 +37,6 @@ enum class GameState {
     CHARACTER_INFO   // 角色介紹畫面
 };
 
-// --- 新增：混亂模式事件型別 ---
-enum class ChaosEventType {
-    NONE,
-    CONTROL_REVERSE,
-    HP_SWAP
-};
-
-// --- 在 class Game 之前定義 Projectile ---
-struct Projectile {
-    float x = 0.0f;
-    float y = 0.0f;
-    float vx = 0.0f;
-    int ownerPlayerIndex = -1; // 是哪個玩家發射的 (0 或 1)
-    bool isActive = false;
-    std::string textureId = "projectile_sprites"; // <-- 使用的紋理 ID (要跟載入時一致)
-    SDL_Rect srcRect = {0, 0, 0, 0}; // <-- 氣功在精靈圖上的來源矩形
-
-    // 更新位置
-    void update(float deltaTime) {
-        if (isActive) {
-            x += vx * deltaTime;
-            // 簡單的邊界檢查
-            if (x > SCREEN_WIDTH + 50 || x < -50) { // 稍微超出邊界才消失
-                isActive = false;
-            }
-        }
-    }
-
-    // 取得碰撞框
-    SDL_Rect getBoundingBox() const {
-        // 使用 Constants.h 中定義的碰撞大小
-        return {(int)x, (int)y, PROJECTILE_HITBOX_W, PROJECTILE_HITBOX_H};
-    }
-
-    // 繪製 (Renderer 和 Texture 需要從 Game 傳入)
-    void render(SDL_Renderer* renderer, SDL_Texture* texture) {
-        if (isActive && texture) {
-            SDL_Rect destRect = {(int)x, (int)y, PROJECTILE_HITBOX_W, PROJECTILE_HITBOX_H};
-            // 注意：這裡的翻轉通常不需要，氣功圖本身應該是中性的
-            SDL_RenderCopy(renderer, texture, &srcRect, &destRect);
-        }
-    }
-};
-
 // 遊戲記錄結構
 struct GameRecord {
     std::string timestamp;
@@ -101,41 +71,52 @@ public:
 
     // 碰撞檢測
     void checkCollisions();
-    bool checkProjectilePlayerCollision(const Projectile& proj, Player& player);
-    void checkPlayerCollision(Player& p1, Player& p2);
+    void resolveCollisions(float deltaTime); // broadphase 找候選配對，再以掃掠 AABB 精確判定 (氣功 -> 近身攻擊 -> 推擠)
+    void applyProjectileHit(Player& player); // 氣功命中：格擋時不受傷害
+    void resolveMeleeHit(Player& attacker, Player& target, float toi); // toi: tick 內的碰撞時間
+    int findNearestOpponent(int playerIndex) const; // 最近的存活對手 (-1 表示沒有)
+    void recordHit(int target, int source, int healthBefore, float x, float y, int direction, bool blocked); // 命中/格擋事件 (沒有造成傷害的接觸不記錄，打倒時再加一筆 KO)
+    void separatePlayers(Player& p1, Player& p2); // 防止玩家重疊
 
     // --- 回合管理函式 ---
     void startNewRound();      // 開始新回合的準備工作
-    void endRound(int winnerPlayerIndex); // 處理回合結束 -1:平手, 0:P1勝, 1:P2勝
+    void endRound(int winnerPlayerIndex); // 處理回合結束 -1:平手, 其他為勝利玩家的索引
     void resetPlayersForRound(); // 重置玩家位置、血量等
     void checkForMatchWinner(); // 檢查是否有人贏得整場比賽
 
     // --- 拳套選擇介面相關 ---
-    void handleGloveSelection(); // 處理拳套選擇的輸入
+    void handleGloveSelection(); // 每個畫面套用拳套選擇的上下移動
     void startGameAfterGloveSelection(); // 拳套選擇完成後開始遊戲
 
     // --- 角色選擇介面相關 ---
-    void handleCharacterSelection(); // 處理角色選擇的輸入
+    void handleCharacterSelection(); // 每個畫面套用角色選擇的上下移動
     void startGameAfterCharacterSelection(); // 角色選擇完成後進入拳套選擇
+    void createPlayers(const std::string& p1CharacterId, const std::string& p2CharacterId); // 依角色 ID 建立雙方玩家
+    void createPlayers(const std::string* characterIds, int count); // 建立 count 位玩家 (2 ~ MAX_PLAYERS)
 
     // SDL 相關
     SDL_Window* window;
     SDL_Renderer* renderer;
 
     // 遊戲物件 (使用 vector 以便未來擴充)
-    std::vector<Player> players; // 目前只有兩個玩家
-    std::vector<Projectile> projectiles;
+    std::vector<Player> players; // 一般對戰兩位，大亂鬥最多 MAX_PLAYERS 位
+    World world;                 // 玩家以外的實體：氣功 (world.projectiles) 與特效粒子
+    BroadphaseGrid broadphase;   // 每個 tick 重建的碰撞格子
+    std::vector<BroadphasePair> collisionPairs; // broadphase 找到的候選配對 (重複使用，不每個 tick 配置)
+    std::vector<BroadphasePair> collisionContacts; // 掃掠測試確定會碰到的配對，依碰撞時間排序
+    std::vector<Uint8> shotConsumed; // 這個 tick 已經命中的氣功
 
     // 遊戲狀態
     bool isRunning;
+    bool ownsSubsystems = false; // 由這個 Game 初始化 SDL/資源管理器，cleanup 時負責關閉
     Uint32 lastFrameTime;
 
     // --- 回合制相關變數 ---
     GameState currentGameState; // 目前的遊戲狀態
     int currentRound;           // 目前是第幾回合 (從 1 開始)
-    int playerWins[2];          // 記錄 P1 和 P2 的勝利回合數 (索引 0 為 P1, 1 為 P2)
-    float roundTimer;           // 目前回合的剩餘時間
-    float roundOverTimer;       // 回合結束狀態的計時器
+    int playerWins[MAX_PLAYERS]; // 每位玩家的勝利回合數 (索引 0 為 P1, 1 為 P2 ...)
+    TickTimer roundTimer;       // 目前回合的時間限制 (到期的 tick，剩餘時間在繪製時才計算)
+    TickTimer roundOverTimer;   // 回合結束狀態的計時器
     int roundWinnerIndex;       // 記錄本回合勝利者的索引 (-1 表示平手或無)
 
     // --- 拳套選擇介面相關變數 ---
@@ -146,6 +127,7 @@ public:
     // --- 角色選擇介面相關變數 ---
     int selectedCharacterIndex[2];  // 兩個玩家選擇的角色索引 (0: 統神, 1: 國動)
     bool characterSelectionConfirmed[2]; // 兩個玩家是否已確認選擇
+    MenuInput menuInput;                 // 選單上下鍵的重複計時 (不會卡住主迴圈)
 
     // --- 新增：暫停相關變數 ---
     SDL_Rect continueButton;    // 繼續遊戲按鈕
@@ -159,9 +141,11 @@ public:
 
     // 生成氣功
     void spawnProjectile(float startX, float startY, int direction, int ownerIndex);
+    void spawnChaosFlood(); // 氣功洪水期間每個 tick 從兩側射出氣功
     
     // --- 新增：簡易 UI 繪製函式 ---
     void renderRoundInfo(); // 繪製回合數、計時器、勝利標記
+    void renderPlayerHud(int playerIndex); // 繪製一位玩家的血條、勝利標記與冷卻條
 
     // 新增：遊戲記錄相關函式
     void saveGameRecord();
@@ -171,23 +155,99 @@ public:
 
     // --- 混亂模式相關 ---
     bool isChaosMode = false; // 是否啟用混亂模式
-    float chaosEventTimer = 0.0f; // 混亂事件倒數計時
-    ChaosEventType chaosEvent = ChaosEventType::NONE; // 目前混亂事件
-    float chaosEventShowTimer = 0.0f; // 混亂事件名稱顯示倒數（秒）
-    int chaosBgIndex = 0; // 混亂模式下背景交替（0: image0.png, 1: image.png）
-    float chaosEventTimerMax = 15.0f; // 混亂事件冷卻條最大值
+    ChaosEngine chaos;        // 事件抽選、持續效果的時間輪與目前的規則調整 (狀態存進快照)
+
+    // --- 大亂鬥 (Free-for-all) ---
+    int freeForAllPlayers = 2; // 開始畫面選擇的人數 (F 鍵切換 2/3/4)，P3、P4 由腳本 AI 操控
+    std::vector<ScriptedAI> freeForAllAIs; // 操控 P3 之後的玩家 (輸入寫進 TickInput，重播照樣重現)
 
     // 新增：遊戲記錄相關變數
     std::deque<GameRecord> gameRecords;  // 使用 deque 來儲存最近的遊戲記錄
     SDL_Rect recordButton;     // 記錄按鈕
     bool showRecords;          // 是否顯示記錄
     const int MAX_RECORDS = 5; // 最多保存5局記錄
-    float menuCooldownTimer;  // 新增：選單冷卻計時器
+    Uint32 menuCooldownUntil;  // 新增：選單冷卻結束的時間 (SDL_GetTicks 毫秒，選單不屬於模擬)
     static constexpr float MENU_COOLDOWN = 0.5f;  // 新增：冷卻時間（秒）
 
     // 新增：按鍵處理和冷卻條渲染
     void handleKeyPress(SDL_Keycode key);
 
+    // --- 固定步長模擬與輸入 ---
+    TickInput currentInput;       // 目前取樣到的輸入，交給下一個模擬 tick
+    InputMap inputMap;            // 鍵盤/手把對應到玩家輸入位元 (可由 controls.cfg 覆蓋)
+    float tickAccumulator = 0.0f; // 尚未模擬的累積時間 (秒)
+    void sampleHeldInput();       // 依鍵位表讀取鍵盤/手把持續按壓的狀態
+    void latchInput();            // 模擬 tick 之前才取樣持續按壓的狀態，並記錄輸入延遲
+    InputLatencyMonitor inputLatency; // 事件 -> tick -> 畫面的延遲 (F3 顯示，可寫成 CSV)
+    int frameDelayMs = 0;         // 畫面送出後等待多久才處理輸入 (--frame-delay)
+    void setupLatency(const LatencyOptions& options); // --latency-csv / --frame-delay / --latency-overlay
+    void renderLatencyOverlay();
+    void resolvePlayerCommands(const TickInput& input, PlayerCommands out[MAX_PLAYERS]) const; // 按鍵 -> 每位玩家的指令
+    void applyPlayerInputs(const TickInput& input); // 把一個 tick 的輸入轉成玩家動作
+    void simulateMatchTick(const TickInput& input, float deltaTime); // 比賽進行中 (PLAYING/ROUND_OVER) 的一個 tick
+    void advanceMatchState(const TickInput& input, float deltaTime); // simulateMatchTick 的實際遊戲邏輯
+
+    // --- 遊戲事件 (模擬寫入，tick 結束後才交給消費者) ---
+    GameEventBuffer gameEvents;                       // 目前這個 tick 的事件 (每個 tick 重複使用)
+    Uint32 gameEventConsumers = EVENT_CONSUMERS_ALL;  // 啟用中的消費者 (回滾重新模擬、重播快轉時暫時關閉)
+    GameEventStats gameEventStats;                    // EVENT_CONSUMER_STATS 的累計
+    void dispatchGameEvents();                        // 依序把這個 tick 的事件交給各個消費者
+    void playEventSound(const GameEvent& event);      // EVENT_CONSUMER_AUDIO
+    void logGameEvent(const GameEvent& event);        // EVENT_CONSUMER_LOG
+
+    // --- 狀態雜湊 (偵測不同步) ---
+    Uint32 matchTick = 0;            // 本場比賽已模擬的 tick 數 (存進快照)，也是所有 TickTimer 的模擬時鐘
+    Uint32 stateHash = 0;            // 最近一個 tick 結束後的狀態雜湊
+    MatchSnapshot stateHashScratch;  // 計算雜湊用的快照 (重複使用，不每個 tick 配置記憶體)
+    StateHashLog stateHashLog;       // --hash-log / --hash-compare
+    Uint64 stateHashCounterTotal = 0; // 計算雜湊花費的時間 (效能計數器單位)
+    Uint32 stateHashSamples = 0;
+    Uint32 computeStateHash();
+    void setupStateHashLog(const StateHashOptions& options);
+    void printStateHashStats();
+
+    // --- 重播 ---
+    Replay replay;                   // 最近一場比賽的重播
+    bool isRecordingReplay = false;  // 是否正在錄製
+    bool isReplayPlayback = false;   // 是否正在觀看重播
+    bool replayPaused = false;
+    Uint32 replayTick = 0;           // 重播目前播放到的 tick
+    void captureSnapshot(MatchSnapshot& out) const;
+    void restoreSnapshot(const MatchSnapshot& snapshot);
+    void beginReplayRecording();
+    void startReplayPlayback();
+    void stopReplayPlayback();
+    void seekReplay(Uint32 targetTick); // 還原最近的關鍵幀，再模擬剩下的 tick
+    void updateReplayPlayback();
+    void handleReplayKey(SDL_Keycode key);
+    void renderReplay();
+
+    // --- 連線對戰 (Rollback Netcode) ---
+    std::unique_ptr<NetSession> netSession;  // 非空表示正在連線對戰
+    Uint32 netTick = 0;                      // 下一個要模擬的 tick
+    std::vector<MatchSnapshot> netSnapshots; // 最近幾個 tick 模擬前的狀態 (環狀緩衝，回滾用)
+    Uint32 nextNetChecksumTick = 0;          // 下一個要送出校驗碼的 tick
+    int netThrottleCooldown = 0;             // 領先太多時暫停 tick 的冷卻
+    Uint16 netPendingEdges = 0;              // 停住/暫停的 tick 上按下的瞬間事件 (留到下一次送出本地輸入)
+    int netRollbackCount = 0;                // 回滾次數 (統計)
+    int netMaxRollbackDepth = 0;             // 單次回滾最多重新模擬的 tick 數 (統計)
+    int netStallCount = 0;                   // 等待對手輸入而停住的 tick 數 (統計)
+    bool startNetplay(const NetplayConfig& config); // 開啟 socket 並開始握手
+    void stopNetplay();
+    void startNetplayMatch();                // 握手完成後依雙方設定開始比賽
+    void updateNetplay();                    // 連線對戰的一個 tick (回滾、等待、模擬)
+    void saveNetSnapshot(Uint32 tick);
+    void renderNetplayInfo();
+
+    // --- 無畫面模擬 (--headless) ---
+    bool isHeadless = false;                 // 沒有視窗/渲染器/音訊，不錄重播也不存對戰記錄
+    bool initializeHeadless();               // 只初始化模擬需要的部分
+    void runHeadless(const HeadlessConfig& config); // 以腳本 AI 連續跑多場比賽並回報 tick/秒
+    void startHeadlessMatch(const HeadlessMatchSetup& setup); // 依設定建立玩家並開始第一回合
+    int playHeadlessMatch(const HeadlessMatchSetup& setup); // 跑完一場，回傳勝利者 (-1: 超過 tick 上限)
+    BalanceParams balance;                   // 建立玩家時套用的平衡性參數
+    bool motionCommandsEnabled = true;       // 搓招 (下、前下、前 + 普攻) 可以放特殊技能 (VecEnv 比對時關閉)
+
 private:
     // 處理事件
     void handleEvents();
@@ -0,0 +1,35 @@
+#include "GameEvent.h"
+
+GameEvent makeGameEvent(GameEventType type, Uint32 tick, int player) {
+    GameEvent event;
+    event.tick = tick;
+    event.type = type;
+    event.player = static_cast<Sint8>(player);
+    event.source = -1;
+    event.direction = 0;
+    event.value = 0;
+    event.health = 0;
+    event.x = 0.0f;
+    event.y = 0.0f;
+    return event;
+}
+
+const char* gameEventName(GameEventType type) {
+    switch (type) {
+        case GameEventType::JUMP:             return "jump";
+        case GameEventType::HIT:              return "hit";
+        case GameEventType::BLOCK:            return "block";
+        case GameEventType::KO:               return "ko";
+        case GameEventType::PROJECTILE_SPAWN: return "projectile";
+        case GameEventType::ROUND_END:        return "round-end";
+        case GameEventType::MATCH_END:        return "match-end";
+        case GameEventType::CHAOS_EVENT:      return "chaos";
+        default:                              return "unknown";
+    }
+}
+
+void GameEventStats::add(const GameEventBuffer& buffer) {
+    for (int i = 0; i < buffer.size(); ++i) {
+        ++counts[static_cast<int>(buffer[i].type)];
+    }
+}
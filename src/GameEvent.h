@@ -0,0 +1,77 @@
+#ifndef GAME_EVENT_H
+#define GAME_EVENT_H
+
+#include <SDL2/SDL.h>
+#include <type_traits>
+#include "Constants.h"
+
+// --- 遊戲事件 ---
+// 模擬只把「發生了什麼」寫進每個 tick 的事件緩衝區，不直接播音效、產生特效或寫檔；
+// tick 結束後 Game::dispatchGameEvents 再依序交給啟用中的消費者處理。
+enum class GameEventType : Uint8 {
+    JUMP,             // player 起跳
+    HIT,              // player 被 source 打中 (value: 實際扣的血，可能因無敵為 0)
+    BLOCK,            // player 擋下 source 的攻擊
+    KO,               // player 被 source 打倒
+    PROJECTILE_SPAWN, // player 發射氣功 (氣功洪水的 player 為 -1)
+    ROUND_END,        // 第 value 回合結束，player 為勝利者 (-1 表示平手)
+    MATCH_END,        // player 贏得整場比賽
+    CHAOS_EVENT,      // 混亂模式事件觸發 (value: ChaosEventType)
+    COUNT
+};
+const int GAME_EVENT_TYPE_COUNT = static_cast<int>(GameEventType::COUNT);
+
+// 單一事件 (POD，直接複製進固定大小的陣列，不配置記憶體)
+struct GameEvent {
+    Uint32 tick;         // 發生在哪個 tick
+    GameEventType type;
+    Sint8 player;        // 主要的玩家索引 (-1 表示沒有)
+    Sint8 source;        // 攻擊者的玩家索引 (-1 表示沒有，例如氣功洪水)
+    Sint8 direction;     // 火花噴出 / 氣功飛行的方向 (1: 右, -1: 左)
+    Sint16 value;        // 依類型而定 (傷害、回合數、混亂事件種類)
+    Sint16 health;       // 事件後 player 的血量
+    float x, y;          // 發生的位置 (命中火花、氣功出生點)
+};
+static_assert(std::is_trivially_copyable<GameEvent>::value, "GameEvent must stay POD");
+
+// 欄位預設為「沒有」的事件
+GameEvent makeGameEvent(GameEventType type, Uint32 tick, int player);
+const char* gameEventName(GameEventType type);
+
+// --- 一個 tick 的事件緩衝區 ---
+// 每個 tick 開始時清空，重複使用同一塊陣列；滿了就丟掉並計數 (只影響表現，不影響模擬)。
+struct GameEventBuffer {
+    GameEvent events[MAX_GAME_EVENTS_PER_TICK];
+    int count = 0;
+    Uint32 dropped = 0;  // 累計丟掉的事件數
+
+    void clear() { count = 0; }
+    void push(const GameEvent& event) {
+        if (count < MAX_GAME_EVENTS_PER_TICK) events[count++] = event;
+        else ++dropped;
+    }
+    int size() const { return count; }
+    const GameEvent& operator[](int i) const { return events[i]; }
+};
+
+// --- 事件的消費者 (Game::gameEventConsumers 的位元) ---
+enum GameEventConsumer : Uint32 {
+    EVENT_CONSUMER_AUDIO   = 1 << 0, // 音效與背景音樂
+    EVENT_CONSUMER_EFFECTS = 1 << 1, // 命中/格擋火花
+    EVENT_CONSUMER_RECORDS = 1 << 2, // 比賽結束時寫入對戰記錄
+    EVENT_CONSUMER_STATS   = 1 << 3, // 事件計數 (無畫面模擬的統計)
+    EVENT_CONSUMER_LOG     = 1 << 4  // 除錯訊息 (DEBUG_LOG)
+};
+const Uint32 EVENT_CONSUMERS_ALL = 0x1F;
+// 無畫面模擬沒有音訊、畫面，也不存對戰記錄
+const Uint32 EVENT_CONSUMERS_HEADLESS = EVENT_CONSUMER_STATS | EVENT_CONSUMER_LOG;
+
+// --- 事件計數 ---
+struct GameEventStats {
+    Uint64 counts[GAME_EVENT_TYPE_COUNT] = {};
+
+    void clear() { *this = GameEventStats(); }
+    void add(const GameEventBuffer& buffer);
+};
+
+#endif // GAME_EVENT_H
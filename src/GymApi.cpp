@@ -0,0 +1,218 @@
+#include "GymApi.h"
+#include "Game.h"
+#include "Log.h"
+#include <cmath>
+#include <mutex>
+#include <new>
+
+// C 端的動作位元必須與鍵盤輸入完全相同
+static_assert(int(SFGYM_ACTION_LEFT) == INPUT_LEFT && int(SFGYM_ACTION_RIGHT) == INPUT_RIGHT &&
+              int(SFGYM_ACTION_UP) == INPUT_UP && int(SFGYM_ACTION_DOWN) == INPUT_DOWN &&
+              int(SFGYM_ACTION_ATTACK) == INPUT_ATTACK && int(SFGYM_ACTION_FIRE) == INPUT_FIRE &&
+              int(SFGYM_ACTION_BLOCK) == INPUT_BLOCK && int(SFGYM_ACTION_FIRE_PRESSED) == INPUT_FIRE_PRESSED &&
+              int(SFGYM_ACTION_SPECIAL_PRESSED) == INPUT_SPECIAL_PRESSED,
+              "SfgymAction must match InputButton");
+
+namespace {
+
+const Uint16 SFGYM_ACTION_MASK = 0x1ff;
+
+// 動畫資料由所有 env 共用，第一次建立 env 時載入 (之後只會被讀取)
+std::once_flag simulationDataOnce;
+
+void initializeSimulationData() {
+    std::call_once(simulationDataOnce, []() {
+        logVerbose = false;
+        AnimationDataManager::initializeBlockManAnimations();
+        AnimationDataManager::initializeGodonAnimations();
+    });
+}
+
+void writeFighter(const Player& player, float* out) {
+    const Uint32 now = player.now();
+    out[SFGYM_OBS_X] = player.x / SCREEN_WIDTH;
+    out[SFGYM_OBS_Y] = player.y / SCREEN_HEIGHT;
+    out[SFGYM_OBS_VX] = player.vx / MOVE_SPEED;
+    out[SFGYM_OBS_VY] = player.vy / JUMP_STRENGTH;
+    out[SFGYM_OBS_HEALTH] = player.health / PLAYER_DEFAULT_HEALTH;
+    out[SFGYM_OBS_DIRECTION] = static_cast<float>(player.direction);
+    out[SFGYM_OBS_STATE] = static_cast<float>(static_cast<int>(player.state));
+    out[SFGYM_OBS_ON_GROUND] = player.isOnGround ? 1.0f : 0.0f;
+    out[SFGYM_OBS_ATTACK_TIMER] = player.attackTimer.remainingSeconds(now);
+    out[SFGYM_OBS_ATTACK_RATE_COOLDOWN] = player.attackRateCooldownTimer.remainingSeconds(now);
+    out[SFGYM_OBS_BLOCK_COOLDOWN] = player.blockCooldownTimer.remainingSeconds(now);
+    out[SFGYM_OBS_PROJECTILE_COOLDOWN] = player.projectileCooldownTimer.remainingSeconds(now);
+    out[SFGYM_OBS_SPECIAL_COOLDOWN] = player.specialAttackCooldownTimer.remainingSeconds(now);
+    out[SFGYM_OBS_HURT_TIMER] = player.hurtTimer.remainingSeconds(now);
+    out[SFGYM_OBS_INVINCIBILITY_TIMER] = player.invincibilityTimer.remainingSeconds(now);
+    out[SFGYM_OBS_SPECIAL_ATTACKING] = player.isSpecialAttacking ? 1.0f : 0.0f;
+    out[SFGYM_OBS_CHARACTER] = static_cast<float>(player.characterIndex);
+    out[SFGYM_OBS_GLOVE] = static_cast<float>(static_cast<int>(player.currentGlove));
+}
+
+} // namespace
+
+// --- 一個環境 = 一個只跑模擬的 Game ---
+struct SfgymEnv {
+    Game game;
+    HeadlessMatchSetup setup;
+};
+
+extern "C" {
+
+int sfgym_api_version(void) {
+    return SFGYM_API_VERSION;
+}
+
+int sfgym_observation_size(void) {
+    return SFGYM_OBS_SIZE;
+}
+
+void sfgym_default_config(SfgymConfig* config) {
+    if (!config) return;
+    config->character[0] = 0;
+    config->character[1] = 1;
+    config->glove[0] = 0;
+    config->glove[1] = 0;
+    config->chaos_mode = 0;
+    config->seed = 1;
+    config->max_ticks = SIM_TICK_RATE * 60 * 10;
+}
+
+SfgymEnv* sfgym_create(const SfgymConfig* config) {
+    SfgymConfig defaults;
+    sfgym_default_config(&defaults);
+    if (!config) config = &defaults;
+    for (int p = 0; p < 2; ++p) {
+        if (config->character[p] < 0 || config->character[p] >= CHARACTER_COUNT ||
+            config->glove[p] < 0 || config->glove[p] >= GLOVE_TYPE_COUNT) {
+            return nullptr;
+        }
+    }
+
+    initializeSimulationData();
+    SfgymEnv* env = new (std::nothrow) SfgymEnv();
+    if (!env) return nullptr;
+    env->game.isHeadless = true;
+    env->game.isRunning = true;
+    for (int p = 0; p < 2; ++p) {
+        env->setup.characterIds[p] = CHARACTER_TRAITS[config->character[p]].id;
+        env->setup.gloveIndex[p] = config->glove[p];
+    }
+    env->setup.chaosMode = config->chaos_mode != 0;
+    env->setup.seed = config->seed;
+    env->setup.maxTicks = config->max_ticks;
+    env->game.startHeadlessMatch(env->setup);
+    return env;
+}
+
+void sfgym_destroy(SfgymEnv* env) {
+    delete env;
+}
+
+int sfgym_reset(SfgymEnv* env, unsigned int seed) {
+    if (!env) return SFGYM_ERROR;
+    env->setup.seed = seed;
+    env->game.startHeadlessMatch(env->setup);
+    return 0;
+}
+
+int sfgym_step(SfgymEnv* env, unsigned short p1_action, unsigned short p2_action, float* rewards) {
+    if (!env) return SFGYM_ERROR;
+    Game& game = env->game;
+    if (rewards) {
+        rewards[0] = 0.0f;
+        rewards[1] = 0.0f;
+    }
+    if (game.currentGameState == GameState::MATCH_OVER) return SFGYM_TERMINATED;
+    if (env->setup.maxTicks > 0 && game.matchTick >= env->setup.maxTicks) return SFGYM_TRUNCATED;
+
+    bool wasPlaying = (game.currentGameState == GameState::PLAYING);
+    int healthBefore[2] = {game.players[0].health, game.players[1].health};
+
+    TickInput input;
+    input.buttons[0] = p1_action & SFGYM_ACTION_MASK;
+    input.buttons[1] = p2_action & SFGYM_ACTION_MASK;
+    game.simulateMatchTick(input, FIXED_DELTA_TIME);
+
+    // 只在回合進行中計算血量變化 (新回合開始時血量會重置)
+    if (rewards && wasPlaying) {
+        float p1Change = static_cast<float>(game.players[0].health - healthBefore[0]);
+        float p2Change = static_cast<float>(game.players[1].health - healthBefore[1]);
+        float reward = (p1Change - p2Change) / PLAYER_DEFAULT_HEALTH;
+        if (game.currentGameState != GameState::PLAYING) {
+            if (game.roundWinnerIndex == 0) reward += 1.0f;
+            else if (game.roundWinnerIndex == 1) reward -= 1.0f;
+        }
+        rewards[0] = reward;
+        rewards[1] = -reward;
+    }
+
+    if (game.currentGameState == GameState::MATCH_OVER) return SFGYM_TERMINATED;
+    if (env->setup.maxTicks > 0 && game.matchTick >= env->setup.maxTicks) return SFGYM_TRUNCATED;
+    return SFGYM_RUNNING;
+}
+
+int sfgym_observe(const SfgymEnv* env, int player, float* obs, int capacity) {
+    if (!env || !obs || (player != 0 && player != 1) || capacity < SFGYM_OBS_SIZE) return SFGYM_ERROR;
+    const Game& game = env->game;
+    const Player& self = game.players[player];
+    const Player& opponent = game.players[1 - player];
+
+    writeFighter(self, obs);
+    writeFighter(opponent, obs + SFGYM_OBS_FIGHTER_SIZE);
+
+    float* round = obs + SFGYM_OBS_ROUND_OFFSET;
+    round[SFGYM_OBS_ROUND_TIME] = game.roundTimer.remainingSeconds(game.matchTick) / ROUND_TIME_LIMIT;
+    round[SFGYM_OBS_ROUND_NUMBER] = static_cast<float>(game.currentRound);
+    round[SFGYM_OBS_SELF_WINS] = static_cast<float>(game.playerWins[player]);
+    round[SFGYM_OBS_OPPONENT_WINS] = static_cast<float>(game.playerWins[1 - player]);
+    round[SFGYM_OBS_ROUND_ACTIVE] = (game.currentGameState == GameState::PLAYING) ? 1.0f : 0.0f;
+    round[SFGYM_OBS_CONTROLS_REVERSED] =
+        (game.isChaosMode && game.chaos.modifiers().reverseControls > 0) ? 1.0f : 0.0f;
+
+    // 最近的幾個氣功 (依與自己中心的水平距離)，不足的欄位補 0
+    Projectile nearest[SFGYM_OBS_PROJECTILE_SLOTS];
+    float nearestDistance[SFGYM_OBS_PROJECTILE_SLOTS] = {};
+    int found = 0;
+    float selfCenterX = self.x + self.logicWidth / 2.0f;
+    for (int p = 0; p < game.world.projectiles.size(); ++p) {
+        const Projectile proj = game.world.projectiles.get(p);
+        if (!proj.isActive) continue;
+        float distance = std::fabs(proj.x + PROJECTILE_HITBOX_W / 2.0f - selfCenterX);
+        int slot = found < SFGYM_OBS_PROJECTILE_SLOTS ? found++ : SFGYM_OBS_PROJECTILE_SLOTS;
+        if (slot == SFGYM_OBS_PROJECTILE_SLOTS) {
+            if (distance >= nearestDistance[SFGYM_OBS_PROJECTILE_SLOTS - 1]) continue;
+            slot = SFGYM_OBS_PROJECTILE_SLOTS - 1;
+        }
+        // 插入排序 (欄位很少)
+        while (slot > 0 && nearestDistance[slot - 1] > distance) {
+            nearest[slot] = nearest[slot - 1];
+            nearestDistance[slot] = nearestDistance[slot - 1];
+            --slot;
+        }
+        nearest[slot] = proj;
+        nearestDistance[slot] = distance;
+    }
+    for (int i = 0; i < SFGYM_OBS_PROJECTILE_SLOTS; ++i) {
+        float* out = obs + SFGYM_OBS_PROJECTILE_OFFSET + i * SFGYM_OBS_PROJECTILE_SIZE;
+        const Projectile* proj = (i < found) ? &nearest[i] : nullptr;
+        out[SFGYM_OBS_PROJECTILE_ACTIVE] = proj ? 1.0f : 0.0f;
+        out[SFGYM_OBS_PROJECTILE_X] = proj ? proj->x / SCREEN_WIDTH : 0.0f;
+        out[SFGYM_OBS_PROJECTILE_Y] = proj ? proj->y / SCREEN_HEIGHT : 0.0f;
+        out[SFGYM_OBS_PROJECTILE_DIRECTION] = proj ? (proj->vx >= 0.0f ? 1.0f : -1.0f) : 0.0f;
+        out[SFGYM_OBS_PROJECTILE_OWN] = (proj && proj->ownerPlayerIndex == player) ? 1.0f : 0.0f;
+    }
+    return SFGYM_OBS_SIZE;
+}
+
+unsigned int sfgym_tick(const SfgymEnv* env) {
+    return env ? env->game.matchTick : 0;
+}
+
+int sfgym_winner(const SfgymEnv* env) {
+    if (!env || env->game.currentGameState != GameState::MATCH_OVER) return -1;
+    return env->game.roundWinnerIndex;
+}
+
+} // extern "C"
@@ -0,0 +1,135 @@
+#ifndef GYM_API_H
+#define GYM_API_H
+
+/*
+ * --- Gym 風格的 C API (共享函式庫 sfgym) ---
+ * 包裝無畫面模擬 (Game/Player 的正式規則)，讓 Python (ctypes) 等工具直接驅動一場比賽：
+ * 不經過 SDL 事件與渲染迴圈，觀測值直接寫進呼叫端提供的 float 緩衝區 (不額外複製)。
+ * 介面只用 C 型別，版本號改變才會破壞相容性。
+ *
+ * 用法：sfgym_create -> (sfgym_reset -> 重複 sfgym_step/sfgym_observe 直到結束) -> sfgym_destroy
+ * 同一個 env 不可同時被多個執行緒使用；不同 env 可以各自在不同執行緒。
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define SFGYM_API __declspec(dllexport)
+#else
+#define SFGYM_API __attribute__((visibility("default")))
+#endif
+
+#define SFGYM_API_VERSION 1
+
+/* --- 動作：與鍵盤輸入相同的按鍵位元 (Input.h 的 InputButton) --- */
+enum SfgymAction {
+    SFGYM_ACTION_LEFT            = 1 << 0,
+    SFGYM_ACTION_RIGHT           = 1 << 1,
+    SFGYM_ACTION_UP              = 1 << 2,
+    SFGYM_ACTION_DOWN            = 1 << 3,
+    SFGYM_ACTION_ATTACK          = 1 << 4,
+    SFGYM_ACTION_FIRE            = 1 << 5,
+    SFGYM_ACTION_BLOCK           = 1 << 6,
+    SFGYM_ACTION_FIRE_PRESSED    = 1 << 7, /* 按下瞬間：發射氣功 */
+    SFGYM_ACTION_SPECIAL_PRESSED = 1 << 8  /* 按下瞬間：特殊技能 */
+};
+
+/* --- sfgym_step 的回傳值 --- */
+enum SfgymStatus {
+    SFGYM_ERROR      = -1,
+    SFGYM_RUNNING    = 0,
+    SFGYM_TERMINATED = 1, /* 比賽結束 (有人贏得比賽) */
+    SFGYM_TRUNCATED  = 2  /* 達到 max_ticks 上限 */
+};
+
+/* --- 觀測值排列 (以 sfgym_observe 指定的玩家為「自己」) ---
+ * [自己的角色資料][對手的角色資料][回合資料][最近的氣功 x SFGYM_OBS_PROJECTILE_SLOTS]
+ * 位置除以螢幕寬高、速度除以移動速度/跳躍力道、血量除以最大血量，計時器為剩餘秒數。 */
+enum SfgymFighterObs {
+    SFGYM_OBS_X,                      /* 左上角 x / 螢幕寬 */
+    SFGYM_OBS_Y,                      /* 左上角 y / 螢幕高 */
+    SFGYM_OBS_VX,
+    SFGYM_OBS_VY,
+    SFGYM_OBS_HEALTH,
+    SFGYM_OBS_DIRECTION,              /* 1: 面向右, -1: 面向左 */
+    SFGYM_OBS_STATE,                  /* Player::PlayerState 的數值 */
+    SFGYM_OBS_ON_GROUND,
+    SFGYM_OBS_ATTACK_TIMER,
+    SFGYM_OBS_ATTACK_RATE_COOLDOWN,
+    SFGYM_OBS_BLOCK_COOLDOWN,
+    SFGYM_OBS_PROJECTILE_COOLDOWN,
+    SFGYM_OBS_SPECIAL_COOLDOWN,
+    SFGYM_OBS_HURT_TIMER,
+    SFGYM_OBS_INVINCIBILITY_TIMER,
+    SFGYM_OBS_SPECIAL_ATTACKING,
+    SFGYM_OBS_CHARACTER,              /* 0: BlockMan, 1: Godon */
+    SFGYM_OBS_GLOVE,                  /* 0: 10oz, 1: 14oz, 2: 18oz */
+    SFGYM_OBS_FIGHTER_SIZE
+};
+
+enum SfgymRoundObs {
+    SFGYM_OBS_ROUND_TIME,             /* 剩餘時間 / 回合時間上限 */
+    SFGYM_OBS_ROUND_NUMBER,
+    SFGYM_OBS_SELF_WINS,
+    SFGYM_OBS_OPPONENT_WINS,
+    SFGYM_OBS_ROUND_ACTIVE,           /* 1: 回合進行中, 0: 回合/比賽結束畫面 */
+    SFGYM_OBS_CONTROLS_REVERSED,      /* 混亂模式的鍵位反轉是否生效 */
+    SFGYM_OBS_ROUND_SIZE
+};
+
+enum SfgymProjectileObs {
+    SFGYM_OBS_PROJECTILE_ACTIVE,      /* 0 表示這個欄位沒有氣功 (其餘為 0) */
+    SFGYM_OBS_PROJECTILE_X,
+    SFGYM_OBS_PROJECTILE_Y,
+    SFGYM_OBS_PROJECTILE_DIRECTION,
+    SFGYM_OBS_PROJECTILE_OWN,         /* 1: 自己發射的 */
+    SFGYM_OBS_PROJECTILE_SIZE
+};
+
+#define SFGYM_OBS_PROJECTILE_SLOTS 4  /* 依與自己的水平距離排序，取最近的幾個 */
+#define SFGYM_OBS_ROUND_OFFSET (2 * SFGYM_OBS_FIGHTER_SIZE)
+#define SFGYM_OBS_PROJECTILE_OFFSET (SFGYM_OBS_ROUND_OFFSET + SFGYM_OBS_ROUND_SIZE)
+#define SFGYM_OBS_SIZE (SFGYM_OBS_PROJECTILE_OFFSET + SFGYM_OBS_PROJECTILE_SLOTS * SFGYM_OBS_PROJECTILE_SIZE)
+
+/* --- 比賽設定 --- */
+typedef struct SfgymConfig {
+    int character[2];      /* 0: BlockMan, 1: Godon */
+    int glove[2];          /* 0: 10oz, 1: 14oz, 2: 18oz */
+    int chaos_mode;        /* 非 0 時啟用混亂模式 */
+    unsigned int seed;     /* 混亂事件的種子 (sfgym_reset 可以換) */
+    unsigned int max_ticks; /* 單場 tick 上限，0 表示不限制 */
+} SfgymConfig;
+
+typedef struct SfgymEnv SfgymEnv;
+
+SFGYM_API int sfgym_api_version(void);
+SFGYM_API int sfgym_observation_size(void);
+SFGYM_API void sfgym_default_config(SfgymConfig* config);
+
+/* config 為 NULL 時使用預設值；設定不合法時回傳 NULL */
+SFGYM_API SfgymEnv* sfgym_create(const SfgymConfig* config);
+SFGYM_API void sfgym_destroy(SfgymEnv* env);
+
+/* 重新開始一場比賽 (第一回合)，回傳 0；env 為 NULL 時回傳 SFGYM_ERROR */
+SFGYM_API int sfgym_reset(SfgymEnv* env, unsigned int seed);
+
+/* 推進一個模擬 tick (1/60 秒)。rewards 可為 NULL，否則寫入雙方的獎勵：
+ * 本 tick 造成的傷害減去受到的傷害 (除以最大血量)，贏得回合再 +1、輸掉 -1 (雙方相加為 0)。
+ * 比賽已結束時不再推進，直接回傳結束狀態 (獎勵為 0)。 */
+SFGYM_API int sfgym_step(SfgymEnv* env, unsigned short p1_action, unsigned short p2_action, float* rewards);
+
+/* 以 player (0: P1, 1: P2) 的視角把觀測值寫進 obs，capacity 至少要 SFGYM_OBS_SIZE。
+ * 回傳寫入的 float 數，參數錯誤時回傳 SFGYM_ERROR。 */
+SFGYM_API int sfgym_observe(const SfgymEnv* env, int player, float* obs, int capacity);
+
+/* 比賽資訊：已模擬的 tick 數、勝利者 (0/1，比賽未結束或平手為 -1) */
+SFGYM_API unsigned int sfgym_tick(const SfgymEnv* env);
+SFGYM_API int sfgym_winner(const SfgymEnv* env);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GYM_API_H */
@@ -0,0 +1,64 @@
+#include "Headless.h"
+#include "CharacterTraits.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+// 角色名稱不分大小寫 (blockman / godon)
+bool parseCharacter(const char* name, std::string& out) {
+    int index = findCharacterIndex(name);
+    if (index < 0) {
+        printf("Headless: unknown character %s (use blockman or godon)\n", name);
+        return false;
+    }
+    out = CHARACTER_TRAITS[index].id;
+    return true;
+}
+
+// 拳套可以寫盎司數 (10/14/18) 或索引 (0/1/2)
+int parseGlove(const char* value) {
+    int oz = atoi(value);
+    return (oz == 14 || oz == 1) ? 1 : (oz == 18 || oz == 2) ? 2 : 0;
+}
+
+} // namespace
+
+bool parseHeadlessArgs(int argc, char* argv[], HeadlessConfig& out) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "--headless") == 0) {
+            out.enabled = true;
+        } else if (strcmp(arg, "--matches") == 0 && hasValue) {
+            out.matches = atoi(argv[++i]);
+        } else if (strcmp(arg, "--p1") == 0 && hasValue) {
+            if (!parseCharacter(argv[++i], out.match.characterIds[0])) return false;
+        } else if (strcmp(arg, "--p2") == 0 && hasValue) {
+            if (!parseCharacter(argv[++i], out.match.characterIds[1])) return false;
+        } else if (strcmp(arg, "--glove1") == 0 && hasValue) {
+            out.match.gloveIndex[0] = parseGlove(argv[++i]);
+        } else if (strcmp(arg, "--glove2") == 0 && hasValue) {
+            out.match.gloveIndex[1] = parseGlove(argv[++i]);
+        } else if (strcmp(arg, "--players") == 0 && hasValue) {
+            out.match.playerCount = atoi(argv[++i]);
+        } else if (strcmp(arg, "--seed") == 0 && hasValue) {
+            out.match.seed = static_cast<Uint32>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(arg, "--max-ticks") == 0 && hasValue) {
+            out.match.maxTicks = static_cast<Uint32>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(arg, "--verbose") == 0) {
+            out.verbose = true;
+        } else if (strcmp(arg, "--chaos") == 0) {
+            out.match.chaosMode = true;
+        }
+    }
+
+    if (out.match.playerCount < 2 || out.match.playerCount > MAX_PLAYERS) {
+        printf("Headless: --players must be between 2 and %d\n", MAX_PLAYERS);
+        return false;
+    }
+    if (out.matches < 1) out.matches = 1;
+    if (out.match.maxTicks < 1) out.match.maxTicks = 1;
+    return true;
+}
@@ -0,0 +1,31 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <SDL2/SDL.h>
+#include <string>
+#include "Constants.h"
+
+// --- 單場無畫面比賽的設定 ---
+struct HeadlessMatchSetup {
+    int playerCount = 2;                              // 3、4 人為大亂鬥 (只剩一人存活時回合結束)
+    std::string characterIds[MAX_PLAYERS] = {"BlockMan", "Godon", "BlockMan", "Godon"};
+    int gloveIndex[2] = {0, 0};                       // 0: 10oz, 1: 14oz, 2: 18oz (P3、P4 沿用 P1、P2 的拳套)
+    bool chaosMode = false;
+    Uint32 seed = 1;                                  // AI 與混亂事件共用的種子
+    Uint32 maxTicks = SIM_TICK_RATE * 60 * 10;        // 保險：AI 卡住時強制結束該場
+};
+
+// --- 無畫面模擬設定 (由命令列參數填入) ---
+// 不建立視窗、渲染器與音訊裝置，只跑模擬 (玩家、氣功、碰撞、回合、混亂事件)，
+// 由腳本 AI 操控雙方，用於自動化測試與平衡性批次對戰。
+struct HeadlessConfig {
+    bool enabled = false;
+    int matches = 10;                                 // 要跑幾場比賽
+    HeadlessMatchSetup match;                         // 第 n 場使用 match.seed + n
+    bool verbose = false;                             // 印出每場結果與模擬過程的除錯訊息
+};
+
+// 解析命令列參數 (--headless 等)，回傳 false 表示參數錯誤
+bool parseHeadlessArgs(int argc, char* argv[], HeadlessConfig& out);
+
+#endif // HEADLESS_H
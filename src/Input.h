@@ -0,0 +1,44 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <SDL2/SDL.h>
+#include "Constants.h"
+
+// --- 玩家輸入位元 (實體按鍵，尚未套用混亂模式的反轉) ---
+// 持續按壓的按鍵每個 tick 重新取樣；*_PRESSED 則是按下瞬間的事件，只作用於一個 tick
+enum InputButton : Uint16 {
+    INPUT_LEFT            = 1 << 0,
+    INPUT_RIGHT           = 1 << 1,
+    INPUT_UP              = 1 << 2,
+    INPUT_DOWN            = 1 << 3,
+    INPUT_ATTACK          = 1 << 4,
+    INPUT_FIRE            = 1 << 5,
+    INPUT_BLOCK           = 1 << 6,
+    INPUT_FIRE_PRESSED    = 1 << 7,
+    INPUT_SPECIAL_PRESSED = 1 << 8
+};
+
+// 按下瞬間的事件位元 (被模擬 tick 消耗後清除)
+const Uint16 INPUT_EDGE_MASK = INPUT_FIRE_PRESSED | INPUT_SPECIAL_PRESSED;
+
+// 選單專用的動作位元：只在選單畫面由 InputMap::eventActions 查詢，不會寫進 TickInput
+const Uint16 INPUT_MENU_CONFIRM = 1 << 15;
+const Uint16 INPUT_MENU_MASK = INPUT_MENU_CONFIRM;
+
+// --- 混亂模式「控制反轉」：左右、上下、普攻/氣功兩兩互換 ---
+// 互換的位元都是相鄰的一對 (偶數位元 <-> 下一個奇數位元)，用一次位元置換完成，其餘位元不變
+const Uint16 INPUT_REVERSE_LOW_BITS = INPUT_LEFT | INPUT_UP | INPUT_ATTACK;
+const Uint16 INPUT_REVERSE_HIGH_BITS = INPUT_RIGHT | INPUT_DOWN | INPUT_FIRE;
+
+inline Uint16 reverseInputButtons(Uint16 buttons) {
+    return static_cast<Uint16>((buttons & ~(INPUT_REVERSE_LOW_BITS | INPUT_REVERSE_HIGH_BITS)) |
+                               ((buttons & INPUT_REVERSE_LOW_BITS) << 1) |
+                               ((buttons & INPUT_REVERSE_HIGH_BITS) >> 1));
+}
+
+// --- 單一模擬 tick 的所有玩家輸入 (重播只需要記錄這個) ---
+struct TickInput {
+    Uint16 buttons[MAX_PLAYERS] = {}; // 索引 0 為 P1, 1 為 P2 (大亂鬥時 2、3 為 P3、P4)
+};
+
+#endif // INPUT_H
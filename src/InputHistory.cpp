@@ -0,0 +1,83 @@
+#include "InputHistory.h"
+#include "Input.h"
+
+const MotionCommand MOTION_COMMANDS[MOTION_COMMAND_COUNT] = {
+    {"quarter-circle-forward", {2, 3, 6}, 3, INPUT_ATTACK},
+};
+
+int inputDirection(Uint16 buttons, int facing) {
+    int x = (buttons & INPUT_LEFT) ? -1 : ((buttons & INPUT_RIGHT) ? 1 : 0); // 左右都按時以左為準 (跟移動一致)
+    int y = (buttons & INPUT_UP) ? 1 : ((buttons & INPUT_DOWN) ? -1 : 0);
+    return 5 + x * facing + 3 * y;
+}
+
+void InputHistory::clear() {
+    *this = InputHistory();
+}
+
+void InputHistory::record(Uint32 tick, Uint16 state) {
+    if (count > 0 && latest() == state) return;
+    ticks[count % INPUT_HISTORY_LENGTH] = tick;
+    buttons[count % INPUT_HISTORY_LENGTH] = state;
+    ++count;
+}
+
+Uint16 InputHistory::latest() const {
+    return count > 0 ? buttonsAt(0) : 0;
+}
+
+namespace {
+
+// 第 age 筆是否是 button 的按下 (這筆有、上一筆沒有；沒有上一筆時是回合的第一筆)
+bool isPressEntry(const InputHistory& h, int age, Uint16 button) {
+    if (!(h.buttonsAt(age) & button)) return false;
+    if (age + 1 < h.size()) return !(h.buttonsAt(age + 1) & button);
+    return h.count <= static_cast<Uint32>(INPUT_HISTORY_LENGTH); // 更舊的一筆已經被覆蓋時無法判斷，當作不是
+}
+
+} // namespace
+
+bool InputHistory::pressedAt(Uint16 button, Uint32 now) const {
+    return count > 0 && tickAt(0) == now && isPressEntry(*this, 0, button);
+}
+
+bool InputHistory::findBufferedPress(Uint16 button, Uint32 now, int window, Uint32& pressTick) const {
+    if (window > INPUT_HISTORY_LENGTH - 2) window = INPUT_HISTORY_LENGTH - 2; // 視窗內每個 tick 都可能寫入一筆
+    // 由新到舊，最多走過視窗內的筆數
+    for (int age = 0; age < size(); ++age) {
+        Uint32 t = tickAt(age);
+        if (now - t > static_cast<Uint32>(window < 0 ? 0 : window)) return false;
+        if (!isPressEntry(*this, age, button)) continue;
+        if (consumedPress == t + 1) return false; // 最近一次按下已經觸發過，更早的按下也不算
+        pressTick = t;
+        return true;
+    }
+    return false;
+}
+
+void InputHistory::consumePress(Uint16 button, Uint32 now, int window) {
+    Uint32 pressTick;
+    if (findBufferedPress(button, now, window, pressTick)) consumedPress = pressTick + 1;
+}
+
+void InputHistory::advanceMotions(Uint32 now, int direction) {
+    for (int i = 0; i < MOTION_COMMAND_COUNT; ++i) {
+        const MotionCommand& motion = MOTION_COMMANDS[i];
+        Uint8& step = motionStep[i];
+        // 兩步之間隔太久就重來
+        if (step > 0 && now - motionStepTick[i] > MOTION_STEP_TICKS) step = 0;
+        if (step < motion.length && direction == motion.sequence[step]) {
+            ++step;
+            motionStepTick[i] = now;
+        } else if (step > 0 && step < motion.length && direction == motion.sequence[step - 1]) {
+            motionStepTick[i] = now; // 還按著上一步的方向
+        } else if (direction == motion.sequence[0]) {
+            step = 1;
+            motionStepTick[i] = now;
+        }
+    }
+}
+
+bool InputHistory::isMotionReady(int motion, Uint32 now) const {
+    return motionStep[motion] == MOTION_COMMANDS[motion].length && now - motionStepTick[motion] <= MOTION_STEP_TICKS;
+}
@@ -0,0 +1,59 @@
+#ifndef INPUT_HISTORY_H
+#define INPUT_HISTORY_H
+
+#include <SDL2/SDL.h>
+#include "Constants.h"
+
+// --- 搓招 (方向輸入序列 + 按鍵) ---
+// 方向使用數字鍵盤記法，以角色面向為準：1 後下、2 下、3 前下、4 後、5 不動、6 前、7 後上、8 上、9 前上
+struct MotionCommand {
+    const char* name;
+    Uint8 sequence[4];
+    int length;
+    Uint16 button;       // 序列完成後要按下的鍵 (InputButton)
+};
+
+// 目前只有一招：下、前下、前 + 普攻 = 特殊技能 (跟 I / 小鍵盤 5 相同)
+const int MOTION_QUARTER_CIRCLE_FORWARD = 0;
+const int MOTION_COMMAND_COUNT = 1;
+extern const MotionCommand MOTION_COMMANDS[MOTION_COMMAND_COUNT];
+
+// 按鍵與角色面向 -> 數字鍵盤方向 (上下同時按時以上為準)
+int inputDirection(Uint16 buttons, int facing);
+
+// --- 每位玩家的輸入記錄 ---
+// 固定大小的環狀緩衝區，只在按鍵狀態改變時寫入一筆 (tick, 按鍵)，不配置記憶體。
+// 跟著玩家存進快照，重播跳轉與連線回滾還原後緩衝輸入與搓招的進度都一致。
+struct InputHistory {
+    Uint32 ticks[INPUT_HISTORY_LENGTH] = {};
+    Uint16 buttons[INPUT_HISTORY_LENGTH] = {};
+    Uint32 count = 0;          // 總共寫入過的筆數 (最新一筆在 (count - 1) % INPUT_HISTORY_LENGTH)
+    Uint32 consumedPress = 0;  // 已經觸發過動作的那次按下 (tick + 1，0 表示沒有)
+    // 每一招的進度：已經輸入到序列的第幾步、上一步的 tick (每個 tick 只前進一次，常數時間)
+    Uint8 motionStep[MOTION_COMMAND_COUNT] = {};
+    Uint32 motionStepTick[MOTION_COMMAND_COUNT] = {};
+
+    void clear();
+    // 記錄這個 tick 的按鍵 (每個 tick 呼叫一次，跟上一筆相同時不寫入)
+    void record(Uint32 tick, Uint16 state);
+    Uint16 latest() const;
+    int size() const { return count < static_cast<Uint32>(INPUT_HISTORY_LENGTH) ? static_cast<int>(count) : INPUT_HISTORY_LENGTH; }
+    // 第 age 新的一筆 (0 為最新)
+    Uint32 tickAt(int age) const { return ticks[(count - 1 - age) % INPUT_HISTORY_LENGTH]; }
+    Uint16 buttonsAt(int age) const { return buttons[(count - 1 - age) % INPUT_HISTORY_LENGTH]; }
+
+    // button 是否正好在 now 這個 tick 按下
+    bool pressedAt(Uint16 button, Uint32 now) const;
+    // 最近 window 個 tick 內 (含 now) 最後一次按下 button、而且還沒觸發過動作，寫入按下的 tick
+    bool findBufferedPress(Uint16 button, Uint32 now, int window, Uint32& pressTick) const;
+    // 動作已經開始：最近 window 個 tick 內那次按下不再觸發第二次
+    void consumePress(Uint16 button, Uint32 now, int window);
+
+    // 以這個 tick 的方向推進每一招的進度
+    void advanceMotions(Uint32 now, int direction);
+    // 序列已經完成 (最後一步在 MOTION_STEP_TICKS 內)
+    bool isMotionReady(int motion, Uint32 now) const;
+    void resetMotion(int motion) { motionStep[motion] = 0; }
+};
+
+#endif // INPUT_HISTORY_H
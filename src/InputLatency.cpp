@@ -0,0 +1,97 @@
+#include "InputLatency.h"
+#include <cstdlib>
+
+void parseLatencyArgs(int argc, char* argv[], LatencyOptions& out) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--latency-csv" && i + 1 < argc) {
+            out.csvPath = argv[++i];
+            out.overlay = true;
+        } else if (arg == "--frame-delay" && i + 1 < argc) {
+            int ms = atoi(argv[++i]);
+            out.frameDelayMs = ms < 0 ? 0 : ms;
+        } else if (arg == "--latency-overlay") {
+            out.overlay = true;
+        }
+    }
+}
+
+InputLatencyMonitor::InputLatencyMonitor() {
+    for (int i = 0; i < LATENCY_WINDOW; ++i) {
+        eventToTickWindow[i] = 0.0f;
+        tickToPresentWindow[i] = 0.0f;
+    }
+}
+
+InputLatencyMonitor::~InputLatencyMonitor() {
+    closeCsv();
+}
+
+bool InputLatencyMonitor::openCsv(const std::string& path) {
+    closeCsv();
+    csv = fopen(path.c_str(), "w");
+    if (!csv) {
+        printf("Latency: cannot open %s\n", path.c_str());
+        return false;
+    }
+    fprintf(csv, "tick,event_to_tick_ms,tick_to_present_ms,event_to_present_ms\n");
+    printf("Latency: writing measurements to %s\n", path.c_str());
+    return true;
+}
+
+void InputLatencyMonitor::closeCsv() {
+    if (csv) {
+        fclose(csv);
+        csv = nullptr;
+    }
+}
+
+void InputLatencyMonitor::onInputEvent(Uint32 arrivalMs) {
+    if (!hasPendingEvent || SDL_TICKS_PASSED(pendingArrivalMs, arrivalMs)) {
+        pendingArrivalMs = arrivalMs;
+    }
+    hasPendingEvent = true;
+}
+
+void InputLatencyMonitor::onTickLatched(Uint32 tick) {
+    if (!hasPendingEvent) return;
+    hasPendingEvent = false;
+    if (frameSampleCount >= MAX_SIM_STEPS_PER_FRAME) return;
+    PendingSample& sample = frameSamples[frameSampleCount++];
+    sample.tick = tick;
+    sample.eventToTickMs = static_cast<float>(SDL_GetTicks() - pendingArrivalMs);
+    sample.latchedAt = SDL_GetPerformanceCounter();
+}
+
+void InputLatencyMonitor::onPresent() {
+    if (frameSampleCount == 0) return;
+    Uint64 now = SDL_GetPerformanceCounter();
+    double counterToMs = 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+    for (int i = 0; i < frameSampleCount; ++i) {
+        const PendingSample& sample = frameSamples[i];
+        float tickToPresentMs = static_cast<float>((now - sample.latchedAt) * counterToMs);
+        eventToTickWindow[windowNext] = sample.eventToTickMs;
+        tickToPresentWindow[windowNext] = tickToPresentMs;
+        windowNext = (windowNext + 1) % LATENCY_WINDOW;
+        if (windowCount < LATENCY_WINDOW) ++windowCount;
+        if (csv) {
+            fprintf(csv, "%u,%.0f,%.3f,%.3f\n", sample.tick, sample.eventToTickMs, tickToPresentMs,
+                    sample.eventToTickMs + tickToPresentMs);
+        }
+    }
+    frameSampleCount = 0;
+}
+
+float InputLatencyMonitor::getAverageEventToTickMs() const {
+    if (windowCount == 0) return 0.0f;
+    float sum = 0.0f;
+    for (int i = 0; i < windowCount; ++i) sum += eventToTickWindow[i];
+    return sum / windowCount;
+}
+
+float InputLatencyMonitor::getAverageTickToPresentMs() const {
+    if (windowCount == 0) return 0.0f;
+    float sum = 0.0f;
+    for (int i = 0; i < windowCount; ++i) sum += tickToPresentWindow[i];
+    return sum / windowCount;
+}
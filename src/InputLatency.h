@@ -0,0 +1,65 @@
+#ifndef INPUT_LATENCY_H
+#define INPUT_LATENCY_H
+
+#include <SDL2/SDL.h>
+#include <cstdio>
+#include <string>
+#include "Constants.h"
+
+// --- 輸入延遲量測 ---
+// 事件進入 SDL 佇列時 SDL 會記下時間 (event.common.timestamp，毫秒)。模擬 tick 取樣輸入時，
+// 之前收到、還沒被取樣的事件都算這個 tick 處理的：
+//   事件 -> tick：最早那個事件的到達時間到 tick 取樣的時間
+//   tick -> 畫面：tick 取樣到 SDL_RenderPresent 返回 (開啟垂直同步時包含等待 vsync 的時間)
+// 只有真的有輸入變化的 tick 才產生一筆資料。
+
+struct LatencyOptions {
+    std::string csvPath;   // --latency-csv <檔案>：每筆量測寫一列 CSV
+    int frameDelayMs = 0;  // --frame-delay <毫秒>：畫面送出後先等待再取樣輸入 (延後取樣)
+    bool overlay = false;  // --latency-overlay：啟動時就顯示畫面上的延遲數字 (遊戲中按 F3 切換)
+};
+void parseLatencyArgs(int argc, char* argv[], LatencyOptions& out);
+
+class InputLatencyMonitor {
+public:
+    InputLatencyMonitor();
+    ~InputLatencyMonitor();
+
+    bool openCsv(const std::string& path);
+    void closeCsv();
+
+    // 收到一個改變玩家按鍵的事件 (arrivalMs 為 SDL 事件的 timestamp)
+    void onInputEvent(Uint32 arrivalMs);
+    // 模擬 tick 取樣輸入
+    void onTickLatched(Uint32 tick);
+    // 這個畫面已經送出 (SDL_RenderPresent 返回之後呼叫)
+    void onPresent();
+
+    int getSampleCount() const { return windowCount; }
+    float getAverageEventToTickMs() const;
+    float getAverageTickToPresentMs() const;
+
+    bool overlayEnabled = false;
+
+private:
+    struct PendingSample {
+        Uint32 tick = 0;
+        float eventToTickMs = 0.0f;
+        Uint64 latchedAt = 0; // SDL_GetPerformanceCounter
+    };
+
+    bool hasPendingEvent = false;
+    Uint32 pendingArrivalMs = 0;      // 還沒被取樣的事件中最早的到達時間
+    PendingSample frameSamples[MAX_SIM_STEPS_PER_FRAME]; // 這個畫面中有輸入的 tick (等畫面送出才完成)
+    int frameSampleCount = 0;
+
+    // 最近 LATENCY_WINDOW 筆，畫面上顯示平均值
+    float eventToTickWindow[LATENCY_WINDOW];
+    float tickToPresentWindow[LATENCY_WINDOW];
+    int windowCount = 0;
+    int windowNext = 0;
+
+    FILE* csv = nullptr;
+};
+
+#endif // INPUT_LATENCY_H
@@ -0,0 +1,309 @@
+#include "InputMap.h"
+#include <fstream>
+#include <cstdio>
+
+namespace {
+
+// 設定檔裡的動作名稱
+struct ActionName {
+    const char* name;
+    Uint16 action;
+};
+
+const ActionName ACTION_NAMES[] = {
+    {"left", INPUT_LEFT},
+    {"right", INPUT_RIGHT},
+    {"up", INPUT_UP},
+    {"down", INPUT_DOWN},
+    {"attack", INPUT_ATTACK},
+    {"fire", INPUT_FIRE | INPUT_FIRE_PRESSED}, // 按住蓄力、按下瞬間發射
+    {"block", INPUT_BLOCK},
+    {"special", INPUT_SPECIAL_PRESSED},
+    {"confirm", INPUT_MENU_CONFIRM} // 選單確認
+};
+
+InputBinding keyBinding(int player, SDL_Scancode scancode, Uint16 action) {
+    InputBinding binding;
+    binding.device = INPUT_DEVICE_KEY;
+    binding.code = static_cast<Sint16>(scancode);
+    binding.player = static_cast<Sint8>(player);
+    binding.action = action;
+    return binding;
+}
+
+InputBinding padButtonBinding(SDL_GameControllerButton button, Uint16 action) {
+    InputBinding binding;
+    binding.device = INPUT_DEVICE_PAD_BUTTON;
+    binding.code = static_cast<Sint16>(button);
+    binding.action = action;
+    return binding;
+}
+
+InputBinding padAxisBinding(SDL_GameControllerAxis axis, int sign, Uint16 action) {
+    InputBinding binding;
+    binding.device = INPUT_DEVICE_PAD_AXIS;
+    binding.code = static_cast<Sint16>(axis);
+    binding.axisSign = static_cast<Sint8>(sign);
+    binding.action = action;
+    return binding;
+}
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+// 解析 "p1.left = A"、"pad.left = -leftx" 這樣的一列
+bool parseBinding(const std::string& line, InputBinding& out) {
+    size_t equals = line.find('=');
+    size_t dot = line.find('.');
+    if (equals == std::string::npos || dot == std::string::npos || dot > equals) return false;
+    std::string owner = trim(line.substr(0, dot));
+    std::string actionName = trim(line.substr(dot + 1, equals - dot - 1));
+    std::string input = trim(line.substr(equals + 1));
+    if (input.empty()) return false;
+
+    out = InputBinding();
+    out.action = 0;
+    for (const ActionName& entry : ACTION_NAMES) {
+        if (actionName == entry.name) out.action = entry.action;
+    }
+    if (out.action == 0) return false;
+
+    if (owner == "pad") {
+        int sign = 0;
+        if (input[0] == '+' || input[0] == '-') {
+            sign = (input[0] == '+') ? 1 : -1;
+            input = input.substr(1);
+        }
+        if (sign != 0) {
+            SDL_GameControllerAxis axis = SDL_GameControllerGetAxisFromString(input.c_str());
+            if (axis == SDL_CONTROLLER_AXIS_INVALID) return false;
+            out.device = INPUT_DEVICE_PAD_AXIS;
+            out.code = static_cast<Sint16>(axis);
+            out.axisSign = static_cast<Sint8>(sign);
+        } else {
+            SDL_GameControllerButton button = SDL_GameControllerGetButtonFromString(input.c_str());
+            if (button == SDL_CONTROLLER_BUTTON_INVALID) return false;
+            out.device = INPUT_DEVICE_PAD_BUTTON;
+            out.code = static_cast<Sint16>(button);
+        }
+        return true;
+    }
+
+    // p1 ~ p4：鍵盤 (SDL 的 scancode 名稱，例如 "A"、"Left"、"Keypad 4")
+    if (owner.size() != 2 || owner[0] != 'p' || owner[1] < '1' || owner[1] >= '1' + MAX_PLAYERS) return false;
+    SDL_Scancode scancode = SDL_GetScancodeFromName(input.c_str());
+    if (scancode == SDL_SCANCODE_UNKNOWN) return false;
+    out.device = INPUT_DEVICE_KEY;
+    out.code = static_cast<Sint16>(scancode);
+    out.player = static_cast<Sint8>(owner[1] - '1');
+    return true;
+}
+
+std::vector<InputBinding> defaultConfirmBindings() {
+    return {
+        keyBinding(0, SDL_SCANCODE_RETURN, INPUT_MENU_CONFIRM),
+        keyBinding(1, SDL_SCANCODE_KP_ENTER, INPUT_MENU_CONFIRM),
+        padButtonBinding(SDL_CONTROLLER_BUTTON_START, INPUT_MENU_CONFIRM)
+    };
+}
+
+} // namespace
+
+InputMap::InputMap() {
+    for (SDL_GameController*& pad : gamepads) pad = nullptr;
+    setDefaults();
+}
+
+void InputMap::setDefaults() {
+    const Uint16 FIRE = INPUT_FIRE | INPUT_FIRE_PRESSED;
+    bindings = {
+        // Player 1 (WASD + J/U/K/I)
+        keyBinding(0, SDL_SCANCODE_A, INPUT_LEFT),
+        keyBinding(0, SDL_SCANCODE_D, INPUT_RIGHT),
+        keyBinding(0, SDL_SCANCODE_W, INPUT_UP),
+        keyBinding(0, SDL_SCANCODE_S, INPUT_DOWN),
+        keyBinding(0, SDL_SCANCODE_J, INPUT_ATTACK),
+        keyBinding(0, SDL_SCANCODE_U, FIRE),
+        keyBinding(0, SDL_SCANCODE_K, INPUT_BLOCK),
+        keyBinding(0, SDL_SCANCODE_I, INPUT_SPECIAL_PRESSED),
+        // Player 2 (方向鍵 + 小鍵盤 1/4/2/5)
+        keyBinding(1, SDL_SCANCODE_LEFT, INPUT_LEFT),
+        keyBinding(1, SDL_SCANCODE_RIGHT, INPUT_RIGHT),
+        keyBinding(1, SDL_SCANCODE_UP, INPUT_UP),
+        keyBinding(1, SDL_SCANCODE_DOWN, INPUT_DOWN),
+        keyBinding(1, SDL_SCANCODE_KP_1, INPUT_ATTACK),
+        keyBinding(1, SDL_SCANCODE_KP_4, FIRE),
+        keyBinding(1, SDL_SCANCODE_KP_2, INPUT_BLOCK),
+        keyBinding(1, SDL_SCANCODE_KP_5, INPUT_SPECIAL_PRESSED),
+        // 手把 (十字鍵或左搖桿 + A/X/B/Y)
+        padButtonBinding(SDL_CONTROLLER_BUTTON_DPAD_LEFT, INPUT_LEFT),
+        padButtonBinding(SDL_CONTROLLER_BUTTON_DPAD_RIGHT, INPUT_RIGHT),
+        padButtonBinding(SDL_CONTROLLER_BUTTON_DPAD_UP, INPUT_UP),
+        padButtonBinding(SDL_CONTROLLER_BUTTON_DPAD_DOWN, INPUT_DOWN),
+        padAxisBinding(SDL_CONTROLLER_AXIS_LEFTX, -1, INPUT_LEFT),
+        padAxisBinding(SDL_CONTROLLER_AXIS_LEFTX, 1, INPUT_RIGHT),
+        padAxisBinding(SDL_CONTROLLER_AXIS_LEFTY, -1, INPUT_UP),
+        padAxisBinding(SDL_CONTROLLER_AXIS_LEFTY, 1, INPUT_DOWN),
+        padButtonBinding(SDL_CONTROLLER_BUTTON_A, INPUT_ATTACK),
+        padButtonBinding(SDL_CONTROLLER_BUTTON_X, FIRE),
+        padButtonBinding(SDL_CONTROLLER_BUTTON_B, INPUT_BLOCK),
+        padButtonBinding(SDL_CONTROLLER_BUTTON_Y, INPUT_SPECIAL_PRESSED)
+    };
+    // 選單確認 (P1 Enter、P2 小鍵盤 Enter、手把 Start)
+    std::vector<InputBinding> confirm = defaultConfirmBindings();
+    bindings.insert(bindings.end(), confirm.begin(), confirm.end());
+}
+
+bool InputMap::loadFromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    std::vector<InputBinding> loaded;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        if (trim(line).empty()) continue;
+        InputBinding binding;
+        if (!parseBinding(line, binding)) {
+            printf("Controls: %s:%d: cannot parse \"%s\", keeping current bindings\n", path.c_str(), lineNumber, trim(line).c_str());
+            return false;
+        }
+        loaded.push_back(binding);
+    }
+    // 舊的設定檔沒有選單確認鍵：沿用預設的確認鍵，不然選角畫面會無法確認
+    bool hasConfirm = false;
+    for (const InputBinding& binding : loaded) {
+        if (binding.action & INPUT_MENU_CONFIRM) hasConfirm = true;
+    }
+    if (!hasConfirm) {
+        for (const InputBinding& binding : defaultConfirmBindings()) loaded.push_back(binding);
+    }
+    bindings.swap(loaded);
+    printf("Controls: loaded %zu bindings from %s\n", bindings.size(), path.c_str());
+    return true;
+}
+
+void InputMap::sampleHeld(TickInput& input) const {
+    const Uint8* keystates = SDL_GetKeyboardState(NULL);
+    Uint16 held[MAX_PLAYERS] = {};
+    for (const InputBinding& binding : bindings) {
+        Uint16 action = binding.action & ~(INPUT_EDGE_MASK | INPUT_MENU_MASK);
+        if (action == 0) continue;
+        if (binding.device == INPUT_DEVICE_KEY) {
+            if (keystates[binding.code]) held[binding.player] |= action;
+            continue;
+        }
+        for (int i = 0; i < MAX_PLAYERS; ++i) {
+            SDL_GameController* pad = gamepads[i];
+            if (!pad) continue;
+            bool down;
+            if (binding.device == INPUT_DEVICE_PAD_BUTTON) {
+                down = SDL_GameControllerGetButton(pad, static_cast<SDL_GameControllerButton>(binding.code)) != 0;
+            } else {
+                int value = SDL_GameControllerGetAxis(pad, static_cast<SDL_GameControllerAxis>(binding.code));
+                down = value * binding.axisSign > GAMEPAD_AXIS_THRESHOLD;
+            }
+            if (down) held[i] |= action;
+        }
+    }
+    // 保留尚未被模擬消耗的按下事件，其餘位元每次重新取樣 (大亂鬥的 P3、P4 之後會被 AI 的決定覆蓋)
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        input.buttons[i] = (input.buttons[i] & INPUT_EDGE_MASK) | held[i];
+    }
+}
+
+bool InputMap::handleEvent(const SDL_Event& event, TickInput& input) {
+    if (event.type == SDL_CONTROLLERDEVICEADDED) {
+        openGamepad(event.cdevice.which);
+        return false;
+    }
+    if (event.type == SDL_CONTROLLERDEVICEREMOVED) {
+        int player = findGamepadPlayer(event.cdevice.which);
+        if (player >= 0) {
+            SDL_GameControllerClose(gamepads[player]);
+            gamepads[player] = nullptr;
+            printf("Controls: gamepad for P%d removed\n", player + 1);
+        }
+        return false;
+    }
+
+    // --- 按下/放開：按下時加入按下瞬間的位元 ---
+    bool mapped = false;
+    if ((event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) && !event.key.repeat) {
+        for (const InputBinding& binding : bindings) {
+            if (binding.device != INPUT_DEVICE_KEY || binding.code != event.key.keysym.scancode) continue;
+            if (!(binding.action & ~INPUT_MENU_MASK)) continue; // 選單確認不是對戰中的按鍵
+            mapped = true;
+            if (event.type == SDL_KEYDOWN) input.buttons[binding.player] |= binding.action & INPUT_EDGE_MASK;
+        }
+    } else if (event.type == SDL_CONTROLLERBUTTONDOWN || event.type == SDL_CONTROLLERBUTTONUP) {
+        int player = findGamepadPlayer(event.cbutton.which);
+        if (player < 0) return false;
+        for (const InputBinding& binding : bindings) {
+            if (binding.device != INPUT_DEVICE_PAD_BUTTON || binding.code != event.cbutton.button) continue;
+            if (!(binding.action & ~INPUT_MENU_MASK)) continue;
+            mapped = true;
+            if (event.type == SDL_CONTROLLERBUTTONDOWN) input.buttons[player] |= binding.action & INPUT_EDGE_MASK;
+        }
+    }
+    return mapped;
+}
+
+Uint16 InputMap::eventActions(const SDL_Event& event, int player) const {
+    Uint16 actions = 0;
+    if ((event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) && !event.key.repeat) {
+        for (const InputBinding& binding : bindings) {
+            if (binding.device == INPUT_DEVICE_KEY && binding.player == player &&
+                binding.code == event.key.keysym.scancode) {
+                actions |= binding.action;
+            }
+        }
+    } else if (event.type == SDL_CONTROLLERBUTTONDOWN || event.type == SDL_CONTROLLERBUTTONUP) {
+        if (findGamepadPlayer(event.cbutton.which) != player) return 0;
+        for (const InputBinding& binding : bindings) {
+            if (binding.device == INPUT_DEVICE_PAD_BUTTON && binding.code == event.cbutton.button) {
+                actions |= binding.action;
+            }
+        }
+    }
+    return actions;
+}
+
+bool InputMap::isPressEvent(const SDL_Event& event) {
+    return event.type == SDL_KEYDOWN || event.type == SDL_CONTROLLERBUTTONDOWN;
+}
+
+void InputMap::openGamepad(int deviceIndex) {
+    if (!SDL_IsGameController(deviceIndex)) return;
+    SDL_JoystickID id = SDL_JoystickGetDeviceInstanceID(deviceIndex);
+    if (findGamepadPlayer(id) >= 0) return; // 啟動時已經開過的手把也會收到 ADDED 事件
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        if (gamepads[i]) continue;
+        gamepads[i] = SDL_GameControllerOpen(deviceIndex);
+        if (gamepads[i]) {
+            printf("Controls: gamepad \"%s\" controls P%d\n", SDL_GameControllerName(gamepads[i]), i + 1);
+        }
+        return;
+    }
+}
+
+int InputMap::findGamepadPlayer(SDL_JoystickID id) const {
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        if (gamepads[i] && SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(gamepads[i])) == id) return i;
+    }
+    return -1;
+}
+
+void InputMap::closeGamepads() {
+    for (SDL_GameController*& pad : gamepads) {
+        if (pad) SDL_GameControllerClose(pad);
+        pad = nullptr;
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef INPUT_MAP_H
+#define INPUT_MAP_H
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include "Constants.h"
+#include "Input.h"
+
+// --- 實體按鍵 -> 玩家輸入位元的對應表 ---
+// 鍵盤 (scancode) 與手把 (SDL_GameController 的按鈕/搖桿) 都只是表裡的一列，取樣時依序走過整張表，
+// 把按下的列的 action 位元 OR 進該玩家的 TickInput.buttons。重播與連線對戰記錄的就是這個結果。
+// action 裡的持續位元 (INPUT_LEFT ...) 每個 tick 重新取樣；按下瞬間的位元 (INPUT_*_PRESSED) 只在
+// 按下的事件發生時加入。
+// 預設是原本寫死的鍵位，可以用設定檔 (見 controls.cfg) 覆蓋。選單的上下移動與確認也查同一張表。
+
+enum InputDevice : Uint8 {
+    INPUT_DEVICE_KEY = 0,        // 鍵盤，code 為 SDL_Scancode
+    INPUT_DEVICE_PAD_BUTTON = 1, // 手把按鈕，code 為 SDL_GameControllerButton
+    INPUT_DEVICE_PAD_AXIS = 2    // 手把搖桿/扳機，code 為 SDL_GameControllerAxis，axisSign 為方向
+};
+
+struct InputBinding {
+    Uint8 device = INPUT_DEVICE_KEY;
+    Sint16 code = 0;
+    Sint8 axisSign = 1; // 只有搖桿使用：1 往正方向推、-1 往負方向推
+    Sint8 player = 0;   // 鍵盤的列屬於哪位玩家；手把的列套用到每一支手把 (手把 i 控制玩家 i)
+    Uint16 action = 0;  // InputButton 位元
+};
+
+class InputMap {
+public:
+    InputMap();
+
+    void setDefaults();
+    // 讀取設定檔，成功時整張表換成檔案內容；檔案不存在或有錯誤時保留原本的表並回傳 false
+    bool loadFromFile(const std::string& path);
+
+    // 依目前的鍵盤/手把狀態重新取樣持續按壓的位元 (保留尚未被模擬消耗的按下瞬間位元)
+    void sampleHeld(TickInput& input) const;
+    // 處理按鍵/手把按鈕按下的事件，加入按下瞬間的位元；也處理手把的插拔。
+    // 回傳這個事件是否改變了某位玩家的按鍵 (有綁定的按下或放開，用來量測輸入延遲)
+    bool handleEvent(const SDL_Event& event, TickInput& input);
+    // 按鍵/手把按鈕的按下或放開事件對應到 player 的哪些動作位元 (含選單專用位元；作業系統的重複事件不算)。
+    // 選單的移動與確認都從這裡查，所以 controls.cfg 的鍵位也適用於選單
+    Uint16 eventActions(const SDL_Event& event, int player) const;
+    static bool isPressEvent(const SDL_Event& event); // 按鍵或手把按鈕按下
+
+    void closeGamepads();
+    const std::vector<InputBinding>& getBindings() const { return bindings; }
+
+private:
+    void openGamepad(int deviceIndex);
+    int findGamepadPlayer(SDL_JoystickID id) const; // 手把控制的玩家 (-1 表示沒有)
+
+    std::vector<InputBinding> bindings;
+    SDL_GameController* gamepads[MAX_PLAYERS]; // 第 i 支手把控制玩家 i
+};
+
+#endif // INPUT_MAP_H
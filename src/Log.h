@@ -0,0 +1,13 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdio.h> // for printf
+
+// --- 模擬過程的除錯訊息 ---
+// 每個 tick 或每個動作都可能觸發的訊息用 DEBUG_LOG 輸出，
+// 無視窗模式大量模擬時關閉 (logVerbose = false)，避免主控台輸出拖慢模擬。
+inline bool logVerbose = true;
+
+#define DEBUG_LOG(...) do { if (logVerbose) printf(__VA_ARGS__); } while (0)
+
+#endif // LOG_H
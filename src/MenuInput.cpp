@@ -0,0 +1,52 @@
+#include "MenuInput.h"
+#include "Constants.h"
+#include "InputMap.h"
+
+MenuInput::MenuInput() {
+    reset();
+}
+
+void MenuInput::reset() {
+    for (RepeatState& state : states) {
+        state = RepeatState();
+    }
+}
+
+void MenuInput::press(RepeatState& state, int direction, Uint32 now) {
+    state.heldDirection = direction;
+    state.nextRepeatAt = now + MENU_REPEAT_DELAY_MS;
+    state.pendingSteps += direction;
+}
+
+void MenuInput::handleEvent(const SDL_Event& event, const InputMap& inputMap, Uint32 now) {
+    bool pressed = InputMap::isPressEvent(event);
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        Uint16 actions = inputMap.eventActions(event, i); // 作業系統的重複事件回傳 0
+        int direction = (actions & INPUT_UP) ? -1 : (actions & INPUT_DOWN) ? 1 : 0;
+        if (direction == 0) continue;
+        RepeatState& state = states[i];
+        if (pressed) {
+            press(state, direction, now);
+        } else if (state.heldDirection == direction) {
+            state.heldDirection = 0; // 放開的是目前在重複的鍵
+        }
+    }
+}
+
+void MenuInput::update(Uint32 now) {
+    for (RepeatState& state : states) {
+        if (state.heldDirection == 0) continue;
+        // 畫面卡住很久時最多補一格，不會一次跳過好幾個選項
+        if (SDL_TICKS_PASSED(now, state.nextRepeatAt)) {
+            state.pendingSteps += state.heldDirection;
+            state.nextRepeatAt = now + MENU_REPEAT_INTERVAL_MS;
+        }
+    }
+}
+
+int MenuInput::takeSteps(int player) {
+    if (player < 0 || player >= PLAYER_COUNT) return 0;
+    int steps = states[player].pendingSteps;
+    states[player].pendingSteps = 0;
+    return steps;
+}
@@ -0,0 +1,36 @@
+#ifndef MENU_INPUT_H
+#define MENU_INPUT_H
+
+#include <SDL2/SDL.h>
+
+class InputMap;
+
+// --- 選單的上下移動 (角色選擇、拳套選擇) ---
+// 上/下由 InputMap 查出 (各玩家綁定 up/down 的按鍵或手把按鈕，controls.cfg 改鍵位也適用)。
+// 按下立即移動一格；持續按住時，等 MENU_REPEAT_DELAY_MS 後每 MENU_REPEAT_INTERVAL_MS 再移動一格。
+// 每位玩家有自己的重複計時器，以畫面時鐘 (SDL_GetTicks 毫秒) 計算，不會讓整個迴圈停下來，
+// 兩位玩家可以同時操作。作業系統的按鍵重複事件 (event.key.repeat) 一律忽略，速度只由這裡決定。
+class MenuInput {
+public:
+    static const int PLAYER_COUNT = 2; // 選單只有 P1 與 P2 操作
+
+    MenuInput();
+
+    void reset(); // 切換畫面時呼叫：放棄累積的移動，按住的鍵要重新按下才會再移動
+    void handleEvent(const SDL_Event& event, const InputMap& inputMap, Uint32 now);
+    void update(Uint32 now); // 每個畫面呼叫一次，產生按住時的自動重複
+    int takeSteps(int player); // 取出累積的移動 (負數往上、正數往下)
+
+private:
+    struct RepeatState {
+        int heldDirection = 0;  // -1: 按住上, 1: 按住下, 0: 沒有按
+        Uint32 nextRepeatAt = 0; // 下一次自動重複的時間 (毫秒)
+        int pendingSteps = 0;
+    };
+
+    void press(RepeatState& state, int direction, Uint32 now);
+
+    RepeatState states[PLAYER_COUNT];
+};
+
+#endif // MENU_INPUT_H
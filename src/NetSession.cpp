@@ -0,0 +1,527 @@
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "NetSession.h"
+#include "Constants.h"
+#include "StateHash.h"
+#include "CharacterTraits.h"
+#include <stdio.h>   // for printf
+#include <cstring>   // for strcmp, memcpy
+#include <cstdlib>   // for atoi
+#include <ctime>     // for time
+#include <iterator>  // for std::prev
+
+namespace {
+
+const Uint32 NET_MAGIC = 0x504E4653; // "SFNP"
+const Uint8 PACKET_HELLO = 1;
+const Uint8 PACKET_INPUT = 2;
+const Uint8 PACKET_STATE = 3;
+const Uint32 NET_HELLO_INTERVAL_MS = 100;
+const int NET_MAX_INPUTS_PER_PACKET = 64;
+const int NET_CHECKSUMS_PER_PACKET = 8;  // 每個封包附上最近幾個 tick 的雜湊 (遺失時由後面的封包補上)
+const size_t NET_CHECKSUM_HISTORY = 256; // 保留多少個 tick 的本地雜湊與狀態
+const int NET_STATE_RESENDS = 5;         // 不同步時完整狀態重送次數
+const int NET_MAX_PACKET_SIZE = 1400;
+
+// --- 封包讀寫 (固定小端序) ---
+void writeU8(std::vector<Uint8>& out, Uint8 v) { out.push_back(v); }
+void writeU16(std::vector<Uint8>& out, Uint16 v) {
+    out.push_back(static_cast<Uint8>(v & 0xFF));
+    out.push_back(static_cast<Uint8>(v >> 8));
+}
+void writeU32(std::vector<Uint8>& out, Uint32 v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<Uint8>((v >> (i * 8)) & 0xFF));
+}
+
+struct PacketReader {
+    const Uint8* data;
+    int size;
+    int pos = 0;
+    bool ok = true;
+
+    Uint8 u8() {
+        if (pos + 1 > size) { ok = false; return 0; }
+        return data[pos++];
+    }
+    Uint16 u16() {
+        if (pos + 2 > size) { ok = false; return 0; }
+        Uint16 v = static_cast<Uint16>(data[pos] | (data[pos + 1] << 8));
+        pos += 2;
+        return v;
+    }
+    Uint32 u32() {
+        if (pos + 4 > size) { ok = false; return 0; }
+        Uint32 v = 0;
+        for (int i = 0; i < 4; ++i) v |= static_cast<Uint32>(data[pos + i]) << (i * 8);
+        pos += 4;
+        return v;
+    }
+};
+
+// 預測對手輸入時只重複「按住」的按鍵，單次觸發的按鍵不會連續出現
+Uint16 predictFrom(Uint16 lastConfirmed) {
+    return static_cast<Uint16>(lastConfirmed & ~INPUT_EDGE_MASK);
+}
+
+} // namespace
+
+// --- 命令列參數 ---
+bool parseNetplayArgs(int argc, char* argv[], NetplayConfig& out) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "--netplay") == 0 && i + 2 < argc) {
+            // --netplay <本地埠> <對手位址:埠>
+            out.enabled = true;
+            out.localPort = atoi(argv[++i]);
+            std::string remote = argv[++i];
+            size_t colon = remote.rfind(':');
+            if (colon == std::string::npos) {
+                printf("Netplay: remote address must be host:port (got %s)\n", remote.c_str());
+                return false;
+            }
+            out.remoteHost = remote.substr(0, colon);
+            out.remotePort = atoi(remote.c_str() + colon + 1);
+            if (out.remoteHost == "localhost") out.remoteHost = "127.0.0.1";
+        } else if (strcmp(arg, "--player") == 0 && hasValue) {
+            out.localPlayerIndex = (atoi(argv[++i]) == 2) ? 1 : 0;
+        } else if (strcmp(arg, "--char") == 0 && hasValue) {
+            const char* name = argv[++i];
+            int index = findCharacterIndex(name);
+            out.characterIndex = (index < 0) ? 0 : index;
+        } else if (strcmp(arg, "--glove") == 0 && hasValue) {
+            int oz = atoi(argv[++i]);
+            out.gloveIndex = (oz == 14 || oz == 1) ? 1 : (oz == 18 || oz == 2) ? 2 : 0;
+        } else if (strcmp(arg, "--chaos") == 0) {
+            out.chaosMode = true;
+        } else if (strcmp(arg, "--input-delay") == 0 && hasValue) {
+            out.inputDelay = atoi(argv[++i]);
+        } else if (strcmp(arg, "--rollback") == 0 && hasValue) {
+            out.rollbackWindow = atoi(argv[++i]);
+        } else if (strcmp(arg, "--sim-latency") == 0 && hasValue) {
+            out.simLatencyMs = atoi(argv[++i]);
+        } else if (strcmp(arg, "--sim-jitter") == 0 && hasValue) {
+            out.simJitterMs = atoi(argv[++i]);
+        } else if (strcmp(arg, "--sim-loss") == 0 && hasValue) {
+            out.simLossPercent = atoi(argv[++i]);
+        }
+    }
+
+    if (out.inputDelay < 0) out.inputDelay = 0;
+    if (out.inputDelay > NET_MAX_INPUT_DELAY) out.inputDelay = NET_MAX_INPUT_DELAY;
+    if (out.rollbackWindow < 1) out.rollbackWindow = 1;
+    if (out.rollbackWindow > NET_MAX_ROLLBACK_WINDOW) out.rollbackWindow = NET_MAX_ROLLBACK_WINDOW;
+    if (out.simLossPercent < 0) out.simLossPercent = 0;
+    if (out.simLossPercent > 100) out.simLossPercent = 100;
+    return true;
+}
+
+NetSession::NetSession(const NetplayConfig& newConfig)
+    : config(newConfig), rng(static_cast<unsigned>(time(0)) ^ static_cast<unsigned>(newConfig.localPort)) {
+    localSeed = static_cast<Uint32>(rng()) | 1;
+    // 輸入延遲的前幾個 tick 沒有實際輸入，先補上空白
+    localInputs.assign(config.inputDelay, 0);
+}
+
+NetSession::~NetSession() {
+    if (!socketOpen) return;
+#ifdef _WIN32
+    closesocket(static_cast<SOCKET>(sock));
+    WSACleanup();
+#else
+    close(sock);
+#endif
+}
+
+bool NetSession::open() {
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        printf("Netplay: WSAStartup failed\n");
+        return false;
+    }
+    SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == INVALID_SOCKET) {
+        printf("Netplay: failed to create socket\n");
+        WSACleanup();
+        return false;
+    }
+    u_long nonBlocking = 1;
+    ioctlsocket(s, FIONBIO, &nonBlocking);
+    sock = static_cast<Uint64>(s);
+#else
+    sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        printf("Netplay: failed to create socket\n");
+        return false;
+    }
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+#endif
+    socketOpen = true;
+
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(static_cast<Uint16>(config.localPort));
+#ifdef _WIN32
+    if (bind(static_cast<SOCKET>(sock), reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+#else
+    if (bind(sock, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+#endif
+        printf("Netplay: failed to bind UDP port %d\n", config.localPort);
+        return false;
+    }
+
+    in_addr addr;
+    if (inet_pton(AF_INET, config.remoteHost.c_str(), &addr) != 1) {
+        printf("Netplay: invalid remote address %s\n", config.remoteHost.c_str());
+        return false;
+    }
+    remoteAddr = addr.s_addr;
+    remotePortN = htons(static_cast<Uint16>(config.remotePort));
+
+    printf("Netplay: listening on UDP %d, peer %s:%d, player %d, input delay %d, rollback window %d\n",
+           config.localPort, config.remoteHost.c_str(), config.remotePort, config.localPlayerIndex + 1,
+           config.inputDelay, config.rollbackWindow);
+    if (config.simLatencyMs > 0 || config.simJitterMs > 0 || config.simLossPercent > 0) {
+        printf("Netplay: simulating %d ms latency, %d ms jitter, %d%% loss on outgoing packets\n",
+               config.simLatencyMs, config.simJitterMs, config.simLossPercent);
+    }
+    return true;
+}
+
+// --- 傳送 ---
+void NetSession::sendRaw(const std::vector<Uint8>& data) {
+    if (!socketOpen) return;
+    sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = remoteAddr;
+    to.sin_port = remotePortN;
+#ifdef _WIN32
+    sendto(static_cast<SOCKET>(sock), reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size()), 0,
+           reinterpret_cast<sockaddr*>(&to), sizeof(to));
+#else
+    sendto(sock, data.data(), data.size(), 0, reinterpret_cast<sockaddr*>(&to), sizeof(to));
+#endif
+}
+
+void NetSession::sendPacket(const std::vector<Uint8>& data) {
+    // 人工封包遺失
+    if (config.simLossPercent > 0 && static_cast<int>(rng() % 100) < config.simLossPercent) {
+        return;
+    }
+    // 人工延遲 (抖動可能讓封包亂序，跟真實網路一樣)
+    if (config.simLatencyMs <= 0 && config.simJitterMs <= 0) {
+        sendRaw(data);
+        return;
+    }
+    Uint32 delay = static_cast<Uint32>(config.simLatencyMs);
+    if (config.simJitterMs > 0) delay += rng() % (config.simJitterMs + 1);
+    outgoing.push_back({SDL_GetTicks() + delay, data});
+}
+
+// --- 接收 ---
+void NetSession::poll() {
+    if (!socketOpen) return;
+
+    // 送出到時間的延遲封包
+    Uint32 now = SDL_GetTicks();
+    for (auto it = outgoing.begin(); it != outgoing.end();) {
+        if (static_cast<Sint32>(now - it->deliverAtMs) >= 0) {
+            sendRaw(it->data);
+            it = outgoing.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    Uint8 buffer[NET_MAX_PACKET_SIZE];
+    while (true) {
+        sockaddr_in from;
+#ifdef _WIN32
+        int fromLen = sizeof(from);
+        int received = recvfrom(static_cast<SOCKET>(sock), reinterpret_cast<char*>(buffer), sizeof(buffer), 0,
+                                reinterpret_cast<sockaddr*>(&from), &fromLen);
+#else
+        socklen_t fromLen = sizeof(from);
+        int received = static_cast<int>(recvfrom(sock, buffer, sizeof(buffer), 0,
+                                                 reinterpret_cast<sockaddr*>(&from), &fromLen));
+#endif
+        if (received <= 0) break;
+        // 只接受設定好的對手
+        if (from.sin_addr.s_addr != remoteAddr || from.sin_port != remotePortN) continue;
+        handlePacket(buffer, received);
+    }
+}
+
+void NetSession::handlePacket(const Uint8* data, int size) {
+    PacketReader in{data, size};
+    if (in.u32() != NET_MAGIC) return;
+    Uint8 type = in.u8();
+
+    if (type == PACKET_HELLO) {
+        Uint8 playerIndex = in.u8();
+        Uint8 characterIndex = in.u8();
+        Uint8 gloveIndex = in.u8();
+        Uint8 chaosMode = in.u8();
+        Uint8 gotOurHello = in.u8();
+        Uint32 seed = in.u32();
+        if (!in.ok) return;
+        if (playerIndex == config.localPlayerIndex) {
+            printf("Netplay: both peers chose player %d, use --player 1 and --player 2\n", playerIndex + 1);
+            return;
+        }
+        if (!remoteHelloReceived) {
+            printf("Netplay: peer found (character %d, glove %d)\n", characterIndex, gloveIndex);
+        }
+        remoteHelloReceived = true;
+        remoteGotOurHello = remoteGotOurHello || gotOurHello != 0;
+        remoteCharacterIndex = characterIndex;
+        remoteGloveIndex = gloveIndex;
+        // 隨機種子與混亂模式都以 P1 為準
+        if (config.localPlayerIndex == 0) {
+            matchSeed = localSeed;
+            matchChaosMode = config.chaosMode;
+        } else {
+            matchSeed = seed;
+            matchChaosMode = chaosMode != 0;
+        }
+        return;
+    }
+
+    if (type == PACKET_STATE) {
+        Uint32 tick = in.u32();
+        Uint16 stateSize = in.u16();
+        if (!in.ok || in.pos + stateSize > size || !desyncDiff.empty()) return;
+        std::vector<Uint8> remoteState(data + in.pos, data + in.pos + stateSize);
+        auto local = localChecksums.find(tick);
+        MatchSnapshot localSnapshot, remoteSnapshot;
+        if (local == localChecksums.end() || !deserializeSnapshot(local->second.state, localSnapshot) ||
+            !deserializeSnapshot(remoteState, remoteSnapshot)) {
+            return;
+        }
+        diffSnapshots(localSnapshot, remoteSnapshot, desyncDiff);
+        if (desyncDiff.empty()) desyncDiff.push_back("(no field differs)");
+        printf("Netplay: field diff at tick %u (local -> remote):\n", tick);
+        for (const std::string& line : desyncDiff) {
+            printf("  %s\n", line.c_str());
+        }
+        return;
+    }
+
+    if (type != PACKET_INPUT) return;
+
+    Uint32 senderTick = in.u32();
+    Uint32 ackPlusOne = in.u32();
+    Uint32 startTick = in.u32();
+    Uint8 count = in.u8();
+    if (!in.ok) return;
+
+    // 對手已經開始送輸入，代表握手完成 (我們的 HELLO 可能遺失了)
+    if (remoteHelloReceived) remoteGotOurHello = true;
+
+    remoteTick = senderTick;
+    int acked = static_cast<int>(ackPlusOne) - 1;
+    if (acked > remoteAckedLocalThrough) remoteAckedLocalThrough = acked;
+
+    for (int i = 0; i < count; ++i) {
+        Uint16 buttons = in.u16();
+        if (!in.ok) return;
+        int tick = static_cast<int>(startTick) + i;
+        if (tick != remoteConfirmedThrough + 1) continue; // 已收過或中間有缺口
+        remoteInputs.push_back(buttons);
+        remoteConfirmedThrough = tick;
+        // 這個 tick 已經用預測值模擬過，而且預測錯了 → 需要回滾
+        if (tick < static_cast<int>(usedRemoteInputs.size()) && usedRemoteInputs[tick] != buttons) {
+            if (rollbackTick < 0 || tick < rollbackTick) rollbackTick = tick;
+        }
+    }
+
+    Uint32 checksumTick = in.u32();
+    Uint8 checksumCount = in.u8();
+    for (int i = 0; i < checksumCount; ++i) {
+        Uint32 hash = in.u32();
+        if (!in.ok) return;
+        remoteChecksums[checksumTick + i] = hash;
+    }
+    Uint32 echoMs = in.u32();
+    Uint32 holdMs = in.u32();
+    Uint32 sendMs = in.u32();
+    if (!in.ok) return;
+
+    if (checksumCount > 0) {
+        compareChecksums();
+    }
+
+    Uint32 now = SDL_GetTicks();
+    if (echoMs != 0) {
+        Sint32 rtt = static_cast<Sint32>(now - echoMs - holdMs);
+        if (rtt >= 0) roundTripMs = (roundTripMs == 0) ? rtt : (roundTripMs * 7 + rtt) / 8;
+    }
+    lastRemoteSendMs = sendMs;
+    lastRemoteRecvMs = now;
+}
+
+// --- 握手 ---
+void NetSession::updateHandshake() {
+    if (connected) return;
+
+    Uint32 now = SDL_GetTicks();
+    if (lastHelloMs == 0 || now - lastHelloMs >= NET_HELLO_INTERVAL_MS) {
+        lastHelloMs = now;
+        std::vector<Uint8> packet;
+        writeU32(packet, NET_MAGIC);
+        writeU8(packet, PACKET_HELLO);
+        writeU8(packet, static_cast<Uint8>(config.localPlayerIndex));
+        writeU8(packet, static_cast<Uint8>(config.characterIndex));
+        writeU8(packet, static_cast<Uint8>(config.gloveIndex));
+        writeU8(packet, config.chaosMode ? 1 : 0);
+        writeU8(packet, remoteHelloReceived ? 1 : 0);
+        writeU32(packet, localSeed);
+        sendPacket(packet);
+    }
+
+    if (remoteHelloReceived && remoteGotOurHello) {
+        connected = true;
+        printf("Netplay: connected, match seed %u\n", matchSeed);
+    }
+}
+
+// --- 輸入 ---
+void NetSession::setLocalInput(Uint32 tick, Uint16 buttons) {
+    if (tick != localInputs.size()) return; // 已經設定過 (等待對手時重複呼叫)
+    localInputs.push_back(buttons);
+}
+
+TickInput NetSession::buildTickInput(Uint32 tick) {
+    Uint16 local = tick < localInputs.size() ? localInputs[tick] : 0;
+
+    Uint16 remote;
+    if (static_cast<int>(tick) <= remoteConfirmedThrough) {
+        remote = remoteInputs[tick];
+    } else {
+        remote = remoteInputs.empty() ? 0 : predictFrom(remoteInputs.back());
+    }
+    if (tick >= usedRemoteInputs.size()) usedRemoteInputs.resize(tick + 1, 0);
+    usedRemoteInputs[tick] = remote;
+
+    TickInput input;
+    input.buttons[config.localPlayerIndex] = local;
+    input.buttons[1 - config.localPlayerIndex] = remote;
+    return input;
+}
+
+int NetSession::takeRollbackTick() {
+    int tick = rollbackTick;
+    rollbackTick = -1;
+    return tick;
+}
+
+int NetSession::getFrameAdvantage(Uint32 localTick) const {
+    // 對手目前的 tick ≈ 封包上的 tick + 單程延遲
+    int oneWayTicks = (roundTripMs / 2) * SIM_TICK_RATE / 1000;
+    return static_cast<int>(localTick) - (static_cast<int>(remoteTick) + oneWayTicks);
+}
+
+void NetSession::sendInputs(Uint32 currentTick) {
+    if (!connected) return;
+
+    // 送出對手還沒確認的本地輸入 (遺失的封包由下一個封包補上)；
+    // 超過一個封包的量時先送最舊的，對手只接受緊接在已確認之後的 tick，跳過的缺口永遠補不上
+    int start = remoteAckedLocalThrough + 1;
+    int end = static_cast<int>(localInputs.size());
+    if (end - start > NET_MAX_INPUTS_PER_PACKET) end = start + NET_MAX_INPUTS_PER_PACKET;
+    if (start > end) start = end;
+
+    Uint32 now = SDL_GetTicks();
+    std::vector<Uint8> packet;
+    writeU32(packet, NET_MAGIC);
+    writeU8(packet, PACKET_INPUT);
+    writeU32(packet, currentTick);
+    writeU32(packet, static_cast<Uint32>(remoteConfirmedThrough + 1));
+    writeU32(packet, static_cast<Uint32>(start));
+    writeU8(packet, static_cast<Uint8>(end - start));
+    for (int tick = start; tick < end; ++tick) writeU16(packet, localInputs[tick]);
+    // 最近幾個 tick 的狀態雜湊 (連續的 tick)
+    auto first = localChecksums.end();
+    int checksumCount = 0;
+    while (first != localChecksums.begin() && checksumCount < NET_CHECKSUMS_PER_PACKET) {
+        auto prev = std::prev(first);
+        if (first != localChecksums.end() && prev->first + 1 != first->first) break;
+        first = prev;
+        ++checksumCount;
+    }
+    writeU32(packet, checksumCount > 0 ? first->first : 0);
+    writeU8(packet, static_cast<Uint8>(checksumCount));
+    for (auto it = first; it != localChecksums.end(); ++it) writeU32(packet, it->second.hash);
+    writeU32(packet, lastRemoteSendMs);
+    writeU32(packet, lastRemoteSendMs != 0 ? now - lastRemoteRecvMs : 0);
+    writeU32(packet, now);
+    sendPacket(packet);
+
+    if (desyncStateResends > 0) {
+        --desyncStateResends;
+        sendDesyncState();
+    }
+}
+
+// --- 不同步偵測 ---
+void NetSession::submitChecksum(Uint32 tick, Uint32 hash, const MatchSnapshot& snapshot) {
+    LocalChecksum& local = localChecksums[tick];
+    local.hash = hash;
+    serializeSnapshot(snapshot, local.state);
+    // 只保留最近的本地雜湊
+    while (localChecksums.size() > NET_CHECKSUM_HISTORY) localChecksums.erase(localChecksums.begin());
+    compareChecksums();
+}
+
+void NetSession::compareChecksums() {
+    for (auto it = remoteChecksums.begin(); it != remoteChecksums.end();) {
+        auto local = localChecksums.find(it->first);
+        if (local == localChecksums.end()) {
+            // 本地已經丟掉的舊 tick 不用再等
+            if (!localChecksums.empty() && it->first < localChecksums.begin()->first) {
+                it = remoteChecksums.erase(it);
+            } else {
+                ++it;
+            }
+            continue;
+        }
+        if (local->second.hash != it->second && !desyncDetected) {
+            desyncDetected = true;
+            desyncTick = it->first;
+            desyncStateResends = NET_STATE_RESENDS;
+            printf("Netplay: DESYNC detected at tick %u (local %08x, remote %08x)\n",
+                   it->first, local->second.hash, it->second);
+        }
+        it = remoteChecksums.erase(it);
+    }
+}
+
+void NetSession::sendDesyncState() {
+    auto local = localChecksums.find(desyncTick);
+    if (local == localChecksums.end()) return;
+    const std::vector<Uint8>& state = local->second.state;
+    if (state.size() + 16 > static_cast<size_t>(NET_MAX_PACKET_SIZE)) {
+        printf("Netplay: state at tick %u too large to send (%zu bytes)\n", desyncTick, state.size());
+        return;
+    }
+    std::vector<Uint8> packet;
+    writeU32(packet, NET_MAGIC);
+    writeU8(packet, PACKET_STATE);
+    writeU32(packet, desyncTick);
+    writeU16(packet, static_cast<Uint16>(state.size()));
+    packet.insert(packet.end(), state.begin(), state.end());
+    sendPacket(packet);
+}
@@ -0,0 +1,150 @@
+#ifndef NETSESSION_H
+#define NETSESSION_H
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <random>
+#include "Input.h"
+#include "Snapshot.h"
+
+// --- 連線對戰設定 (由命令列參數填入) ---
+struct NetplayConfig {
+    bool enabled = false;
+    int localPort = 7000;
+    std::string remoteHost = "127.0.0.1";
+    int remotePort = 7001;
+    int localPlayerIndex = 0;   // 0: P1 (左邊), 1: P2 (右邊)
+    int characterIndex = 0;     // 0: BlockMan, 1: Godon
+    int gloveIndex = 0;         // 0: 10oz, 1: 14oz, 2: 18oz
+    bool chaosMode = false;     // 以 P1 的設定為準
+    int inputDelay = 2;         // 本地輸入延遲 (tick)
+    int rollbackWindow = 8;     // 最多預測/回滾幾個 tick，超過就等待對手
+    // 人工網路狀況 (只作用於送出的封包)
+    int simLatencyMs = 0;
+    int simJitterMs = 0;
+    int simLossPercent = 0;
+};
+
+// 解析命令列參數 (--netplay 等)，回傳 false 表示參數錯誤
+bool parseNetplayArgs(int argc, char* argv[], NetplayConfig& out);
+
+// --- 連線對戰工作階段 ---
+// 負責 UDP 傳輸、握手、雙方輸入的交換與預測，以及不同步偵測。
+// 狀態保存與重新模擬 (rollback) 由 Game 執行，這裡只回報「從哪個 tick 開始預測錯了」。
+class NetSession {
+public:
+    explicit NetSession(const NetplayConfig& config);
+    ~NetSession();
+
+    // 建立並綁定 UDP socket
+    bool open();
+
+    // 接收所有封包，並送出人工延遲佇列中已到時間的封包
+    void poll();
+
+    // 握手：尚未連線時定期送出 HELLO
+    void updateHandshake();
+    bool isConnected() const { return connected; }
+
+    // 對手在握手時告知的設定
+    int getRemoteCharacterIndex() const { return remoteCharacterIndex; }
+    int getRemoteGloveIndex() const { return remoteGloveIndex; }
+    Uint32 getMatchSeed() const { return matchSeed; }
+    bool getChaosMode() const { return matchChaosMode; }
+    const NetplayConfig& getConfig() const { return config; }
+
+    // 設定本地玩家在 tick 的輸入 (已包含輸入延遲，必須依序設定)
+    void setLocalInput(Uint32 tick, Uint16 buttons);
+
+    // 組出 tick 的雙方輸入；對手的輸入若尚未收到就用預測值 (重複最後一個已確認的輸入)
+    TickInput buildTickInput(Uint32 tick);
+
+    // 取出最早預測錯誤的 tick (-1 表示不需要回滾)
+    int takeRollbackTick();
+
+    // 已連續收到對手輸入的最後一個 tick (-1 表示還沒有)
+    int getRemoteConfirmedThrough() const { return remoteConfirmedThrough; }
+
+    // 本地領先對手幾個 tick (用於節流，避免一方一直在回滾)
+    int getFrameAdvantage(Uint32 localTick) const;
+
+    // 送出尚未被確認的本地輸入
+    void sendInputs(Uint32 currentTick);
+
+    // 回報本地在 tick 的狀態雜湊 (雙方輸入都確認後)，與對手比對偵測不同步；
+    // 不同步時雙方會交換該 tick 的完整狀態，印出欄位層級的差異
+    void submitChecksum(Uint32 tick, Uint32 hash, const MatchSnapshot& snapshot);
+    bool hasDesync() const { return desyncDetected; }
+    Uint32 getDesyncTick() const { return desyncTick; }
+    const std::vector<std::string>& getDesyncDiff() const { return desyncDiff; }
+
+    int getRoundTripMs() const { return roundTripMs; }
+
+private:
+    struct PendingPacket {
+        Uint32 deliverAtMs;
+        std::vector<Uint8> data;
+    };
+
+    void sendPacket(const std::vector<Uint8>& data);      // 經過人工延遲/遺失
+    void sendRaw(const std::vector<Uint8>& data);         // 直接送出
+    void handlePacket(const Uint8* data, int size);
+    void compareChecksums();
+    void sendDesyncState();
+
+    NetplayConfig config;
+    bool socketOpen = false;
+#ifdef _WIN32
+    Uint64 sock = 0;        // SOCKET
+#else
+    int sock = -1;
+#endif
+    Uint32 remoteAddr = 0;  // 網路位元組順序
+    Uint16 remotePortN = 0; // 網路位元組順序
+
+    // 握手
+    bool connected = false;
+    bool remoteHelloReceived = false;
+    bool remoteGotOurHello = false;
+    Uint32 lastHelloMs = 0;
+    int remoteCharacterIndex = 0;
+    int remoteGloveIndex = 0;
+    Uint32 localSeed = 0;
+    Uint32 matchSeed = 0;
+    bool matchChaosMode = false;
+
+    // 輸入
+    std::vector<Uint16> localInputs;        // 索引為 tick
+    std::vector<Uint16> remoteInputs;       // 已收到的對手輸入 (連續)
+    std::vector<Uint16> usedRemoteInputs;   // 模擬時實際使用的對手輸入 (可能是預測值)
+    int remoteConfirmedThrough = -1;
+    int remoteAckedLocalThrough = -1;       // 對手已確認收到的本地輸入
+    int rollbackTick = -1;
+
+    // 時間同步
+    Uint32 remoteTick = 0;
+    Uint32 lastRemoteSendMs = 0;
+    Uint32 lastRemoteRecvMs = 0;
+    int roundTripMs = 0;
+
+    // 不同步偵測
+    struct LocalChecksum {
+        Uint32 hash = 0;
+        std::vector<Uint8> state;   // 序列化的快照 (不同步時送給對手比對)
+    };
+    std::map<Uint32, LocalChecksum> localChecksums;
+    std::map<Uint32, Uint32> remoteChecksums;
+    bool desyncDetected = false;
+    Uint32 desyncTick = 0;
+    int desyncStateResends = 0;             // 不同步時還要重送幾次完整狀態
+    std::vector<std::string> desyncDiff;    // 收到對手狀態後的欄位差異
+
+    // 人工網路狀況
+    std::deque<PendingPacket> outgoing;
+    std::mt19937 rng;
+};
+
+#endif // NETSESSION_H
@@ -2,18 +2,10 @@
 #include "TextureManager.h" // 需要使用 TextureManager
 #include "AnimationData.h" // 需要使用 AnimationDataManager
 #include "Constants.h"       // 需要核心常數
-#include "AudioManager.h"
 #include <cmath>                     // for fabsf
 #include <stdio.h>                   // for printf
-
-// 拳套相關的常數
-const float LIGHT_GLOVE_COOLDOWN = 0.8f;    // 10oz 拳套冷卻時間
-const float MEDIUM_GLOVE_COOLDOWN = 1.0f;   // 14oz 拳套冷卻時間
-const float HEAVY_GLOVE_COOLDOWN = 1.2f;    // 18oz 拳套冷卻時間
-
-const int LIGHT_GLOVE_DAMAGE = 8;          // 10oz 拳套傷害
-const int MEDIUM_GLOVE_DAMAGE = 10;         // 14oz 拳套傷害
-const int HEAVY_GLOVE_DAMAGE = 12;          // 18oz 拳套傷害
+#include "Log.h"                     // DEBUG_LOG
+#include "PlayerStateTable.h"        // 狀態轉換表
 
 Player::Player(float startX, float startY, int startDir,
                const std::string& charId, const std::string& texId) :
@@ -23,26 +15,18 @@ Player::Player(float startX, float startY, int startDir,
     state(PlayerState::IDLE),
     characterId(charId), textureId(texId),
     currentGlove(GloveType::LIGHT_10OZ),
-    attackTimer(0.0f), attackCooldownTimer(0.0f), hurtTimer(0.0f), invincibilityTimer(0.0f), blockCooldownTimer(0.0f),
-    attackRateCooldownTimer(0.0f),
-    projectileCooldownTimer(0.0f),
-    specialAttackCooldownTimer(0.0f),
     isOnGround(true),
     shouldFireProjectile(false),
-    currentFrame(0), frameTimer(0.0f),
     currentAnimationType(AnimationType::IDLE),
     isSpecialAttacking(false),
     hasHitDuringDash(false)
 {
-    // 根據角色設定尺寸
-    if (charId == "Godon") {
-        logicWidth = GODON_LOGIC_WIDTH;
-        logicHeight = GODON_LOGIC_HEIGHT;
-    } else { // BlockMan 或其他角色
-        logicWidth = BLOCKMAN_LOGIC_WIDTH;
-        logicHeight = BLOCKMAN_LOGIC_HEIGHT;
-    }
-    printf("Player created: CharacterID='%s', TextureID='%s', Size=%dx%d\n", 
+    // 查角色特性表 (未知的角色 ID 使用第一個角色的數值)
+    characterIndex = findCharacterIndex(charId);
+    if (characterIndex < 0) characterIndex = 0;
+    logicWidth = getTraits().logicWidth;
+    logicHeight = getTraits().logicHeight;
+    DEBUG_LOG("Player created: CharacterID='%s', TextureID='%s', Size=%dx%d\n", 
            characterId.c_str(), textureId.c_str(), logicWidth, logicHeight);
 }
 
@@ -50,11 +34,10 @@ Player::Player(float startX, float startY, int startDir,
 void Player::changeState(PlayerState newState) {
     if (state == newState) return; // 狀態沒變，不做事
     PlayerState oldState = state;
-    printf("[State] Player %s changing state from %d to %d\n",
+    DEBUG_LOG("[State] Player %s changing state from %d to %d\n",
     characterId.c_str(), static_cast<int>(oldState), static_cast<int>(newState));
     state = newState;
-    currentFrame = 0; // 重置動畫幀
-    frameTimer = 0.0f; // 重置幀計時器
+    stateEnteredTick = now(); // 動畫從第一幀重新開始
 
     // 根據新狀態設定對應的動畫類型
     switch (newState) {
@@ -72,111 +55,97 @@ void Player::changeState(PlayerState newState) {
     }
 }
 
-void Player::handleAction(const std::string& action) {
-    if (state == PlayerState::LYING && hurtTimer > 0) return;
-    if (action == "STOP_BLOCK" && state == PlayerState::BLOCKING) {
-        changeState(PlayerState::IDLE);
-        if (blockCooldownTimer <= 0) {
-            blockCooldownTimer = BLOCK_COOLDOWN;
-        }
-        return;
-    }
-    if (health <= 0 || state == PlayerState::HURT) return;
-
-    // --- 處理特殊攻擊 ---
-    if ((action == "SPECIAL_ATTACK" || action == "SPECIAL_ATTACK_NUMPAD") && 
-        canUseSpecialAttack() && 
-        state != PlayerState::ATTACKING && 
-        state != PlayerState::HURT && 
-        state != PlayerState::BLOCKING) {
-        attackTimer = ATTACK_DURATION;
-        specialAttackCooldownTimer = SPECIAL_ATTACK_COOLDOWN;
-        isSpecialAttacking = true;
-        hasHitDuringDash = false;
-        if (characterId == "Godon") {
-            // Godon 衝刺
-            vx = 700.0f * direction; // 衝刺速度
-            attackTimer = 1.0f; // 延長攻擊判定時間，確保有足夠時間撞到敵人
-        } else {
-            vx = 0;
-        }
-        changeState(PlayerState::ATTACKING);
-        return;
+void Player::executeCommands(Uint16 commands) {
+    // 由最低位元開始，一次取出一個指令
+    while (commands != 0) {
+        Uint16 command = static_cast<Uint16>(commands & (0u - commands));
+        commands = static_cast<Uint16>(commands & (commands - 1u));
+        executeCommand(static_cast<PlayerCommand>(command));
     }
+}
 
-    // --- 處理 LYING ---
-    if (action == "LYING" && isOnGround &&
-        state != PlayerState::ATTACKING && state != PlayerState::JUMPING &&
-        state != PlayerState::FALLING && state != PlayerState::BLOCKING && 
-        state != PlayerState::DEATH && state != PlayerState::HURT) {
-        vx = 0;
-        vy = 0;
-        changeState(PlayerState::LYING);
-        return;
-    }
+void Player::executeCommand(PlayerCommand command) {
+    // 目前狀態不允許這個指令 (查表)、被擊倒躺地中或沒有血量時不能行動
+    const PlayerStateTable::Transition& transition = PlayerStateTable::lookup(state, command);
+    if (!transition.allowed || (state == PlayerState::LYING && hurtTimer.isActive(now())) || health <= 0) return;
 
-    // --- 處理 BLOCK ---
-    if (action == "BLOCK" && isOnGround && blockCooldownTimer <= 0 &&
-        state != PlayerState::ATTACKING && state != PlayerState::JUMPING && state != PlayerState::FALLING) {
-        vx = 0;
-        changeState(PlayerState::BLOCKING);
-    }
-    // --- 處理氣功發射 ---
-    else if (action == "FIRE_PROJECTILE") {
-        if (canFireProjectile()) {
-            changeState(PlayerState::ATTACKING);
+    // 與狀態無關的條件與指令效果；條件不符就直接返回，不改變狀態
+    switch (command) {
+        case CMD_BLOCK:
+            if (!isOnGround || blockCooldownTimer.isActive(now())) return;
             vx = 0;
-            attackTimer = ATTACK_DURATION;
-            resetProjectileCooldown();
-            shouldFireProjectile = true;
-            std::string prefix = (characterId == "BlockMan") ? "blockman_fire" : "godon_fire";
-            AudioManager::playRandomSound(prefix);
-        }
-    }
-    // --- 處理其他動作 ---
-    else if (state != PlayerState::BLOCKING) {
-        if (action == "LEFT" && state != PlayerState::ATTACKING) {
-            vx = -MOVE_SPEED;
-            direction = -1;
-            if (isOnGround) changeState(PlayerState::WALKING);
-        }
-        else if (action == "RIGHT" && state != PlayerState::ATTACKING) {
-            vx = MOVE_SPEED;
-            direction = 1;
-            if (isOnGround) changeState(PlayerState::WALKING);
-        }
-        else if (action == "JUMP" && isOnGround && state != PlayerState::ATTACKING) {
+            break;
+        case CMD_STOP_BLOCK:
+            if (!blockCooldownTimer.isActive(now())) {
+                blockCooldownTimer.start(now(), secondsToTicks(BLOCK_COOLDOWN));
+            }
+            break;
+        case CMD_JUMP:
+            if (!isOnGround) return;
             vy = -JUMP_STRENGTH;
             isOnGround = false;
-            changeState(PlayerState::JUMPING);
-            AudioManager::playRandomSound("jump");
-            printf("Jump initiated - vy: %.2f, y: %.2f\n", vy, y); // 調試輸出
-        }
-        else if (action == "ATTACK" &&
-            state != PlayerState::ATTACKING &&
-            state != PlayerState::HURT &&
-            state != PlayerState::BLOCKING &&
-            attackCooldownTimer <= 0 &&
-            attackRateCooldownTimer <= 0 &&
-            !shouldFireProjectile) {
-            attackTimer = ATTACK_DURATION;
-            attackCooldownTimer = ATTACK_DURATION + getAttackCooldown();
-            attackRateCooldownTimer = ATTACK_RATE_COOLDOWN;
+            DEBUG_LOG("Jump initiated - vy: %.2f, y: %.2f\n", vy, y); // 調試輸出
+            break;
+        case CMD_ATTACK:
+            if (attackCooldownTimer.isActive(now()) || attackRateCooldownTimer.isActive(now()) || shouldFireProjectile) return;
+            attackTimer.start(now(), secondsToTicks(ATTACK_DURATION));
+            attackCooldownTimer.start(now(), secondsToTicks(ATTACK_DURATION + getAttackCooldown()));
+            attackRateCooldownTimer.start(now(), secondsToTicks(ATTACK_RATE_COOLDOWN));
             vx = 0;
             isSpecialAttacking = false;
-            changeState(PlayerState::ATTACKING);
-        }
-        else if (action == "STOP_X" && state == PlayerState::WALKING) {
+            break;
+        case CMD_LYING:
+            if (!isOnGround) return;
+            vx = 0;
+            vy = 0;
+            break;
+        case CMD_STAND_UP:
+            break;
+        case CMD_LEFT:
+        case CMD_RIGHT:
+            vx = ((command == CMD_LEFT) ? -MOVE_SPEED : MOVE_SPEED) * (chaosModifiers ? chaosModifiers->speedScale() : 1.0f);
+            direction = (command == CMD_LEFT) ? -1 : 1;
+            if (!isOnGround) return; // 空中只改變速度與方向
+            break;
+        case CMD_STOP_X:
+            vx = 0;
+            if (!isOnGround) return;
+            break;
+        case CMD_FIRE_PROJECTILE: {
+            if (!canFireProjectile()) return;
             vx = 0;
-            if (isOnGround) changeState(PlayerState::IDLE);
+            attackTimer.start(now(), secondsToTicks(ATTACK_DURATION));
+            resetProjectileCooldown();
+            shouldFireProjectile = true;
+            break;
         }
+        case CMD_SPECIAL_ATTACK:
+            if (!canUseSpecialAttack()) return;
+            attackTimer.start(now(), secondsToTicks(ATTACK_DURATION));
+            resetSpecialAttackCooldown();
+            isSpecialAttacking = true;
+            hasHitDuringDash = false;
+            if (getTraits().specialAttack == SpecialAttackType::DASH) {
+                // 衝刺
+                vx = getTraits().dashSpeed * direction;
+                attackTimer.start(now(), secondsToTicks(getTraits().dashDuration)); // 延長攻擊判定時間，確保有足夠時間撞到敵人
+            } else {
+                vx = 0;
+            }
+            break;
     }
+    if (transition.target == PlayerState::ATTACKING) blockedByMask = 0; // 新的一次攻擊
+    changeState(transition.target);
+    // 特殊技能的判定框跟普攻不同，換成技能自己的動畫
+    if (command == CMD_SPECIAL_ATTACK) currentAnimationType = AnimationType::SPECIAL;
 }
 
 void Player::update(float deltaTime) {
+    prevX = x;
+    prevY = y;
+
     // 處理 VICTORY 狀態
     if (state == PlayerState::VICTORY) {
-        updateAnimation(deltaTime);
         vx = 0;
         vy = 0;
         if (!isOnGround) {
@@ -186,28 +155,18 @@ void Player::update(float deltaTime) {
         return;
     }
 
-    // 處理死亡狀態
+    // 處理死亡狀態 (只播放動畫)
     if (state == PlayerState::DEATH) {
-        updateAnimation(deltaTime);
         return;
     }
 
-    // --- 更新計時器 ---
-    if (attackTimer > 0) attackTimer -= deltaTime;
-    if (attackCooldownTimer > 0) attackCooldownTimer -= deltaTime;
-    if (hurtTimer > 0) hurtTimer -= deltaTime;
-    if (invincibilityTimer > 0) invincibilityTimer -= deltaTime;
-    if (blockCooldownTimer > 0) blockCooldownTimer -= deltaTime;
-    if (attackRateCooldownTimer > 0) attackRateCooldownTimer -= deltaTime; 
-    if (projectileCooldownTimer > 0) projectileCooldownTimer -= deltaTime;
-    if (specialAttackCooldownTimer > 0) specialAttackCooldownTimer -= deltaTime;
-
-    // --- 狀態自動轉換 ---
-    if (state == PlayerState::ATTACKING && attackTimer <= 0) {
+    // --- 狀態自動轉換 (計時器只記錄到期 tick，不需要每個 tick 倒數) ---
+    const Uint32 tick = now();
+    if (state == PlayerState::ATTACKING && !attackTimer.isActive(tick)) {
         changeState(PlayerState::IDLE);
         isSpecialAttacking = false;
     }
-    if (state == PlayerState::HURT && hurtTimer <= 0) {
+    if (state == PlayerState::HURT && !hurtTimer.isActive(tick)) {
         changeState(PlayerState::IDLE);
     }
 
@@ -221,9 +180,9 @@ void Player::update(float deltaTime) {
     } else {
         // 先更新垂直位置和速度
         if (!isOnGround) {
-            vy += GRAVITY * deltaTime;
+            vy += GRAVITY * (chaosModifiers ? chaosModifiers->gravityScale() : 1.0f) * deltaTime;
             y += vy * deltaTime;
-            printf("Physics update - y: %.2f, vy: %.2f\n", y, vy); // 調試輸出
+            DEBUG_LOG("Physics update - y: %.2f, vy: %.2f\n", y, vy); // 調試輸出
         }
 
         // 更新水平位置
@@ -235,13 +194,13 @@ void Player::update(float deltaTime) {
             vy = 0;
             if (!isOnGround) {
                 isOnGround = true;
-                printf("Landed on ground\n"); // 調試輸出
+                DEBUG_LOG("Landed on ground\n"); // 調試輸出
                 if (state != PlayerState::BLOCKING) {
                     if (state == PlayerState::JUMPING || state == PlayerState::FALLING ||
-                        (state == PlayerState::HURT && hurtTimer <= 0)) {
+                        (state == PlayerState::HURT && !hurtTimer.isActive(tick))) {
                         changeState((fabsf(vx) < 1.0f) ? PlayerState::IDLE : PlayerState::WALKING);
                     } else if (state == PlayerState::ATTACKING) {
-                        attackTimer = 0;
+                        attackTimer.clear();
                         changeState((fabsf(vx) < 1.0f) ? PlayerState::IDLE : PlayerState::WALKING);
                     }
                 }
@@ -258,50 +217,32 @@ void Player::update(float deltaTime) {
     if (x < 0) x = 0;
     if (x + PLAYER_LOGIC_WIDTH > SCREEN_WIDTH) x = SCREEN_WIDTH - PLAYER_LOGIC_WIDTH;
 
-    // --- 更新動畫 ---
-    updateAnimation(deltaTime);
-
     // 更新躺下狀態
     if (state == PlayerState::LYING) {
-        if (hurtTimer <= 0 && !isOnGround) {
+        if (!hurtTimer.isActive(tick) && !isOnGround) {
             changeState(PlayerState::IDLE);
         }
     }
 
-    // Godon 衝刺技能：攻擊結束時歸零 vx
-    if (characterId == "Godon" && isSpecialAttacking && state == PlayerState::ATTACKING) {
+    // 衝刺技能：攻擊結束時歸零 vx
+    if (getTraits().specialAttack == SpecialAttackType::DASH && isSpecialAttacking && state == PlayerState::ATTACKING) {
         // 衝刺期間
-        // 若 attackTimer <= 0 或已經撞到人，結束衝刺
-        if (attackTimer <= 0 || hasHitDuringDash) {
+        // 攻擊時間到或已經撞到人，結束衝刺
+        if (!attackTimer.isActive(tick) || hasHitDuringDash) {
             vx = 0;
             isSpecialAttacking = false;
             if (hasHitDuringDash) {
-                attackTimer = 0; // 如果撞到人了，立即結束攻擊狀態
+                attackTimer.clear(); // 如果撞到人了，立即結束攻擊狀態
             }
         }
     }
 }
 
-void Player::updateAnimation(float deltaTime) {
-    // 取得目前動畫類型的資料
-    const AnimationInfo* animInfo = AnimationDataManager::getAnimationInfo(characterId, currentAnimationType);
-    if (!animInfo || animInfo->frameCount <= 0) return; // 沒有動畫資料或沒有幀
-
-    frameTimer += deltaTime;
-    if (frameTimer >= animInfo->frameDuration) { // 使用該動畫指定的幀持續時間
-        frameTimer -= animInfo->frameDuration;
-        currentFrame++;
-
-        // 處理幀數循環或停留
-        if (currentFrame >= animInfo->frameCount) {
-            if (animInfo->loop) {
-                currentFrame = 0; // 循環
-            } else {
-                currentFrame = animInfo->frameCount - 1; // 停在最後一幀
-                // 對於非循環動畫，可以在這裡觸發事件或狀態改變，但目前 update 裡處理了
-            }
-        }
-    }
+int Player::getAnimationFrame() const {
+    const AnimationInfo* animInfo = AnimationDataManager::getAnimationInfo(characterIndex, currentAnimationType);
+    if (!animInfo) return 0;
+    Uint32 tick = now();
+    return animInfo->frameAt(tick > stateEnteredTick ? tick - stateEnteredTick : 0);
 }
 
 void Player::render(SDL_Renderer* renderer) {
@@ -313,9 +254,10 @@ void Player::render(SDL_Renderer* renderer) {
         SDL_RenderFillRect(renderer, &errorRect);
         return;
     }
-    const AnimationInfo* animInfo = AnimationDataManager::getAnimationInfo(characterId, currentAnimationType);
-    if (!animInfo || currentFrame >= animInfo->frameCount) return;
-    SDL_Rect srcRect = animInfo->frames[currentFrame];
+    const AnimationInfo* animInfo = AnimationDataManager::getAnimationInfo(characterIndex, currentAnimationType);
+    int frame = getAnimationFrame();
+    if (!animInfo || frame >= animInfo->frameCount) return;
+    SDL_Rect srcRect = animInfo->frames[frame];
 
     SDL_Rect destRect;
     if (state == PlayerState::LYING) {
@@ -326,7 +268,7 @@ void Player::render(SDL_Renderer* renderer) {
         destRect = { lyingX, lyingY, lyingW, lyingH };
     } else {
         // 計算基準尺寸（使用 IDLE 動畫的第一幀作為基準）
-        const AnimationInfo* idleInfo = AnimationDataManager::getAnimationInfo(characterId, AnimationType::IDLE);
+        const AnimationInfo* idleInfo = AnimationDataManager::getAnimationInfo(characterIndex, AnimationType::IDLE);
         if (!idleInfo || idleInfo->frames.empty()) return;
         
         SDL_Rect baseFrame = idleInfo->frames[0];
@@ -361,7 +303,8 @@ void Player::render(SDL_Renderer* renderer) {
     // 處理角色的渲染
     SDL_RendererFlip flip = (direction == 1) ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
     bool drawPlayer = true;
-    if (invincibilityTimer > 0 && fmod(invincibilityTimer, 0.2f) < 0.1f) {
+    Uint32 invincibleTicks = invincibilityTimer.remainingTicks(now());
+    if (invincibleTicks > 0 && invincibleTicks % secondsToTicks(0.2f) < secondsToTicks(0.1f)) {
         drawPlayer = false;
     }
     if (drawPlayer) {
@@ -370,90 +313,76 @@ void Player::render(SDL_Renderer* renderer) {
 }
 
 void Player::takeDamage(int damage) {
-    if (invincibilityTimer > 0  || state == PlayerState::DEATH) return;
+    if (invincibilityTimer.isActive(now()) || state == PlayerState::DEATH) return;
 
-    printf("[Damage Check] Player %s Current State: %d (Is it BLOCKING? %d)\n",
+    DEBUG_LOG("[Damage Check] Player %s Current State: %d (Is it BLOCKING? %d)\n",
     characterId.c_str(), static_cast<int>(state), static_cast<int>(PlayerState::BLOCKING));
 
     // --- 格擋成功判斷 ---
     if (state == PlayerState::BLOCKING) {
-        printf("Player %s BLOCKED the attack!\n", characterId.c_str());
-        // 可以在這裡加點格擋特效或音效
-        // AudioManager::playSoundEffect("sfx_block");
-        // 觸發一次短暫的格擋動畫/效果？ (可選)
+        DEBUG_LOG("Player %s BLOCKED the attack!\n", characterId.c_str());
 
         // 觸發冷卻時間
-        if (blockCooldownTimer <= 0) { // 避免重複觸發冷卻
-            blockCooldownTimer = BLOCK_COOLDOWN; // 使用 Constants.h 的值
-            printf("Player %s Block Cooldown Started (%.1fs) - From Successful Block\n", characterId.c_str(), BLOCK_COOLDOWN);
+        if (!blockCooldownTimer.isActive(now())) { // 避免重複觸發冷卻
+            blockCooldownTimer.start(now(), secondsToTicks(BLOCK_COOLDOWN)); // 使用 Constants.h 的值
+            DEBUG_LOG("Player %s Block Cooldown Started (%.1fs) - From Successful Block\n", characterId.c_str(), BLOCK_COOLDOWN);
         }
 
         return; // 阻擋傷害，直接返回
     }
 
     health -= damage;
-    printf("Player %s took %d damage, health: %d\n", characterId.c_str(), damage, health);
+    DEBUG_LOG("Player %s took %d damage, health: %d\n", characterId.c_str(), damage, health);
 
     if (health <= 0) {
         health = 0;
-        printf("Player %s defeated!\n", characterId.c_str());
+        DEBUG_LOG("Player %s defeated!\n", characterId.c_str());
         changeState(PlayerState::DEATH);
-        std::string prefix = (characterId == "BlockMan") ? "blockman_death" : "godon_death";
-        AudioManager::playRandomSound(prefix);
         // 確保玩家停止所有動作
         vx = 0;
         vy = 0;
         isOnGround = true;
-        attackTimer = 0;
-        hurtTimer = 0;
-        invincibilityTimer = 0;
-        blockCooldownTimer = 0;
-        attackRateCooldownTimer = 0;
-        projectileCooldownTimer = 0;
+        attackTimer.clear();
+        hurtTimer.clear();
+        invincibilityTimer.clear();
+        blockCooldownTimer.clear();
+        attackRateCooldownTimer.clear();
+        projectileCooldownTimer.clear();
     } else {
         changeState(PlayerState::HURT);
-        hurtTimer = HURT_DURATION;
-        invincibilityTimer = HURT_INVINCIBILITY;
+        hurtTimer.start(now(), secondsToTicks(HURT_DURATION));
+        invincibilityTimer.start(now(), secondsToTicks(HURT_INVINCIBILITY));
         vx = 0;
         vy = -100.0f;
         isOnGround = false;
-        attackTimer = 0;
-        std::string prefix = (characterId == "BlockMan") ? "blockman_hurt" : "godon_hurt";
-        AudioManager::playRandomSound(prefix);
+        attackTimer.clear();
     }
 }
 
-SDL_Rect Player::getBoundingBox() const {
-    if (state == PlayerState::LYING) {
-        int lyingW = logicWidth;
-        int lyingH = static_cast<int>(logicHeight * 0.35f); // 根據角色高度調整躺下時的高度
-        int lyingX = (int)x;
-        int lyingY = GROUND_LEVEL - lyingH;
-        return { lyingX, lyingY, lyingW, lyingH };
-    }
-    return { (int)x, (int)y, logicWidth, logicHeight };
+// 目前動畫幀的判定框 (沒有動畫資料時為 nullptr)
+const FrameBoxes* Player::getFrameBoxes() const {
+    const AnimationInfo* animInfo = AnimationDataManager::getAnimationInfo(characterIndex, currentAnimationType);
+    if (!animInfo) return nullptr;
+    Uint32 tick = now();
+    int frame = animInfo->frameAt(tick > stateEnteredTick ? tick - stateEnteredTick : 0);
+    return frame < animInfo->frameCount ? &animInfo->boxes[frame] : nullptr;
 }
 
-// 計算相對於自身的攻擊框 (Hitbox)
-SDL_Rect Player::calculateRelativeHitbox() const {
-    // 根據角色尺寸調整攻擊判定框
-    int hitboxWidth = static_cast<int>(logicWidth * 0.5f);  // 攻擊判定寬度為角色寬度的一半
-    int hitboxHeight = static_cast<int>(logicHeight * 0.25f);  // 攻擊判定高度為角色高度的四分之一
-    int offsetX = (direction == 1) ? logicWidth - 20 : -hitboxWidth + 20;
-    int offsetY = logicHeight / 2 - hitboxHeight / 2;
-    return {offsetX, offsetY, hitboxWidth, hitboxHeight};
+SDL_Rect Player::getBoundingBox() const {
+    const FrameBoxes* boxes = getFrameBoxes();
+    if (!boxes) return { (int)x, (int)y, logicWidth, logicHeight };
+    const SDL_Rect& box = boxes->hurtbox[facingIndex(direction)];
+    int top = boxes->hurtboxOnGround ? GROUND_LEVEL - box.h : (int)y + box.y; // 躺下時貼齊地面
+    return { (int)x + box.x, top, box.w, box.h };
 }
 
-
 SDL_Rect Player::getHitboxWorld() const {
-    if (state == PlayerState::ATTACKING && attackTimer > 0) {
-        // 在攻擊動畫的前半段產生判定
-        if (attackTimer > ATTACK_DURATION * 0.5f) {
-            SDL_Rect relativeHitbox = calculateRelativeHitbox();
-            return {(int)x + relativeHitbox.x, (int)y + relativeHitbox.y, relativeHitbox.w, relativeHitbox.h};
-        }
-    }
-    return {0, 0, 0, 0}; // 無效 hitbox
+    // 攻擊被中斷 (落地、撞到人) 時計時器已經清除，即使還沒換狀態也沒有判定
+    if (state != PlayerState::ATTACKING || !attackTimer.isActive(now())) return {0, 0, 0, 0};
+    const FrameBoxes* boxes = getFrameBoxes();
+    if (!boxes || !boxes->hasHitbox) return {0, 0, 0, 0}; // 這一幀沒有攻擊判定
+    const SDL_Rect& box = boxes->hitbox[facingIndex(direction)];
+    return {(int)x + box.x, (int)y + box.y, box.w, box.h};
 }
 
 bool Player::canFireProjectile() const {
@@ -462,11 +391,11 @@ bool Player::canFireProjectile() const {
         // 只有在 攻擊/受傷/格擋 時不能發
         return false;
     }
-    return projectileCooldownTimer <= 0 && isAlive(); // 基本條件：冷卻結束且活著
+    return !projectileCooldownTimer.isActive(now()) && isAlive(); // 基本條件：冷卻結束且活著
 }
 
 void Player::resetProjectileCooldown() {
-    projectileCooldownTimer = PROJECTILE_COOLDOWN; // 使用 Constants.h 的值
+    projectileCooldownTimer.start(now(), secondsToTicks(PROJECTILE_COOLDOWN)); // 使用 Constants.h 的值
 }
 
 bool Player::isAlive() const {
@@ -494,33 +423,17 @@ bool Player::isControllable() const {
 
 void Player::setGlove(GloveType gloveType) {
     currentGlove = gloveType;
-    printf("Player %s switched to %s gloves\n", characterId.c_str(), getGloveName().c_str());
+    DEBUG_LOG("Player %s switched to %s gloves\n", characterId.c_str(), getGloveName().c_str());
 }
 
 float Player::getAttackCooldown() const {
-    switch (currentGlove) {
-        case GloveType::LIGHT_10OZ:
-            return LIGHT_GLOVE_COOLDOWN;
-        case GloveType::MEDIUM_14OZ:
-            return MEDIUM_GLOVE_COOLDOWN;
-        case GloveType::HEAVY_18OZ:
-            return HEAVY_GLOVE_COOLDOWN;
-        default:
-            return LIGHT_GLOVE_COOLDOWN;
-    }
+    int index = static_cast<int>(currentGlove);
+    return (index >= 0 && index < GLOVE_TYPE_COUNT) ? balance.gloveCooldown[index] : balance.gloveCooldown[0];
 }
 
 int Player::getAttackDamage() const {
-    switch (currentGlove) {
-        case GloveType::LIGHT_10OZ:
-            return LIGHT_GLOVE_DAMAGE;
-        case GloveType::MEDIUM_14OZ:
-            return MEDIUM_GLOVE_DAMAGE;
-        case GloveType::HEAVY_18OZ:
-            return HEAVY_GLOVE_DAMAGE;
-        default:
-            return LIGHT_GLOVE_DAMAGE;
-    }
+    int index = static_cast<int>(currentGlove);
+    return (index >= 0 && index < GLOVE_TYPE_COUNT) ? balance.gloveDamage[index] : balance.gloveDamage[0];
 }
 
 std::string Player::getGloveName() const {
@@ -537,10 +450,62 @@ std::string Player::getGloveName() const {
 }
 
 bool Player::canUseSpecialAttack() const {
-    return specialAttackCooldownTimer <= 0;
+    return !specialAttackCooldownTimer.isActive(now());
 }
 
 void Player::resetSpecialAttackCooldown() {
-    specialAttackCooldownTimer = SPECIAL_ATTACK_COOLDOWN;
+    specialAttackCooldownTimer.start(now(), secondsToTicks(balance.specialAttackCooldown));
     hasHitDuringDash = false;
+}
+
+void Player::saveState(PlayerSnapshot& out) const {
+    out.x = x;
+    out.y = y;
+    out.vx = vx;
+    out.vy = vy;
+    out.health = health;
+    out.direction = direction;
+    out.state = static_cast<Uint8>(state);
+    out.currentAnimationType = static_cast<Uint8>(currentAnimationType);
+    out.isOnGround = isOnGround;
+    out.shouldFireProjectile = shouldFireProjectile;
+    out.isSpecialAttacking = isSpecialAttacking;
+    out.hasHitDuringDash = hasHitDuringDash;
+    out.blockedByMask = blockedByMask;
+    out.attackTimer = attackTimer.expiresAt;
+    out.attackCooldownTimer = attackCooldownTimer.expiresAt;
+    out.hurtTimer = hurtTimer.expiresAt;
+    out.invincibilityTimer = invincibilityTimer.expiresAt;
+    out.blockCooldownTimer = blockCooldownTimer.expiresAt;
+    out.attackRateCooldownTimer = attackRateCooldownTimer.expiresAt;
+    out.projectileCooldownTimer = projectileCooldownTimer.expiresAt;
+    out.specialAttackCooldownTimer = specialAttackCooldownTimer.expiresAt;
+    out.stateEnteredTick = stateEnteredTick;
+    out.inputHistory = inputHistory;
+}
+
+void Player::loadState(const PlayerSnapshot& in) {
+    x = in.x;
+    y = in.y;
+    vx = in.vx;
+    vy = in.vy;
+    health = in.health;
+    direction = in.direction;
+    state = static_cast<PlayerState>(in.state);
+    currentAnimationType = static_cast<AnimationType>(in.currentAnimationType);
+    isOnGround = in.isOnGround != 0;
+    shouldFireProjectile = in.shouldFireProjectile != 0;
+    isSpecialAttacking = in.isSpecialAttacking != 0;
+    hasHitDuringDash = in.hasHitDuringDash != 0;
+    blockedByMask = in.blockedByMask;
+    attackTimer.expiresAt = in.attackTimer;
+    attackCooldownTimer.expiresAt = in.attackCooldownTimer;
+    hurtTimer.expiresAt = in.hurtTimer;
+    invincibilityTimer.expiresAt = in.invincibilityTimer;
+    blockCooldownTimer.expiresAt = in.blockCooldownTimer;
+    attackRateCooldownTimer.expiresAt = in.attackRateCooldownTimer;
+    projectileCooldownTimer.expiresAt = in.projectileCooldownTimer;
+    specialAttackCooldownTimer.expiresAt = in.specialAttackCooldownTimer;
+    stateEnteredTick = in.stateEnteredTick;
+    inputHistory = in.inputHistory;
 }
\ No newline at end of file
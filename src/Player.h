@@ -5,7 +5,46 @@
 #include <string>
 #include "Constants.h"       // 使用核心常數
 #include "AnimationData.h" // 需要 AnimationType
-#include "AudioManager.h"
+#include "Snapshot.h"      // 重播快照
+#include "CharacterTraits.h" // 角色尺寸/技能/音效
+#include "SimClock.h"       // 計時器 (到期 tick)
+#include "InputHistory.h"   // 緩衝輸入與搓招
+
+// --- 平衡性參數 ---
+// 預設值就是正式遊戲的數值；批次模擬 (--batch) 會逐組替換來做平衡性測試。
+// 整場比賽固定不變，所以不存進快照。
+const int GLOVE_TYPE_COUNT = 3;
+struct BalanceParams {
+    float gloveCooldown[GLOVE_TYPE_COUNT] = {LIGHT_GLOVE_COOLDOWN, MEDIUM_GLOVE_COOLDOWN, HEAVY_GLOVE_COOLDOWN};
+    int gloveDamage[GLOVE_TYPE_COUNT] = {LIGHT_GLOVE_DAMAGE, MEDIUM_GLOVE_DAMAGE, HEAVY_GLOVE_DAMAGE};
+    int projectileDamage = PROJECTILE_DAMAGE;
+    float specialAttackCooldown = SPECIAL_ATTACK_COOLDOWN;
+    int inputBufferTicks = INPUT_BUFFER_TICKS; // 硬直結束前幾個 tick 內按下的普攻仍會出拳 (0 表示不緩衝)
+};
+
+// --- 玩家指令 ---
+// 一個 tick 內同一位玩家的所有指令以位元遮罩傳入，依位元由低到高執行
+// (順序會影響結果，例如先跳再攻擊，所以不可以任意調整位元的順序)。
+// 每個指令在哪些狀態可以執行、會進入哪個狀態定義在 PlayerStateTable.h。
+enum PlayerCommand : Uint16 {
+    CMD_BLOCK           = 1 << 0,
+    CMD_STOP_BLOCK      = 1 << 1,  // 放開格擋鍵 (只在格擋中有作用)
+    CMD_JUMP            = 1 << 2,
+    CMD_ATTACK          = 1 << 3,
+    CMD_LYING           = 1 << 4,
+    CMD_STAND_UP        = 1 << 5,  // 放開蹲下鍵 (躺下且擊倒時間結束才起身)
+    CMD_LEFT            = 1 << 6,
+    CMD_RIGHT           = 1 << 7,
+    CMD_STOP_X          = 1 << 8,  // 停止水平移動
+    CMD_FIRE_PROJECTILE = 1 << 9,
+    CMD_SPECIAL_ATTACK  = 1 << 10
+};
+
+// 單一玩家在一個 tick 內的意圖 (由 Game 從按鍵輸入一次解析完成，已套用混亂模式的反轉)
+struct PlayerCommands {
+    Uint16 pressed = 0; // 按下瞬間的指令 (氣功/特殊技能)，雙方都執行完才處理持續按壓的指令
+    Uint16 held = 0;    // 持續按壓的指令 (移動/跳躍/攻擊/格擋)
+};
 
 class Player {
 public:
@@ -24,36 +63,44 @@ public:
     // --- 成員變數 ---
     float x, y;                     // 位置
     float vx, vy;                   // 速度
+    float prevX = 0.0f, prevY = 0.0f; // 本 tick 開始時的位置 (update 開頭記錄，掃掠碰撞用；不存進快照)
     int health;                   // 生命值
     int direction;                // 方向 (1: 右, -1: 左)
     PlayerState state;              // 目前狀態
     std::string characterId;        // 角色 ID (用於取得動畫和紋理)
+    int characterIndex;             // CHARACTER_TRAITS 的索引 (建立時由 characterId 查出)
     std::string textureId;          // 使用的紋理 ID (來自 TextureManager)
     GloveType currentGlove;         // 目前使用的拳套類型
+    BalanceParams balance;          // 拳套/氣功/技能數值 (由 Game 在建立玩家時設定)
 
     // 角色尺寸
     int logicWidth;                 // 角色的邏輯寬度
     int logicHeight;                // 角色的邏輯高度
 
-    // 計時器與狀態旗標
-    float attackTimer;
-    float attackCooldownTimer;
-    float hurtTimer;
-    float invincibilityTimer;
-    float blockCooldownTimer; 
-    float attackRateCooldownTimer;
-    float projectileCooldownTimer;
-    float specialAttackCooldownTimer; // 新增：特殊攻擊冷卻計時器
+    // 計時器與狀態旗標 (記錄到期的 tick，以 clock 指向的模擬時鐘判斷)
+    const Uint32* clock = nullptr;  // Game::matchTick (由 Game 在建立玩家時設定)
+    const ChaosModifiers* chaosModifiers = nullptr; // 混亂模式的重力/速度調整 (沒有時用正常值)
+    TickTimer attackTimer;
+    TickTimer attackCooldownTimer;
+    TickTimer hurtTimer;
+    TickTimer invincibilityTimer;
+    TickTimer blockCooldownTimer;
+    TickTimer attackRateCooldownTimer;
+    TickTimer projectileCooldownTimer;
+    TickTimer specialAttackCooldownTimer; // 新增：特殊攻擊冷卻計時器
     bool isOnGround;
     bool shouldFireProjectile = false;
 
-    // 動畫相關
-    int currentFrame;
-    float frameTimer;
+    // 動畫相關 (目前的幀由進入狀態後經過的 tick 數查表得到，不在模擬中累加)
+    Uint32 stateEnteredTick = 0;        // 進入目前狀態的 tick
     AnimationType currentAnimationType; // 目前播放的動畫類型
 
     bool isSpecialAttacking = false;
     bool hasHitDuringDash = false;
+    Uint8 blockedByMask = 0;            // 這次攻擊已經被哪些玩家格擋過 (每次攻擊對每人只記一次格擋)
+
+    // 最近的按鍵變化 (由 Game 每個 tick 記錄，用於緩衝輸入與搓招)
+    InputHistory inputHistory;
 
     // --- 建構子 ---
     // 需要起始位置、方向，以及角色和紋理的 ID
@@ -61,7 +108,9 @@ public:
            const std::string& charId, const std::string& texId);
 
     // --- 成員函數 (方法) ---
-    void handleAction(const std::string& action); // 用 string 傳遞動作更靈活
+    const CharacterTraits& getTraits() const { return CHARACTER_TRAITS[characterIndex]; }
+    Uint32 now() const { return clock ? *clock : 0; } // 目前的模擬 tick
+    void executeCommands(Uint16 commands); // 依序執行 PlayerCommand 位元
     void update(float deltaTime);
     void render(SDL_Renderer* renderer); // 不再需要傳遞紋理，從 TextureManager 獲取
     void takeDamage(int damage);
@@ -72,21 +121,26 @@ public:
     int getAttackDamage() const;        // 根據拳套類型返回攻擊傷害
     std::string getGloveName() const;   // 獲取拳套名稱
 
-    SDL_Rect getBoundingBox() const; // 取得基於 PLAYER_LOGIC_WIDTH/HEIGHT 的碰撞盒
-    SDL_Rect getHitboxWorld() const; // 取得世界座標的攻擊判定盒
+    SDL_Rect getBoundingBox() const; // 取得世界座標的受擊框 (目前動畫幀的判定框)
+    SDL_Rect getHitboxWorld() const; // 取得世界座標的攻擊判定盒 (這一幀沒有時寬高為 0)
 
     bool canFireProjectile() const; // 檢查是否能發射氣功
     void resetProjectileCooldown(); // 重置氣功冷卻
     bool isControllable() const;
     bool isAlive() const;           // 檢查是否存活 (方便碰撞檢測用)
-    void updateAnimation(float deltaTime);
+    int getAnimationFrame() const;  // 目前動畫顯示的幀
     void changeState(PlayerState newState); // 封裝狀態改變和動畫重置邏輯
     bool canUseSpecialAttack() const; // 新增：檢查是否可以使用特殊攻擊
     void resetSpecialAttackCooldown(); // 新增：重置特殊攻擊冷卻
+
+    // 重播快照：存取會隨模擬改變的欄位
+    void saveState(PlayerSnapshot& out) const;
+    void loadState(const PlayerSnapshot& in);
 private:
     // 內部輔助函數
-    
-    SDL_Rect calculateRelativeHitbox() const; // 計算相對於角色的攻擊框
+    void executeCommand(PlayerCommand command);
+
+    const FrameBoxes* getFrameBoxes() const; // 目前動畫幀的判定框 (AnimationData 查表)
 };
 
 #endif // PLAYER_H
\ No newline at end of file
@@ -0,0 +1,132 @@
+#ifndef PLAYER_STATE_TABLE_H
+#define PLAYER_STATE_TABLE_H
+
+#include "Player.h"
+
+// --- 玩家狀態轉換表 ---
+// 每個 (目前狀態, 指令) 是否允許、執行後進入哪個狀態，在編譯時期由下面的規則產生。
+// 與狀態無關的條件 (是否在地面、冷卻時間等) 仍由 Player::executeCommand 檢查。
+// 規則改錯時 (例如躺下後無法起身) 檔案最後的 static_assert 會讓編譯失敗。
+namespace PlayerStateTable {
+
+typedef Player::PlayerState State;
+
+const int STATE_COUNT = static_cast<int>(State::LYING) + 1;
+const int COMMAND_COUNT = 11; // PlayerCommand 的位元數
+
+struct Transition {
+    bool allowed = false;
+    State target = State::IDLE;
+};
+
+constexpr Uint16 stateBit(State state) {
+    return static_cast<Uint16>(1u << static_cast<int>(state));
+}
+
+constexpr int commandIndex(PlayerCommand command) {
+    int index = 0;
+    while (index < 16 && (static_cast<Uint16>(command) >> index) != 1u) ++index;
+    return index;
+}
+
+// --- 規則：指令 -> 可以執行的狀態 + 目標狀態 ---
+// 受傷 (硬直)、死亡與勝利時不接受任何指令；躺下時要等擊倒時間結束 (executeCommand 檢查)。
+struct Rule {
+    PlayerCommand command;
+    Uint16 allowedStates;
+    State target;
+};
+
+constexpr Uint16 FREE_STATES = stateBit(State::IDLE) | stateBit(State::WALKING) | stateBit(State::LYING);
+constexpr Uint16 MOBILE_STATES = FREE_STATES | stateBit(State::JUMPING) | stateBit(State::FALLING);
+
+constexpr Rule RULES[] = {
+    {CMD_BLOCK,           FREE_STATES | stateBit(State::BLOCKING), State::BLOCKING},
+    {CMD_STOP_BLOCK,      stateBit(State::BLOCKING),               State::IDLE},
+    {CMD_JUMP,            MOBILE_STATES,                           State::JUMPING},
+    {CMD_ATTACK,          MOBILE_STATES,                           State::ATTACKING},
+    {CMD_LYING,           FREE_STATES,                             State::LYING},
+    {CMD_STAND_UP,        stateBit(State::LYING),                  State::IDLE},
+    {CMD_LEFT,            MOBILE_STATES,                           State::WALKING}, // 空中只改變速度
+    {CMD_RIGHT,           MOBILE_STATES,                           State::WALKING},
+    {CMD_STOP_X,          stateBit(State::WALKING),                State::IDLE},
+    {CMD_FIRE_PROJECTILE, MOBILE_STATES,                           State::ATTACKING},
+    {CMD_SPECIAL_ATTACK,  MOBILE_STATES,                           State::ATTACKING},
+};
+
+struct Table {
+    Transition entries[STATE_COUNT][COMMAND_COUNT];
+};
+
+constexpr Table buildTable() {
+    Table table{};
+    for (const Rule& rule : RULES) {
+        for (int state = 0; state < STATE_COUNT; ++state) {
+            Transition& entry = table.entries[state][commandIndex(rule.command)];
+            entry.allowed = (rule.allowedStates >> state) & 1u;
+            entry.target = entry.allowed ? rule.target : static_cast<State>(state);
+        }
+    }
+    return table;
+}
+
+constexpr Table TABLE = buildTable();
+
+constexpr const Transition& lookup(State state, PlayerCommand command) {
+    return TABLE.entries[static_cast<int>(state)][commandIndex(command)];
+}
+
+// --- 編譯時期檢查 ---
+constexpr bool everyCommandHasRule() {
+    for (int i = 0; i < COMMAND_COUNT; ++i) {
+        bool found = false;
+        for (const Rule& rule : RULES) found = found || commandIndex(rule.command) == i;
+        if (!found) return false;
+    }
+    return sizeof(RULES) / sizeof(RULES[0]) == COMMAND_COUNT;
+}
+
+constexpr bool acceptsAnyCommand(State state) {
+    for (int i = 0; i < COMMAND_COUNT; ++i) {
+        if (TABLE.entries[static_cast<int>(state)][i].allowed) return true;
+    }
+    return false;
+}
+
+// 指令只能導向可以自行控制的狀態 (受傷/死亡/勝利只能由遊戲事件造成)
+constexpr bool commandsNeverTarget(State state) {
+    for (const Rule& rule : RULES) {
+        if (rule.target == state) return false;
+    }
+    return true;
+}
+
+// 某狀態可以靠一個指令離開到 target
+constexpr bool canLeave(State from, State to) {
+    for (int i = 0; i < COMMAND_COUNT; ++i) {
+        const Transition& entry = TABLE.entries[static_cast<int>(from)][i];
+        if (entry.allowed && entry.target == to) return true;
+    }
+    return false;
+}
+
+static_assert(commandIndex(CMD_SPECIAL_ATTACK) == COMMAND_COUNT - 1, "COMMAND_COUNT must cover every PlayerCommand bit");
+static_assert(everyCommandHasRule(), "every PlayerCommand needs exactly one rule");
+static_assert(!acceptsAnyCommand(State::HURT), "hurt stun must ignore every command");
+static_assert(!acceptsAnyCommand(State::DEATH), "dead players must ignore every command");
+static_assert(!acceptsAnyCommand(State::VICTORY), "the winner must ignore every command");
+static_assert(commandsNeverTarget(State::HURT) && commandsNeverTarget(State::DEATH) &&
+              commandsNeverTarget(State::VICTORY) && commandsNeverTarget(State::FALLING),
+              "commands must not enter event-driven states");
+static_assert(canLeave(State::LYING, State::IDLE), "a lying player must be able to stand up");
+static_assert(canLeave(State::BLOCKING, State::IDLE), "releasing block must return to idle");
+static_assert(canLeave(State::WALKING, State::IDLE), "stopping must return to idle");
+static_assert(!lookup(State::ATTACKING, CMD_ATTACK).allowed && !lookup(State::ATTACKING, CMD_FIRE_PROJECTILE).allowed &&
+              !lookup(State::ATTACKING, CMD_SPECIAL_ATTACK).allowed,
+              "attacks must not cancel each other");
+static_assert(!lookup(State::BLOCKING, CMD_LEFT).allowed && !lookup(State::BLOCKING, CMD_JUMP).allowed,
+              "blocking roots the player in place");
+
+} // namespace PlayerStateTable
+
+#endif // PLAYER_STATE_TABLE_H
@@ -0,0 +1,153 @@
+#include "Projectile.h"
+#include <cstring>
+#include <cctype>
+#include <stdlib.h>
+#include <stdio.h>
+
+// --- 純量核心 (沒有 AVX2 時使用，也處理 AVX2 一次 8 個之後剩下的尾端) ---
+void integrateProjectilesScalar(ArchetypeLanes& lanes, int begin, int end, float deltaTime) {
+    for (int i = begin; i < end; ++i) {
+        float x = lanes.x[i] + lanes.vx[i] * deltaTime;
+        lanes.x[i] = x;
+        // 檢查是否超出畫面
+        bool offscreen = x < -PROJECTILE_HITBOX_W || x > SCREEN_WIDTH;
+        lanes.alive[i] = offscreen ? 0 : lanes.alive[i];
+    }
+}
+
+void findProjectileHitsScalar(ArchetypeLanes& lanes, int begin, int end, const ProjectileTarget* targets, int targetCount) {
+    for (int i = begin; i < end; ++i) {
+        Uint32 hits = 0;
+        if (lanes.alive[i]) {
+            float left = lanes.x[i];
+            float right = lanes.x[i] + PROJECTILE_HITBOX_W;
+            float top = lanes.y[i];
+            float bottom = lanes.y[i] + PROJECTILE_HITBOX_H;
+            for (int t = 0; t < targetCount; ++t) {
+                const ProjectileTarget& target = targets[t];
+                if (!target.vulnerable || lanes.owner[i] == t) continue; // 跳過發射者
+                if (right > target.left && left < target.right && bottom > target.top && top < target.bottom) {
+                    hits |= 1u << t;
+                }
+            }
+        }
+        lanes.hits[i] = hits;
+    }
+}
+
+// --- ProjectilePool ---
+ProjectilePool::ProjectilePool(int capacity) {
+    lanes.allocate(PROJECTILE_COMPONENTS, capacity);
+    useAvx2 = isAvx2Available();
+}
+
+bool ProjectilePool::isAvx2Available() {
+    static const bool available = hasProjectileAvx2Kernel() && SDL_HasAVX2() == SDL_TRUE;
+    return available;
+}
+
+int ProjectilePool::spawn(float x, float y, float vx, int owner, Uint8 sprite) {
+    int i = lanes.add();
+    if (i < 0) return -1;
+    lanes.x[i] = x;
+    lanes.y[i] = y;
+    lanes.vx[i] = vx;
+    lanes.owner[i] = owner;
+    lanes.hits[i] = 0;
+    lanes.sprite[i] = sprite;
+    return i;
+}
+
+Projectile ProjectilePool::get(int index) const {
+    Projectile p;
+    p.x = lanes.x[index];
+    p.y = lanes.y[index];
+    p.vx = lanes.vx[index];
+    p.ownerPlayerIndex = lanes.owner[index];
+    p.isActive = lanes.alive[index] != 0;
+    p.sprite = lanes.sprite[index];
+    return p;
+}
+
+void ProjectilePool::integrate(float deltaTime) {
+    int done = useAvx2 ? integrateProjectilesAvx2(lanes, lanes.count, deltaTime) : 0;
+    integrateProjectilesScalar(lanes, done, lanes.count, deltaTime);
+}
+
+int ProjectilePool::findHits(const ProjectileTarget* targets, int targetCount) {
+    if (targetCount > MAX_PROJECTILE_TARGETS) targetCount = MAX_PROJECTILE_TARGETS;
+    int done = useAvx2 ? findProjectileHitsAvx2(lanes, lanes.count, targets, targetCount) : 0;
+    findProjectileHitsScalar(lanes, done, lanes.count, targets, targetCount);
+    int hitCount = 0;
+    for (int i = 0; i < lanes.count; ++i) {
+        hitCount += lanes.hits[i] != 0;
+    }
+    return hitCount;
+}
+
+// --- 命令列參數 ---
+void parseProjectileBenchArgs(int argc, char* argv[], ProjectileBenchOptions& out) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--projectile-bench") != 0) continue;
+        out.enabled = true;
+        // 後面可以接氣功數與 tick 數
+        if (i + 1 < argc && isdigit(static_cast<unsigned char>(argv[i + 1][0]))) out.count = atoi(argv[++i]);
+        if (i + 1 < argc && isdigit(static_cast<unsigned char>(argv[i + 1][0]))) out.ticks = atoi(argv[++i]);
+    }
+}
+
+// --- 基準測試 ---
+bool benchmarkProjectiles(int count, int ticks) {
+    if (count < 1) count = 1;
+    if (ticks < 1) ticks = 1;
+
+    // 兩個內容相同的池子：純量與 AVX2 各跑一個，最後逐位元比對
+    ProjectilePool pools[2] = {ProjectilePool(count), ProjectilePool(count)};
+    Uint32 rng = 12345;
+    for (int i = 0; i < count; ++i) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        float x = static_cast<float>(rng % SCREEN_WIDTH);
+        float y = static_cast<float>(GROUND_LEVEL - PROJECTILE_HITBOX_H - static_cast<int>((rng >> 12) % 300));
+        float vx = (rng & 0x100) ? PROJECTILE_SPEED : -PROJECTILE_SPEED;
+        int owner = static_cast<int>(i % 3) - 1; // -1 (環境)、0、1
+        pools[0].spawn(x, y, vx, owner);
+        pools[1].spawn(x, y, vx, owner);
+    }
+
+    // 兩個站在起始位置的玩家
+    ProjectileTarget targets[2];
+    for (int t = 0; t < 2; ++t) {
+        targets[t].left = (t == 0) ? 100.0f : SCREEN_WIDTH - 100.0f - PLAYER_LOGIC_WIDTH;
+        targets[t].right = targets[t].left + PLAYER_LOGIC_WIDTH;
+        targets[t].top = static_cast<float>(GROUND_LEVEL - PLAYER_LOGIC_HEIGHT);
+        targets[t].bottom = targets[t].top + PLAYER_LOGIC_HEIGHT;
+        targets[t].vulnerable = true;
+    }
+
+    int passes = ProjectilePool::isAvx2Available() ? 2 : 1;
+    if (passes == 1) printf("Projectiles: AVX2 not available on this CPU\n");
+    for (int pass = 0; pass < passes; ++pass) {
+        ProjectilePool& pool = pools[pass];
+        pool.setUseAvx2(pass == 1);
+        long long hits = 0;
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int t = 0; t < ticks; ++t) {
+            pool.integrate(FIXED_DELTA_TIME);
+            hits += pool.findHits(targets, 2);
+        }
+        double seconds = static_cast<double>(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+        printf("Projectiles: %-6s %d projectiles x %d ticks, %.2f us/tick (integrate + AABB vs 2 players), %lld hits\n",
+               pass == 1 ? "AVX2" : "scalar", count, ticks, seconds * 1e6 / ticks, hits);
+    }
+
+    if (passes == 1) return true;
+    const ArchetypeLanes& a = pools[0].getLanes();
+    const ArchetypeLanes& b = pools[1].getLanes();
+    bool same = memcmp(a.x.data(), b.x.data(), count * sizeof(float)) == 0 &&
+                memcmp(a.alive.data(), b.alive.data(), count * sizeof(Sint32)) == 0 &&
+                memcmp(a.hits.data(), b.hits.data(), count * sizeof(Uint32)) == 0;
+    printf("Projectiles: AVX2 results %s the scalar kernel\n", same ? "match" : "DIFFER from");
+    return same;
+}
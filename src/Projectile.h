@@ -0,0 +1,106 @@
+#ifndef PROJECTILE_H
+#define PROJECTILE_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "Constants.h"
+#include "Archetype.h"
+
+// --- 氣功的外觀 (紋理 ID + 精靈圖上的來源矩形)，氣功本身只存這個表的索引 ---
+struct ProjectileSprite {
+    const char* textureId;
+    SDL_Rect srcRect;
+};
+
+enum ProjectileSpriteId : Uint8 {
+    PROJECTILE_SPRITE_KI = 0 // 一般氣功 (要跟載入時的紋理 ID 一致)
+};
+
+const ProjectileSprite PROJECTILE_SPRITES[] = {
+    {"projectile_sprites", {PROJECTILE_SRC_X, PROJECTILE_SRC_Y, PROJECTILE_SRC_W, PROJECTILE_SRC_H}},
+};
+
+// --- 單一氣功的值 (由氣功池的各個陣列組出來，給繪製/AI/快照這類逐一讀取的程式使用) ---
+struct Projectile {
+    float x = 0.0f;
+    float y = 0.0f;
+    float vx = 0.0f;
+    Sint32 ownerPlayerIndex = -1; // 是哪個玩家發射的 (0 或 1)
+    bool isActive = false;
+    Uint8 sprite = PROJECTILE_SPRITE_KI; // PROJECTILE_SPRITES 的索引
+
+    const ProjectileSprite& getSprite() const { return PROJECTILE_SPRITES[sprite]; }
+
+    // 取得碰撞框
+    SDL_Rect getBoundingBox() const {
+        // 使用 Constants.h 中定義的碰撞大小
+        return {(int)x, (int)y, PROJECTILE_HITBOX_W, PROJECTILE_HITBOX_H};
+    }
+};
+
+// --- 氣功可以打到的目標 (Game 每個 tick 從玩家組出來) ---
+// 碰撞框與 Game 原本的判定相同：玩家的邏輯寬高 (PLAYER_LOGIC_WIDTH/HEIGHT)，以浮點比較。
+struct ProjectileTarget {
+    float left = 0.0f, top = 0.0f, right = 0.0f, bottom = 0.0f;
+    bool vulnerable = false; // 存活且沒有躺下 (躺下時氣功會從上方飛過)
+};
+const int MAX_PROJECTILE_TARGETS = 32; // 命中結果以 32 位元遮罩記錄
+
+// 氣功 archetype 的元件：位置/水平速度、發射者、命中結果 (第 t 個位元：碰到 targets[t])、外觀
+const Uint16 PROJECTILE_COMPONENTS = COMPONENT_MOTION | COMPONENT_OWNER | COMPONENT_HITBOX | COMPONENT_SPRITE;
+
+// 核心 (Projectile.cpp 為純量版本，ProjectileAvx2.cpp 為 AVX2 版本)，處理 [begin, end)
+void integrateProjectilesScalar(ArchetypeLanes& lanes, int begin, int end, float deltaTime);
+void findProjectileHitsScalar(ArchetypeLanes& lanes, int begin, int end, const ProjectileTarget* targets, int targetCount);
+int integrateProjectilesAvx2(ArchetypeLanes& lanes, int end, float deltaTime); // 回傳處理到的索引，剩下的交給純量版本
+int findProjectileHitsAvx2(ArchetypeLanes& lanes, int end, const ProjectileTarget* targets, int targetCount);
+bool hasProjectileAvx2Kernel(); // 編譯器/平台不支援時為 false
+
+// --- 固定容量的氣功池 (氣功的 archetype) ---
+// 發射只是寫入下一個空閒欄位 (建立後不再配置記憶體)，移除時把最後一個搬過來補洞 (順序不保留)，
+// 所以批次處理時只會走訪場上的氣功。
+class ProjectilePool {
+public:
+    explicit ProjectilePool(int capacity = MAX_PROJECTILES);
+
+    // 發射一個氣功，回傳索引；池子滿了回傳 -1
+    int spawn(float x, float y, float vx, int owner, Uint8 sprite = PROJECTILE_SPRITE_KI);
+    Projectile get(int index) const;
+    void deactivate(int index) { lanes.alive[index] = 0; }
+    Uint32 getHits(int index) const { return lanes.hits[index]; }
+
+    // 整批移動 (x += vx * dt)，飛出畫面的標記為失效。池裡的氣功在 tick 開始時都是有效的。
+    void integrate(float deltaTime);
+    // 整批 AABB 測試 (跳過發射者與不會受傷的目標)，結果用 getHits 讀取；回傳碰到任何目標的氣功數
+    int findHits(const ProjectileTarget* targets, int targetCount);
+    // 移除失效的氣功 (拿最後一個補洞)
+    void removeInactive() { lanes.removeInactive(); }
+
+    void clear() { lanes.clear(); }
+    int size() const { return lanes.count; }
+    bool empty() const { return lanes.count == 0; }
+    int getCapacity() const { return lanes.capacity; }
+
+    // 是否使用 AVX2 核心 (預設在 CPU 支援時使用)
+    void setUseAvx2(bool use) { useAvx2 = use && isAvx2Available(); }
+    static bool isAvx2Available();
+
+    const ArchetypeLanes& getLanes() const { return lanes; }
+
+private:
+    ArchetypeLanes lanes;
+    bool useAvx2;
+};
+
+// --- 命令列：--projectile-bench [氣功數] [tick 數] ---
+struct ProjectileBenchOptions {
+    bool enabled = false;
+    int count = 0;  // 0: 使用預設值
+    int ticks = 0;
+};
+void parseProjectileBenchArgs(int argc, char* argv[], ProjectileBenchOptions& out);
+
+// 量測整批移動 + AABB 測試的耗時 (純量與 AVX2 各跑一次並比對結果)，結果不一致時回傳 false
+bool benchmarkProjectiles(int count, int ticks);
+
+#endif // PROJECTILE_H
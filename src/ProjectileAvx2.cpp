@@ -0,0 +1,74 @@
+#include "Projectile.h"
+
+// 只有這個檔案的核心以 AVX2 編譯，執行時由 ProjectilePool 檢查 CPU 是否支援。
+// 刻意不開 FMA：x += vx * dt 必須先乘後加，結果才會跟純量核心 (與重播/連線對戰) 一致。
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#include <immintrin.h>
+
+int integrateProjectilesAvx2(ArchetypeLanes& lanes, int end, float deltaTime) {
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 minX = _mm256_set1_ps(static_cast<float>(-PROJECTILE_HITBOX_W));
+    const __m256 maxX = _mm256_set1_ps(static_cast<float>(SCREEN_WIDTH));
+    int i = 0;
+    for (; i + 8 <= end; i += 8) {
+        __m256 x = _mm256_add_ps(_mm256_loadu_ps(&lanes.x[i]), _mm256_mul_ps(_mm256_loadu_ps(&lanes.vx[i]), dt));
+        _mm256_storeu_ps(&lanes.x[i], x);
+        __m256 offscreen = _mm256_or_ps(_mm256_cmp_ps(x, minX, _CMP_LT_OQ), _mm256_cmp_ps(x, maxX, _CMP_GT_OQ));
+        __m256i* alive = reinterpret_cast<__m256i*>(&lanes.alive[i]);
+        _mm256_storeu_si256(alive, _mm256_andnot_si256(_mm256_castps_si256(offscreen), _mm256_loadu_si256(alive)));
+    }
+    return i;
+}
+
+int findProjectileHitsAvx2(ArchetypeLanes& lanes, int end, const ProjectileTarget* targets, int targetCount) {
+    const __m256 width = _mm256_set1_ps(static_cast<float>(PROJECTILE_HITBOX_W));
+    const __m256 height = _mm256_set1_ps(static_cast<float>(PROJECTILE_HITBOX_H));
+    const __m256i zero = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= end; i += 8) {
+        __m256 left = _mm256_loadu_ps(&lanes.x[i]);
+        __m256 top = _mm256_loadu_ps(&lanes.y[i]);
+        __m256 right = _mm256_add_ps(left, width);
+        __m256 bottom = _mm256_add_ps(top, height);
+        __m256i owner = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&lanes.owner[i]));
+        __m256i hits = zero;
+        for (int t = 0; t < targetCount; ++t) {
+            const ProjectileTarget& target = targets[t];
+            if (!target.vulnerable) continue;
+            __m256 overlap = _mm256_and_ps(_mm256_cmp_ps(right, _mm256_set1_ps(target.left), _CMP_GT_OQ),
+                                           _mm256_cmp_ps(left, _mm256_set1_ps(target.right), _CMP_LT_OQ));
+            overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(bottom, _mm256_set1_ps(target.top), _CMP_GT_OQ));
+            overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(top, _mm256_set1_ps(target.bottom), _CMP_LT_OQ));
+            // 跳過發射者
+            __m256i m = _mm256_andnot_si256(_mm256_cmpeq_epi32(owner, _mm256_set1_epi32(t)), _mm256_castps_si256(overlap));
+            hits = _mm256_or_si256(hits, _mm256_and_si256(m, _mm256_set1_epi32(static_cast<int>(1u << t))));
+        }
+        __m256i alive = _mm256_cmpgt_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&lanes.alive[i])), zero);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&lanes.hits[i]), _mm256_and_si256(hits, alive));
+    }
+    return i;
+}
+
+#pragma GCC pop_options
+
+bool hasProjectileAvx2Kernel() {
+    return true;
+}
+
+#else
+
+int integrateProjectilesAvx2(ArchetypeLanes&, int, float) {
+    return 0;
+}
+
+int findProjectileHitsAvx2(ArchetypeLanes&, int, const ProjectileTarget*, int) {
+    return 0;
+}
+
+bool hasProjectileAvx2Kernel() {
+    return false;
+}
+
+#endif
@@ -0,0 +1,170 @@
+#include "Replay.h"
+#include "Constants.h"
+#include <stdio.h>   // for printf
+#include <cstring>   // for memcpy
+
+namespace {
+
+// 取得 prev 在 i 位置的位元組 (超出長度視為 0)
+inline Uint8 byteAt(const std::vector<Uint8>& prev, size_t i) {
+    return i < prev.size() ? prev[i] : 0;
+}
+
+// 差分編碼：cur XOR prev 後，以 [零值長度][非零長度][非零位元組...] 的遊程格式儲存
+// 開頭 4 bytes 為 cur 的長度
+void encodeDelta(const std::vector<Uint8>& prev, const std::vector<Uint8>& cur, std::vector<Uint8>& out) {
+    out.clear();
+    Uint32 size = static_cast<Uint32>(cur.size());
+    const Uint8* sizeBytes = reinterpret_cast<const Uint8*>(&size);
+    out.insert(out.end(), sizeBytes, sizeBytes + sizeof(size));
+
+    size_t i = 0;
+    while (i < cur.size()) {
+        Uint8 zeroRun = 0;
+        while (i < cur.size() && zeroRun < 255 && (cur[i] ^ byteAt(prev, i)) == 0) {
+            ++zeroRun;
+            ++i;
+        }
+        size_t literalStart = i;
+        Uint8 literalRun = 0;
+        while (i < cur.size() && literalRun < 255 && (cur[i] ^ byteAt(prev, i)) != 0) {
+            ++literalRun;
+            ++i;
+        }
+        out.push_back(zeroRun);
+        out.push_back(literalRun);
+        for (size_t j = literalStart; j < literalStart + literalRun; ++j) {
+            out.push_back(cur[j] ^ byteAt(prev, j));
+        }
+    }
+}
+
+// 差分解碼 (encodeDelta 的反向操作)
+bool decodeDelta(const std::vector<Uint8>& prev, const std::vector<Uint8>& encoded, std::vector<Uint8>& out) {
+    if (encoded.size() < sizeof(Uint32)) return false;
+    Uint32 size = 0;
+    memcpy(&size, encoded.data(), sizeof(size));
+
+    out.resize(size);
+    for (size_t i = 0; i < size; ++i) out[i] = byteAt(prev, i);
+
+    size_t pos = sizeof(Uint32);
+    size_t i = 0;
+    while (pos + 2 <= encoded.size()) {
+        Uint8 zeroRun = encoded[pos++];
+        Uint8 literalRun = encoded[pos++];
+        i += zeroRun;
+        if (i + literalRun > size || pos + literalRun > encoded.size()) return false;
+        for (Uint8 j = 0; j < literalRun; ++j) {
+            out[i++] ^= encoded[pos++];
+        }
+    }
+    return pos == encoded.size();
+}
+
+} // namespace
+
+void Replay::begin(const ReplayHeader& newHeader) {
+    clear();
+    header = newHeader;
+    if (header.keyframeInterval <= 0) header.keyframeInterval = REPLAY_KEYFRAME_INTERVAL;
+    // 一場比賽預設約 3 分鐘，先預留空間避免錄製時頻繁重新配置
+    inputs.reserve(SIM_TICK_RATE * 180);
+}
+
+void Replay::clear() {
+    header = ReplayHeader();
+    inputs.clear();
+    keyframes.clear();
+    lastKeyframeBytes.clear();
+    rawKeyframeBytes = 0;
+    cachedKeyframeIndex = -1;
+    cachedKeyframeBytes.clear();
+}
+
+bool Replay::needsKeyframe() const {
+    return header.keyframeInterval > 0 && inputs.size() % header.keyframeInterval == 0;
+}
+
+void Replay::addKeyframe(const MatchSnapshot& snapshot) {
+    std::vector<Uint8> bytes;
+    serializeSnapshot(snapshot, bytes);
+
+    Keyframe keyframe;
+    keyframe.tick = getTickCount();
+    keyframe.isFull = (keyframes.size() % REPLAY_FULL_KEYFRAME_EVERY) == 0;
+    static const std::vector<Uint8> empty;
+    encodeDelta(keyframe.isFull ? empty : lastKeyframeBytes, bytes, keyframe.data);
+    keyframe.data.shrink_to_fit();
+
+    rawKeyframeBytes += bytes.size();
+    lastKeyframeBytes.swap(bytes);
+    keyframes.push_back(std::move(keyframe));
+}
+
+void Replay::addInput(const TickInput& input) {
+    inputs.push_back(input);
+}
+
+bool Replay::decodeKeyframe(int index, std::vector<Uint8>& out) const {
+    if (index < 0 || index >= static_cast<int>(keyframes.size())) return false;
+
+    // 從最近的完整關鍵幀開始 (若快取落在中間，直接從快取往後解)
+    int start = index;
+    while (start > 0 && !keyframes[start].isFull) --start;
+
+    std::vector<Uint8> current;
+    int from = start;
+    if (cachedKeyframeIndex >= start && cachedKeyframeIndex <= index) {
+        current = cachedKeyframeBytes;
+        from = cachedKeyframeIndex + 1;
+    }
+
+    std::vector<Uint8> next;
+    for (int i = from; i <= index; ++i) {
+        static const std::vector<Uint8> empty;
+        if (!decodeDelta(keyframes[i].isFull ? empty : current, keyframes[i].data, next)) {
+            printf("Replay: failed to decode keyframe %d\n", i);
+            return false;
+        }
+        current.swap(next);
+    }
+
+    cachedKeyframeIndex = index;
+    cachedKeyframeBytes = current;
+    out.swap(current);
+    return true;
+}
+
+bool Replay::getKeyframeForTick(Uint32 tick, MatchSnapshot& out) const {
+    if (keyframes.empty()) return false;
+    int index = static_cast<int>(tick / header.keyframeInterval);
+    if (index >= static_cast<int>(keyframes.size())) index = static_cast<int>(keyframes.size()) - 1;
+
+    std::vector<Uint8> bytes;
+    if (!decodeKeyframe(index, bytes)) return false;
+    return deserializeSnapshot(bytes, out);
+}
+
+size_t Replay::getMemoryUsage() const {
+    size_t total = inputs.size() * sizeof(TickInput);
+    for (const Keyframe& keyframe : keyframes) {
+        total += keyframe.data.size() + sizeof(Keyframe);
+    }
+    return total;
+}
+
+float Replay::getBytesPerMinute() const {
+    if (inputs.empty()) return 0.0f;
+    float minutes = inputs.size() / (float)(SIM_TICK_RATE * 60);
+    return getMemoryUsage() / minutes;
+}
+
+void Replay::printStats() const {
+    size_t compressed = 0;
+    for (const Keyframe& keyframe : keyframes) compressed += keyframe.data.size();
+    printf("Replay: %u ticks (%.1fs), %zu keyframes, inputs %zu B, keyframes %zu B (raw %zu B), total %zu B, %.1f KB/min\n",
+           getTickCount(), getTickCount() / (float)SIM_TICK_RATE, keyframes.size(),
+           inputs.size() * sizeof(TickInput), compressed, rawKeyframeBytes,
+           getMemoryUsage(), getBytesPerMinute() / 1024.0f);
+}
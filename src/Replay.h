@@ -0,0 +1,75 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include "Input.h"
+#include "Snapshot.h"
+
+// --- 重播的整場固定資訊 (重建玩家物件用) ---
+struct ReplayHeader {
+    int playerCount = 2;
+    std::string characterIds[MAX_PLAYERS];
+    int gloveIndex[MAX_PLAYERS] = {};
+    bool chaosMode = false;
+    int keyframeInterval = 0;
+};
+
+// --- 比賽重播 ---
+// 每個 tick 記錄雙方輸入，並每隔 keyframeInterval 個 tick 存一個關鍵幀快照。
+// 關鍵幀以「與前一關鍵幀 XOR 後的零值遊程編碼」壓縮，每 REPLAY_FULL_KEYFRAME_EVERY 個存一次完整快照，
+// 跳轉時只需解碼最近的關鍵幀，再模擬剩下不到 keyframeInterval 個 tick。
+class Replay {
+public:
+    // 開始新的錄製 (清除舊資料)
+    void begin(const ReplayHeader& newHeader);
+
+    // 清除所有資料
+    void clear();
+
+    // 目前這個 tick 是否需要存關鍵幀 (在模擬該 tick 之前呼叫)
+    bool needsKeyframe() const;
+
+    // 存入關鍵幀 (代表第 getTickCount() 個 tick 模擬之前的狀態)
+    void addKeyframe(const MatchSnapshot& snapshot);
+
+    // 記錄一個 tick 的輸入
+    void addInput(const TickInput& input);
+
+    // 取得離 tick 最近 (且不超過) 的關鍵幀，回傳 false 表示沒有資料
+    bool getKeyframeForTick(Uint32 tick, MatchSnapshot& out) const;
+
+    const TickInput& getInput(Uint32 tick) const { return inputs[tick]; }
+    Uint32 getTickCount() const { return static_cast<Uint32>(inputs.size()); }
+    const ReplayHeader& getHeader() const { return header; }
+    bool isEmpty() const { return keyframes.empty(); }
+
+    // 記憶體使用量 (輸入 + 壓縮後的關鍵幀)
+    size_t getMemoryUsage() const;
+    // 每分鐘重播的平均記憶體使用量 (bytes)
+    float getBytesPerMinute() const;
+    // 印出錄製統計
+    void printStats() const;
+
+private:
+    struct Keyframe {
+        Uint32 tick = 0;
+        bool isFull = false;        // true: 對空白資料編碼 (可獨立解碼)
+        std::vector<Uint8> data;    // 壓縮後的資料
+    };
+
+    bool decodeKeyframe(int index, std::vector<Uint8>& out) const;
+
+    ReplayHeader header;
+    std::vector<TickInput> inputs;
+    std::vector<Keyframe> keyframes;
+    std::vector<Uint8> lastKeyframeBytes;  // 上一個關鍵幀的未壓縮資料 (錄製時做差分用)
+    size_t rawKeyframeBytes = 0;           // 未壓縮前的關鍵幀總大小 (統計用)
+
+    // 解碼快取：倒帶時常常重複解碼同一段關鍵幀鏈
+    mutable int cachedKeyframeIndex = -1;
+    mutable std::vector<Uint8> cachedKeyframeBytes;
+};
+
+#endif // REPLAY_H
@@ -0,0 +1,89 @@
+#include "ScriptedAI.h"
+#include "Game.h"
+#include "Input.h"
+#include <cmath>
+
+namespace {
+
+// --- AI 行為參數 ---
+const int   AI_MIN_REACTION_TICKS = 6;       // 每次決定至少維持的 tick 數
+const int   AI_REACTION_JITTER_TICKS = 10;   // 額外隨機維持的 tick 數
+const float AI_ATTACK_RANGE = 40.0f;         // 兩人間距小於此值就進攻
+const float AI_PROJECTILE_ALERT = 260.0f;    // 對手氣功距離小於此值就閃避/格擋
+
+} // namespace
+
+ScriptedAI::ScriptedAI(Uint32 seed) : rngState(seed ? seed : 1) {}
+
+Uint32 ScriptedAI::nextRandom() {
+    // xorshift32 (跟混亂事件用同一種，結果與平台無關)
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+bool ScriptedAI::chance(int percent) {
+    return static_cast<int>(nextRandom() % 100) < percent;
+}
+
+Uint16 ScriptedAI::decide(const Game& game, int playerIndex) {
+    if (game.players.size() < 2) return 0;
+    const Player& self = game.players[playerIndex];
+    const Player& opponent = game.players[game.findNearestOpponent(playerIndex)]; // 大亂鬥時盯著最近的對手
+    if (!self.isAlive() || game.currentGameState != GameState::PLAYING) {
+        heldButtons = 0;
+        reactionTimer = 0;
+        return 0;
+    }
+
+    // 反應時間內維持上一個決定
+    if (reactionTimer > 0) {
+        --reactionTimer;
+        return heldButtons;
+    }
+    reactionTimer = AI_MIN_REACTION_TICKS + static_cast<int>(nextRandom() % AI_REACTION_JITTER_TICKS);
+
+    float selfCenter = self.x + self.logicWidth / 2.0f;
+    float opponentCenter = opponent.x + opponent.logicWidth / 2.0f;
+    float gap = std::fabs(opponentCenter - selfCenter) - (self.logicWidth + opponent.logicWidth) / 2.0f;
+    Uint16 toward = (opponentCenter > selfCenter) ? INPUT_RIGHT : INPUT_LEFT;
+    Uint16 away = (toward == INPUT_RIGHT) ? INPUT_LEFT : INPUT_RIGHT;
+
+    // 對手的氣功正在飛過來
+    bool projectileIncoming = false;
+    for (int i = 0; i < game.world.projectiles.size(); ++i) {
+        const Projectile proj = game.world.projectiles.get(i);
+        if (!proj.isActive || proj.ownerPlayerIndex == playerIndex) continue;
+        float dx = selfCenter - proj.x;
+        if ((dx > 0.0f) == (proj.vx > 0.0f) && std::fabs(dx) < AI_PROJECTILE_ALERT) {
+            projectileIncoming = true;
+            break;
+        }
+    }
+
+    Uint16 buttons = 0;
+    if (projectileIncoming) {
+        buttons = chance(60) ? INPUT_BLOCK : INPUT_UP;
+    } else if (gap > AI_ATTACK_RANGE) {
+        // 遠距離：靠近，偶爾發氣功或跳躍
+        buttons = toward;
+        if (self.canFireProjectile() && chance(30)) buttons |= INPUT_FIRE_PRESSED;
+        if (chance(5)) buttons |= INPUT_UP;
+    } else {
+        // 近距離：以普攻為主，夾雜格擋、後退與技能
+        int roll = static_cast<int>(nextRandom() % 100);
+        if (roll < 60) {
+            buttons = INPUT_ATTACK;
+        } else if (roll < 75) {
+            buttons = INPUT_BLOCK;
+        } else if (roll < 85) {
+            buttons = away;
+        }
+        if (self.canUseSpecialAttack() && chance(20)) buttons |= INPUT_SPECIAL_PRESSED;
+    }
+
+    // 按下瞬間的事件只送一次，之後維持持續按鍵
+    heldButtons = buttons & ~INPUT_EDGE_MASK;
+    return buttons;
+}
@@ -0,0 +1,27 @@
+#ifndef SCRIPTEDAI_H
+#define SCRIPTEDAI_H
+
+#include <SDL2/SDL.h>
+
+class Game;
+
+// --- 腳本 AI (無畫面模擬與批次對戰用) ---
+// 只讀取遊戲狀態、輸出一個 tick 的按鍵位元 (跟真人輸入走同一條路徑)。
+// 使用自己的 xorshift 亂數，同一個種子每次都會做出相同的決定。
+class ScriptedAI {
+public:
+    explicit ScriptedAI(Uint32 seed = 1);
+
+    // 回傳這個 tick 要按下的按鍵 (InputButton 位元)
+    Uint16 decide(const Game& game, int playerIndex);
+
+private:
+    Uint32 rngState;
+    int reactionTimer = 0;   // 還要維持上一個決定幾個 tick (模擬反應時間)
+    Uint16 heldButtons = 0;  // 維持中的持續按鍵
+
+    Uint32 nextRandom();
+    bool chance(int percent);
+};
+
+#endif // SCRIPTEDAI_H
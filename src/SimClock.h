@@ -0,0 +1,27 @@
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+#include <SDL2/SDL.h>
+#include "Constants.h"
+
+// --- 以模擬 tick 為單位的計時器 ---
+// 計時器只記錄「在哪個 tick 到期」，查詢時才跟模擬時鐘 (Game::matchTick) 比較：
+// 沒有在倒數的計時器每個 tick 都不需要任何運算，快照也只需要保存到期的 tick。
+// 在 tick now 啟動、長度 n 的計時器，在 now ~ now + n - 1 這 n 個 tick 內有效。
+
+// 秒數換算成 tick 數 (四捨五入)
+inline Uint32 secondsToTicks(float seconds) {
+    return seconds > 0.0f ? static_cast<Uint32>(seconds * SIM_TICK_RATE + 0.5f) : 0;
+}
+
+struct TickTimer {
+    Uint32 expiresAt = 0; // 到期的 tick，0 表示沒有在倒數 (時鐘從 0 開始)
+
+    void start(Uint32 now, Uint32 durationTicks) { expiresAt = now + durationTicks; }
+    void clear() { expiresAt = 0; }
+    bool isActive(Uint32 now) const { return now < expiresAt; }
+    Uint32 remainingTicks(Uint32 now) const { return isActive(now) ? expiresAt - now : 0; }
+    float remainingSeconds(Uint32 now) const { return remainingTicks(now) * FIXED_DELTA_TIME; }
+};
+
+#endif // SIM_CLOCK_H
@@ -0,0 +1,191 @@
+#include "Snapshot.h"
+#include <cstring> // for memcpy
+
+namespace {
+
+// 把一個 POD 欄位附加到位元組陣列後面
+template <typename T>
+void put(std::vector<Uint8>& out, const T& value) {
+    const Uint8* bytes = reinterpret_cast<const Uint8*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// 依序讀取欄位的小工具，讀超過結尾時標記失敗
+struct Reader {
+    const std::vector<Uint8>& data;
+    size_t pos = 0;
+    bool ok = true;
+
+    template <typename T>
+    void get(T& value) {
+        if (!ok || pos + sizeof(T) > data.size()) {
+            ok = false;
+            return;
+        }
+        memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+    }
+};
+
+void putPlayer(std::vector<Uint8>& out, const PlayerSnapshot& p) {
+    put(out, p.x); put(out, p.y);
+    put(out, p.vx); put(out, p.vy);
+    put(out, p.health);
+    put(out, p.direction);
+    put(out, p.state);
+    put(out, p.currentAnimationType);
+    put(out, p.isOnGround);
+    put(out, p.shouldFireProjectile);
+    put(out, p.isSpecialAttacking);
+    put(out, p.hasHitDuringDash);
+    put(out, p.blockedByMask);
+    put(out, p.attackTimer);
+    put(out, p.attackCooldownTimer);
+    put(out, p.hurtTimer);
+    put(out, p.invincibilityTimer);
+    put(out, p.blockCooldownTimer);
+    put(out, p.attackRateCooldownTimer);
+    put(out, p.projectileCooldownTimer);
+    put(out, p.specialAttackCooldownTimer);
+    put(out, p.stateEnteredTick);
+    const InputHistory& h = p.inputHistory;
+    for (int i = 0; i < INPUT_HISTORY_LENGTH; ++i) {
+        put(out, h.ticks[i]);
+        put(out, h.buttons[i]);
+    }
+    put(out, h.count);
+    put(out, h.consumedPress);
+    for (int i = 0; i < MOTION_COMMAND_COUNT; ++i) {
+        put(out, h.motionStep[i]);
+        put(out, h.motionStepTick[i]);
+    }
+}
+
+void putChaos(std::vector<Uint8>& out, const ChaosState& c) {
+    put(out, c.rngState);
+    put(out, c.wheelTick);
+    put(out, c.nextEventTick);
+    put(out, c.bannerUntil);
+    put(out, c.lastEvent);
+    put(out, c.bgIndex);
+    put(out, c.modifiers.reverseControls);
+    put(out, c.modifiers.gravityShift);
+    put(out, c.modifiers.speedUp);
+    put(out, c.modifiers.projectileStorm);
+    for (int i = 0; i < MAX_CHAOS_EFFECTS; ++i) {
+        put(out, c.effectType[i]);
+        put(out, c.effectExpires[i]);
+    }
+}
+
+void getPlayer(Reader& in, PlayerSnapshot& p) {
+    in.get(p.x); in.get(p.y);
+    in.get(p.vx); in.get(p.vy);
+    in.get(p.health);
+    in.get(p.direction);
+    in.get(p.state);
+    in.get(p.currentAnimationType);
+    in.get(p.isOnGround);
+    in.get(p.shouldFireProjectile);
+    in.get(p.isSpecialAttacking);
+    in.get(p.hasHitDuringDash);
+    in.get(p.blockedByMask);
+    in.get(p.attackTimer);
+    in.get(p.attackCooldownTimer);
+    in.get(p.hurtTimer);
+    in.get(p.invincibilityTimer);
+    in.get(p.blockCooldownTimer);
+    in.get(p.attackRateCooldownTimer);
+    in.get(p.projectileCooldownTimer);
+    in.get(p.specialAttackCooldownTimer);
+    in.get(p.stateEnteredTick);
+    InputHistory& h = p.inputHistory;
+    for (int i = 0; i < INPUT_HISTORY_LENGTH; ++i) {
+        in.get(h.ticks[i]);
+        in.get(h.buttons[i]);
+    }
+    in.get(h.count);
+    in.get(h.consumedPress);
+    for (int i = 0; i < MOTION_COMMAND_COUNT; ++i) {
+        in.get(h.motionStep[i]);
+        in.get(h.motionStepTick[i]);
+    }
+}
+
+void getChaos(Reader& in, ChaosState& c) {
+    in.get(c.rngState);
+    in.get(c.wheelTick);
+    in.get(c.nextEventTick);
+    in.get(c.bannerUntil);
+    in.get(c.lastEvent);
+    in.get(c.bgIndex);
+    in.get(c.modifiers.reverseControls);
+    in.get(c.modifiers.gravityShift);
+    in.get(c.modifiers.speedUp);
+    in.get(c.modifiers.projectileStorm);
+    for (int i = 0; i < MAX_CHAOS_EFFECTS; ++i) {
+        in.get(c.effectType[i]);
+        in.get(c.effectExpires[i]);
+    }
+}
+
+} // namespace
+
+void serializeSnapshot(const MatchSnapshot& snapshot, std::vector<Uint8>& out) {
+    out.clear();
+    put(out, snapshot.tick);
+    put(out, snapshot.gameState);
+    put(out, snapshot.currentRound);
+    put(out, snapshot.playerCount);
+    for (int i = 0; i < snapshot.playerCount; ++i) {
+        put(out, snapshot.playerWins[i]);
+    }
+    put(out, snapshot.roundTimer);
+    put(out, snapshot.roundOverTimer);
+    put(out, snapshot.roundWinnerIndex);
+    putChaos(out, snapshot.chaos);
+    for (int i = 0; i < snapshot.playerCount; ++i) {
+        putPlayer(out, snapshot.players[i]);
+    }
+
+    Uint32 projectileCount = static_cast<Uint32>(snapshot.projectiles.size());
+    put(out, projectileCount);
+    for (const ProjectileSnapshot& proj : snapshot.projectiles) {
+        put(out, proj.x);
+        put(out, proj.y);
+        put(out, proj.vx);
+        put(out, proj.ownerPlayerIndex);
+    }
+}
+
+bool deserializeSnapshot(const std::vector<Uint8>& data, MatchSnapshot& out) {
+    Reader in{data};
+    in.get(out.tick);
+    in.get(out.gameState);
+    in.get(out.currentRound);
+    in.get(out.playerCount);
+    if (out.playerCount < 0 || out.playerCount > MAX_PLAYERS) return false;
+    for (int i = 0; i < out.playerCount; ++i) {
+        in.get(out.playerWins[i]);
+    }
+    in.get(out.roundTimer);
+    in.get(out.roundOverTimer);
+    in.get(out.roundWinnerIndex);
+    getChaos(in, out.chaos);
+    for (int i = 0; i < out.playerCount; ++i) {
+        getPlayer(in, out.players[i]);
+    }
+
+    Uint32 projectileCount = 0;
+    in.get(projectileCount);
+    out.projectiles.clear();
+    for (Uint32 i = 0; in.ok && i < projectileCount; ++i) {
+        ProjectileSnapshot proj;
+        in.get(proj.x);
+        in.get(proj.y);
+        in.get(proj.vx);
+        in.get(proj.ownerPlayerIndex);
+        out.projectiles.push_back(proj);
+    }
+    return in.ok;
+}
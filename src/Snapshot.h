@@ -0,0 +1,64 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "Constants.h"
+#include "InputHistory.h"
+#include "ChaosEngine.h"
+
+// --- 單一玩家的模擬狀態 (角色、紋理、拳套等整場固定的資料不在這裡) ---
+struct PlayerSnapshot {
+    float x = 0.0f, y = 0.0f;
+    float vx = 0.0f, vy = 0.0f;
+    Sint32 health = 0;
+    Sint32 direction = 1;
+    Uint8 state = 0;                // Player::PlayerState
+    Uint8 currentAnimationType = 0; // AnimationType
+    Uint8 isOnGround = 1;
+    Uint8 shouldFireProjectile = 0;
+    Uint8 isSpecialAttacking = 0;
+    Uint8 hasHitDuringDash = 0;
+    Uint8 blockedByMask = 0;        // 這次攻擊已經被哪些玩家格擋過 (位元 = 玩家編號)
+    // 計時器 (到期的 tick，見 SimClock.h)
+    Uint32 attackTimer = 0;
+    Uint32 attackCooldownTimer = 0;
+    Uint32 hurtTimer = 0;
+    Uint32 invincibilityTimer = 0;
+    Uint32 blockCooldownTimer = 0;
+    Uint32 attackRateCooldownTimer = 0;
+    Uint32 projectileCooldownTimer = 0;
+    Uint32 specialAttackCooldownTimer = 0;
+    Uint32 stateEnteredTick = 0;    // 動畫幀由此推算，不另外保存
+    InputHistory inputHistory;      // 最近的按鍵變化與搓招進度 (緩衝輸入用)
+};
+
+// --- 單一氣功的模擬狀態 (只保存仍在場上的氣功) ---
+struct ProjectileSnapshot {
+    float x = 0.0f, y = 0.0f;
+    float vx = 0.0f;
+    Sint32 ownerPlayerIndex = -1;
+};
+
+// --- 整場比賽在某個 tick 的完整模擬狀態 ---
+struct MatchSnapshot {
+    Uint32 tick = 0;
+    Uint8 gameState = 0;            // GameState
+    Sint32 currentRound = 1;
+    Sint32 playerCount = 2;         // 以下兩個陣列只有前 playerCount 個有效 (大亂鬥最多 MAX_PLAYERS 位)
+    Sint32 playerWins[MAX_PLAYERS] = {};
+    Uint32 roundTimer = 0;          // 計時器皆為到期的 tick
+    Uint32 roundOverTimer = 0;
+    Sint32 roundWinnerIndex = -1;
+    ChaosState chaos;               // 混亂模式 (時間輪由這份狀態重建)
+    PlayerSnapshot players[MAX_PLAYERS];
+    std::vector<ProjectileSnapshot> projectiles;
+};
+
+// 將快照逐欄位序列化成位元組 (固定欄位順序，不含 struct padding，方便做差分壓縮)
+void serializeSnapshot(const MatchSnapshot& snapshot, std::vector<Uint8>& out);
+
+// 從位元組還原快照，資料不完整時回傳 false
+bool deserializeSnapshot(const std::vector<Uint8>& data, MatchSnapshot& out);
+
+#endif // SNAPSHOT_H
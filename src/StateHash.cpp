@@ -0,0 +1,287 @@
+#include "StateHash.h"
+
+namespace {
+
+// --- 欄位清單 (雜湊與比對共用，新增快照欄位時只要改這裡) ---
+#define MATCH_FIELDS(F) \
+    F(tick) F(gameState) F(currentRound) F(playerCount) \
+    F(roundTimer) F(roundOverTimer) F(roundWinnerIndex) \
+    F(chaos.rngState) F(chaos.wheelTick) F(chaos.nextEventTick) F(chaos.bannerUntil) F(chaos.lastEvent) \
+    F(chaos.bgIndex) F(chaos.modifiers.reverseControls) F(chaos.modifiers.gravityShift) \
+    F(chaos.modifiers.speedUp) F(chaos.modifiers.projectileStorm)
+
+// 混亂模式生效中的效果 (MatchSnapshot::chaos) 的陣列欄位，F(名稱, 長度)
+#define CHAOS_ARRAYS(F) F(effectType, MAX_CHAOS_EFFECTS) F(effectExpires, MAX_CHAOS_EFFECTS)
+
+#define PLAYER_FIELDS(F) \
+    F(x) F(y) F(vx) F(vy) F(health) F(direction) F(state) F(currentAnimationType) \
+    F(isOnGround) F(shouldFireProjectile) F(isSpecialAttacking) F(hasHitDuringDash) F(blockedByMask) \
+    F(attackTimer) F(attackCooldownTimer) F(hurtTimer) F(invincibilityTimer) \
+    F(blockCooldownTimer) F(attackRateCooldownTimer) F(projectileCooldownTimer) \
+    F(specialAttackCooldownTimer) F(stateEnteredTick)
+
+#define PROJECTILE_FIELDS(F) F(x) F(y) F(vx) F(ownerPlayerIndex)
+
+// 輸入記錄 (PlayerSnapshot::inputHistory) 的陣列欄位，F(名稱, 長度)
+#define INPUT_HISTORY_ARRAYS(F) \
+    F(ticks, INPUT_HISTORY_LENGTH) F(buttons, INPUT_HISTORY_LENGTH) \
+    F(motionStep, MOTION_COMMAND_COUNT) F(motionStepTick, MOTION_COMMAND_COUNT)
+#define INPUT_HISTORY_FIELDS(F) F(count) F(consumedPress)
+
+const Uint32 LOG_MAGIC = 0x4C484653; // "SFHL"
+
+std::string formatValue(float v) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.6g", v);
+    return buf;
+}
+std::string formatValue(Sint32 v) { return std::to_string(v); }
+std::string formatValue(Uint32 v) { return std::to_string(v); }
+std::string formatValue(Uint16 v) { return std::to_string(v); }
+std::string formatValue(Uint8 v) { return std::to_string(static_cast<int>(v)); }
+
+// 浮點數以位元比較 (跟雜湊一致，-0 與 0 視為不同)
+template <typename T>
+bool sameBits(const T& a, const T& b) {
+    return memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+template <typename T>
+void diffField(std::vector<std::string>& out, const std::string& name, const T& a, const T& b) {
+    if (!sameBits(a, b)) {
+        out.push_back(name + ": " + formatValue(a) + " -> " + formatValue(b));
+    }
+}
+
+} // namespace
+
+Uint32 hashSnapshot(const MatchSnapshot& snapshot) {
+    StateHasher h;
+#define HASH_FIELD(name) h.add(snapshot.name);
+    MATCH_FIELDS(HASH_FIELD)
+#undef HASH_FIELD
+#define HASH_ARRAY(name, length) for (int k = 0; k < (length); ++k) h.add(snapshot.chaos.name[k]);
+    CHAOS_ARRAYS(HASH_ARRAY)
+#undef HASH_ARRAY
+    for (int i = 0; i < snapshot.playerCount; ++i) {
+        h.add(snapshot.playerWins[i]);
+        const PlayerSnapshot& p = snapshot.players[i];
+#define HASH_FIELD(name) h.add(p.name);
+        PLAYER_FIELDS(HASH_FIELD)
+#undef HASH_FIELD
+        const InputHistory& history = p.inputHistory;
+#define HASH_FIELD(name) h.add(history.name);
+        INPUT_HISTORY_FIELDS(HASH_FIELD)
+#undef HASH_FIELD
+#define HASH_ARRAY(name, length) for (int k = 0; k < (length); ++k) h.add(history.name[k]);
+        INPUT_HISTORY_ARRAYS(HASH_ARRAY)
+#undef HASH_ARRAY
+    }
+    h.add(static_cast<Uint32>(snapshot.projectiles.size()));
+    for (const ProjectileSnapshot& proj : snapshot.projectiles) {
+#define HASH_FIELD(name) h.add(proj.name);
+        PROJECTILE_FIELDS(HASH_FIELD)
+#undef HASH_FIELD
+    }
+    return h.finish();
+}
+
+void diffSnapshots(const MatchSnapshot& a, const MatchSnapshot& b, std::vector<std::string>& out) {
+#define DIFF_FIELD(name) diffField(out, #name, a.name, b.name);
+    MATCH_FIELDS(DIFF_FIELD)
+#undef DIFF_FIELD
+#define DIFF_ARRAY(name, length) \
+    for (int k = 0; k < (length); ++k) \
+        diffField(out, "chaos." #name "[" + std::to_string(k) + "]", a.chaos.name[k], b.chaos.name[k]);
+    CHAOS_ARRAYS(DIFF_ARRAY)
+#undef DIFF_ARRAY
+    for (int i = 0; i < a.playerCount && i < b.playerCount; ++i) {
+        diffField(out, "playerWins[" + std::to_string(i) + "]", a.playerWins[i], b.playerWins[i]);
+        const PlayerSnapshot& pa = a.players[i];
+        const PlayerSnapshot& pb = b.players[i];
+        std::string prefix = "players[" + std::to_string(i) + "].";
+#define DIFF_FIELD(name) diffField(out, prefix + #name, pa.name, pb.name);
+        PLAYER_FIELDS(DIFF_FIELD)
+#undef DIFF_FIELD
+        const InputHistory& ha = pa.inputHistory;
+        const InputHistory& hb = pb.inputHistory;
+#define DIFF_FIELD(name) diffField(out, prefix + "inputHistory." #name, ha.name, hb.name);
+        INPUT_HISTORY_FIELDS(DIFF_FIELD)
+#undef DIFF_FIELD
+#define DIFF_ARRAY(name, length) \
+        for (int k = 0; k < (length); ++k) \
+            diffField(out, prefix + "inputHistory." #name "[" + std::to_string(k) + "]", ha.name[k], hb.name[k]);
+        INPUT_HISTORY_ARRAYS(DIFF_ARRAY)
+#undef DIFF_ARRAY
+    }
+    if (a.projectiles.size() != b.projectiles.size()) {
+        out.push_back("projectiles.size: " + std::to_string(a.projectiles.size()) + " -> " +
+                      std::to_string(b.projectiles.size()));
+    }
+    for (size_t i = 0; i < a.projectiles.size() && i < b.projectiles.size(); ++i) {
+        const ProjectileSnapshot& pa = a.projectiles[i];
+        const ProjectileSnapshot& pb = b.projectiles[i];
+        std::string prefix = "projectiles[" + std::to_string(i) + "].";
+#define DIFF_FIELD(name) diffField(out, prefix + #name, pa.name, pb.name);
+        PROJECTILE_FIELDS(DIFF_FIELD)
+#undef DIFF_FIELD
+    }
+}
+
+// --- 命令列參數 ---
+void parseStateHashArgs(int argc, char* argv[], StateHashOptions& out) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--hash-log" && i + 1 < argc) {
+            out.logPath = argv[++i];
+        } else if (arg == "--hash-compare" && i + 1 < argc) {
+            out.comparePath = argv[++i];
+        } else if (arg == "--hash-diff" && i + 2 < argc) {
+            out.diffPaths[0] = argv[++i];
+            out.diffPaths[1] = argv[++i];
+        }
+    }
+}
+
+// --- 雜湊記錄檔 ---
+StateHashLog::~StateHashLog() {
+    endRecording();
+}
+
+bool StateHashLog::loadReference(const std::string& path) {
+    if (!readLog(path, reference)) return false;
+    referenceIndex.clear();
+    for (size_t i = 0; i < reference.size(); ++i) {
+        referenceIndex[reference[i].tick] = i;
+    }
+    printf("StateHash: replays will be compared against %s (%zu ticks)\n", path.c_str(), reference.size());
+    return true;
+}
+
+void StateHashLog::beginRecording() {
+    endRecording();
+    recorded.clear();
+    recordedIndex.clear();
+    keepInMemory = !logPath.empty();
+    if (logPath.empty()) return;
+
+    file = fopen(logPath.c_str(), "wb");
+    if (!file) {
+        printf("StateHash: failed to open %s for writing\n", logPath.c_str());
+        return;
+    }
+    fwrite(&LOG_MAGIC, sizeof(LOG_MAGIC), 1, file);
+    printf("StateHash: logging every tick to %s\n", logPath.c_str());
+}
+
+void StateHashLog::record(const MatchSnapshot& snapshot, Uint32 hash) {
+    if (!isRecording()) return;
+
+    Entry entry;
+    entry.tick = snapshot.tick;
+    entry.hash = hash;
+    serializeSnapshot(snapshot, entry.state);
+    if (file) {
+        Uint16 size = static_cast<Uint16>(entry.state.size());
+        fwrite(&entry.tick, sizeof(entry.tick), 1, file);
+        fwrite(&entry.hash, sizeof(entry.hash), 1, file);
+        fwrite(&size, sizeof(size), 1, file);
+        fwrite(entry.state.data(), 1, size, file);
+    }
+    recordedIndex[entry.tick] = recorded.size();
+    recorded.push_back(std::move(entry));
+}
+
+void StateHashLog::endRecording() {
+    if (file) {
+        fclose(file);
+        file = nullptr;
+    }
+    keepInMemory = false;
+}
+
+void StateHashLog::beginCheck() {
+    diverged = false;
+    divergentTick = 0;
+}
+
+void StateHashLog::check(const MatchSnapshot& snapshot, Uint32 hash) {
+    if (diverged) return;
+    const bool useReference = !reference.empty();
+    const std::vector<Entry>& entries = useReference ? reference : recorded;
+    const EntryIndex& index = useReference ? referenceIndex : recordedIndex;
+    auto it = index.find(snapshot.tick);
+    if (it == index.end()) return;
+    const Entry& expected = entries[it->second];
+    if (expected.hash == hash) return;
+
+    diverged = true;
+    divergentTick = snapshot.tick;
+    Entry live;
+    live.tick = snapshot.tick;
+    live.hash = hash;
+    serializeSnapshot(snapshot, live.state);
+    printDivergence(expected, live, useReference ? "reference" : "original", "replay");
+}
+
+bool StateHashLog::readLog(const std::string& path, std::vector<Entry>& out) {
+    out.clear();
+    FILE* in = fopen(path.c_str(), "rb");
+    if (!in) {
+        printf("StateHash: failed to open %s\n", path.c_str());
+        return false;
+    }
+    Uint32 magic = 0;
+    if (fread(&magic, sizeof(magic), 1, in) != 1 || magic != LOG_MAGIC) {
+        printf("StateHash: %s is not a state hash log\n", path.c_str());
+        fclose(in);
+        return false;
+    }
+    while (true) {
+        Entry entry;
+        Uint16 size = 0;
+        if (fread(&entry.tick, sizeof(entry.tick), 1, in) != 1) break;
+        if (fread(&entry.hash, sizeof(entry.hash), 1, in) != 1) break;
+        if (fread(&size, sizeof(size), 1, in) != 1) break;
+        entry.state.resize(size);
+        if (size > 0 && fread(entry.state.data(), 1, size, in) != size) break;
+        out.push_back(std::move(entry));
+    }
+    fclose(in);
+    return true;
+}
+
+void StateHashLog::printDivergence(const Entry& a, const Entry& b, const char* labelA, const char* labelB) {
+    printf("StateHash: first divergent tick %u (%s %08x, %s %08x)\n", a.tick, labelA, a.hash, labelB, b.hash);
+    MatchSnapshot snapA, snapB;
+    if (!deserializeSnapshot(a.state, snapA) || !deserializeSnapshot(b.state, snapB)) {
+        printf("StateHash: state data missing, no field diff available\n");
+        return;
+    }
+    std::vector<std::string> lines;
+    diffSnapshots(snapA, snapB, lines);
+    for (const std::string& line : lines) {
+        printf("  %s\n", line.c_str());
+    }
+}
+
+bool StateHashLog::compareFiles(const std::string& pathA, const std::string& pathB) {
+    std::vector<Entry> a, b;
+    if (!readLog(pathA, a) || !readLog(pathB, b)) return false;
+
+    std::unordered_map<Uint32, size_t> indexB;
+    for (size_t i = 0; i < b.size(); ++i) indexB[b[i].tick] = i;
+
+    size_t compared = 0;
+    for (const Entry& entry : a) {
+        auto it = indexB.find(entry.tick);
+        if (it == indexB.end()) continue;
+        ++compared;
+        if (b[it->second].hash != entry.hash) {
+            printDivergence(entry, b[it->second], pathA.c_str(), pathB.c_str());
+            return false;
+        }
+    }
+    printf("StateHash: %zu common ticks identical (%zu vs %zu ticks logged)\n", compared, a.size(), b.size());
+    return true;
+}
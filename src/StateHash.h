@@ -0,0 +1,117 @@
+#ifndef STATEHASH_H
+#define STATEHASH_H
+
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <cstring> // for memcpy
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "Snapshot.h"
+
+// --- 模擬狀態雜湊 ---
+// 逐欄位把數值混進 32-bit 雜湊 (murmur3 的混合步驟)，不做序列化也不配置記憶體，
+// 每個 tick 都算一次也幾乎沒有成本。浮點數以位元樣式計算，所以只要有一個位元不同就會不同。
+class StateHasher {
+public:
+    void add(Uint32 word) {
+        word *= 0xcc9e2d51u;
+        word = (word << 15) | (word >> 17);
+        word *= 0x1b873593u;
+        hash ^= word;
+        hash = (hash << 13) | (hash >> 19);
+        hash = hash * 5 + 0xe6546b64u;
+        ++length;
+    }
+    void add(Sint32 value) { add(static_cast<Uint32>(value)); }
+    void add(Uint16 value) { add(static_cast<Uint32>(value)); }
+    void add(Uint8 value) { add(static_cast<Uint32>(value)); }
+    void add(float value) {
+        Uint32 bits;
+        memcpy(&bits, &value, sizeof(bits));
+        add(bits);
+    }
+
+    Uint32 finish() const {
+        Uint32 h = hash ^ (length * 4);
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+private:
+    Uint32 hash = 0x9747b28cu;
+    Uint32 length = 0;
+};
+
+// 快照的雜湊值 (涵蓋玩家物理/計時器、氣功、回合計時與混亂模式狀態)
+Uint32 hashSnapshot(const MatchSnapshot& snapshot);
+
+// 逐欄位比對兩個快照，每個不同的欄位輸出一行 "欄位: a -> b"
+void diffSnapshots(const MatchSnapshot& a, const MatchSnapshot& b, std::vector<std::string>& out);
+
+// --- 命令列參數 ---
+struct StateHashOptions {
+    std::string logPath;      // --hash-log <檔案>：記錄每個 tick 的雜湊與狀態
+    std::string comparePath;  // --hash-compare <檔案>：跟之前的記錄逐 tick 比對
+    std::string diffPaths[2]; // --hash-diff <a> <b>：離線比對兩份記錄後結束
+};
+void parseStateHashArgs(int argc, char* argv[], StateHashOptions& out);
+
+// --- 雜湊記錄檔 ---
+// 每個 tick 存 [tick][雜湊][快照長度][序列化快照]，比對時先比雜湊，
+// 第一個不同的 tick 再把兩邊的快照還原出來做欄位層級的比對。
+class StateHashLog {
+public:
+    ~StateHashLog();
+
+    // 設定記錄檔路徑 (之後每場比賽開始時重新寫入)
+    void setLogPath(const std::string& path) { logPath = path; }
+    // 載入參考記錄，重播時改跟它比對 (沒有載入時跟本次執行錄下的比賽比對)
+    bool loadReference(const std::string& path);
+
+    // 比賽開始：清除上一場的記錄並重新開啟記錄檔
+    void beginRecording();
+    // 記錄模擬完 snapshot.tick 個 tick 後的狀態
+    void record(const MatchSnapshot& snapshot, Uint32 hash);
+    void endRecording();
+
+    // 重播開始：清除之前的比對結果
+    void beginCheck();
+    // 跟參考記錄比對，第一次不同時印出欄位層級的差異
+    void check(const MatchSnapshot& snapshot, Uint32 hash);
+
+    bool isRecording() const { return file != nullptr || keepInMemory; }
+    bool hasDivergence() const { return diverged; }
+    Uint32 getDivergentTick() const { return divergentTick; }
+
+    // 離線比對兩份記錄，回傳 true 表示完全一致
+    static bool compareFiles(const std::string& pathA, const std::string& pathB);
+
+private:
+    struct Entry {
+        Uint32 tick = 0;
+        Uint32 hash = 0;
+        std::vector<Uint8> state;
+    };
+    typedef std::unordered_map<Uint32, size_t> EntryIndex; // tick -> 索引 (重播跳轉後也能比對)
+
+    static bool readLog(const std::string& path, std::vector<Entry>& out);
+    static void printDivergence(const Entry& a, const Entry& b, const char* labelA, const char* labelB);
+
+    std::string logPath;
+    FILE* file = nullptr;
+    bool keepInMemory = false;
+    std::vector<Uint8> writeBuffer;
+    std::vector<Entry> recorded;     // 本次執行錄下的比賽
+    EntryIndex recordedIndex;
+    std::vector<Entry> reference;    // --hash-compare 載入的記錄
+    EntryIndex referenceIndex;
+    bool diverged = false;
+    Uint32 divergentTick = 0;
+};
+
+#endif // STATEHASH_H
@@ -0,0 +1,89 @@
+#include "TimerWheel.h"
+
+void TimerWheel::reset(Uint32 currentTick) {
+    for (int& head : slots) head = -1;
+    for (int i = 0; i < TIMER_WHEEL_CAPACITY; ++i) {
+        nodes[i].slot = -1;
+        nodes[i].next = i + 1 < TIMER_WHEEL_CAPACITY ? i + 1 : -1;
+    }
+    freeList = 0;
+    count = 0;
+    current = currentTick;
+}
+
+int TimerWheel::schedule(Uint32 expiresAt, int payload) {
+    if (freeList < 0) return -1;
+    int handle = freeList;
+    freeList = nodes[handle].next;
+    nodes[handle].expiresAt = expiresAt > current ? expiresAt : current + 1; // 已經過去的 tick 排到下一個 tick
+    nodes[handle].payload = payload;
+    place(handle);
+    ++count;
+    return handle;
+}
+
+void TimerWheel::cancel(int handle) {
+    if (handle < 0 || handle >= TIMER_WHEEL_CAPACITY || nodes[handle].slot < 0) return;
+    unlink(handle);
+    nodes[handle].next = freeList;
+    freeList = handle;
+    --count;
+}
+
+int TimerWheel::advance(int* fired) {
+    ++current;
+    // 先從最上層往下分配，剛好在這個 tick 到期的計時器會落到第 0 層目前這一格
+    if ((current & (TIMER_WHEEL_SLOTS - 1)) == 0) {
+        if (((current >> TIMER_WHEEL_SLOT_BITS) & (TIMER_WHEEL_SLOTS - 1)) == 0) cascade(2);
+        cascade(1);
+    }
+    int firedCount = 0;
+    int& head = slots[current & (TIMER_WHEEL_SLOTS - 1)];
+    while (head >= 0) {
+        int handle = head;
+        fired[firedCount++] = nodes[handle].payload;
+        cancel(handle);
+    }
+    return firedCount;
+}
+
+void TimerWheel::place(int handle) {
+    Node& node = nodes[handle];
+    Uint32 expiresAt = node.expiresAt;
+    Uint32 delta = expiresAt - current; // 重新分配時可能是 0 (這個 tick 到期)
+    int slot;
+    if (delta < static_cast<Uint32>(TIMER_WHEEL_SLOTS)) {
+        slot = expiresAt & (TIMER_WHEEL_SLOTS - 1);
+    } else if (delta < (1u << (2 * TIMER_WHEEL_SLOT_BITS))) {
+        slot = TIMER_WHEEL_SLOTS + ((expiresAt >> TIMER_WHEEL_SLOT_BITS) & (TIMER_WHEEL_SLOTS - 1));
+    } else {
+        // 超過一圈的放在最後才會輪到的那一格，輪到時再依剩下的距離重新分配
+        Uint32 level2 = delta < (1u << (3 * TIMER_WHEEL_SLOT_BITS)) ? (expiresAt >> (2 * TIMER_WHEEL_SLOT_BITS))
+                                                                   : (current >> (2 * TIMER_WHEEL_SLOT_BITS)) - 1;
+        slot = 2 * TIMER_WHEEL_SLOTS + (level2 & (TIMER_WHEEL_SLOTS - 1));
+    }
+    node.slot = slot;
+    node.prev = -1;
+    node.next = slots[slot];
+    if (node.next >= 0) nodes[node.next].prev = handle;
+    slots[slot] = handle;
+}
+
+void TimerWheel::unlink(int handle) {
+    Node& node = nodes[handle];
+    if (node.prev >= 0) nodes[node.prev].next = node.next;
+    else slots[node.slot] = node.next;
+    if (node.next >= 0) nodes[node.next].prev = node.prev;
+    node.slot = -1;
+}
+
+void TimerWheel::cascade(int level) {
+    int slot = level * TIMER_WHEEL_SLOTS + ((current >> (level * TIMER_WHEEL_SLOT_BITS)) & (TIMER_WHEEL_SLOTS - 1));
+    int handle = slots[slot];
+    slots[slot] = -1;
+    while (handle >= 0) {
+        int next = nodes[handle].next;
+        place(handle);
+        handle = next;
+    }
+}
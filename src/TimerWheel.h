@@ -0,0 +1,48 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <SDL2/SDL.h>
+
+// --- 階層式時間輪 (以模擬 tick 為單位) ---
+// 三層各 64 格：第 0 層一格 1 tick、第 1 層一格 64 tick、第 2 層一格 4096 tick (60Hz 下約 73 分鐘一圈)。
+// 排程與取消都是常數時間 (雙向串列)，每前進一個 tick 只看第 0 層的一格，
+// 跨過 64 / 4096 的邊界時才把上層的那一格重新分配到下層。計時器放在固定大小的池子，不配置記憶體。
+const int TIMER_WHEEL_SLOT_BITS = 6;
+const int TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_SLOT_BITS;
+const int TIMER_WHEEL_LEVELS = 3;
+const int TIMER_WHEEL_CAPACITY = 32;     // 同時存在的計時器上限
+
+class TimerWheel {
+public:
+    TimerWheel() { reset(0); }
+
+    // 清空所有計時器，currentTick 之前 (含) 的 tick 視為已經處理過
+    void reset(Uint32 currentTick);
+    // 在 expiresAt 到期時回傳 payload；已經過去的 tick 在下一次 advance 到期。池子滿了回傳 -1
+    int schedule(Uint32 expiresAt, int payload);
+    void cancel(int handle);
+    // 前進一個 tick，把這個 tick 到期的 payload 寫進 fired，回傳個數 (最多 TIMER_WHEEL_CAPACITY)
+    int advance(int* fired);
+
+    Uint32 currentTick() const { return current; }
+    int size() const { return count; }
+
+private:
+    struct Node {
+        Uint32 expiresAt;
+        int payload;
+        int slot;    // 所在的格子 (層 * TIMER_WHEEL_SLOTS + 格)，-1 表示沒有使用
+        int prev, next;
+    };
+    Node nodes[TIMER_WHEEL_CAPACITY];
+    int slots[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+    int freeList;
+    int count;
+    Uint32 current;
+
+    void place(int handle);     // 依到期時間與 current 的距離放進對應層的格子
+    void unlink(int handle);
+    void cascade(int level);    // 把第 level 層目前這一格的計時器重新分配到下層
+};
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,373 @@
+#include "VecEnv.h"
+#include "VecEnvKernel.h"
+#include "Game.h"
+#include "ScriptedAI.h"
+#include "Log.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cctype>
+#include <stdlib.h>
+#include <stdio.h>
+
+namespace {
+
+// --- 純量通道：一次一場 (沒有 AVX2 時使用，也是 AVX2 版本的對照) ---
+struct ScalarLanes {
+    static const int WIDTH = 1;
+    typedef float F;
+    typedef Sint32 I;
+    typedef bool M;
+
+    static F load(const float* p) { return *p; }
+    static I load(const Sint32* p) { return *p; }
+    static void store(float* p, F v) { *p = v; }
+    static void store(Sint32* p, I v) { *p = v; }
+    static F constF(float v) { return v; }
+    static I constI(Sint32 v) { return v; }
+
+    static F add(F a, F b) { return a + b; }
+    static F sub(F a, F b) { return a - b; }
+    static F mul(F a, F b) { return a * b; }
+    static F div(F a, F b) { return a / b; }
+    static F abs(F a) { return fabsf(a); }
+    static I add(I a, I b) { return a + b; }
+    static I sub(I a, I b) { return a - b; }
+    static I half(I a) { return a / 2; }
+    static I truncate(F a) { return static_cast<I>(a); }
+    static F toFloat(I a) { return static_cast<F>(a); }
+
+    static M lt(F a, F b) { return a < b; }
+    static M le(F a, F b) { return a <= b; }
+    static M gt(F a, F b) { return a > b; }
+    static M ge(F a, F b) { return a >= b; }
+    static M eq(I a, I b) { return a == b; }
+    static M lt(I a, I b) { return a < b; }
+    static M le(I a, I b) { return a <= b; }
+    static M gt(I a, I b) { return a > b; }
+
+    static M mAnd(M a, M b) { return a && b; }
+    static M mOr(M a, M b) { return a || b; }
+    static M mNot(M a) { return !a; }
+    static M trueMask() { return true; }
+    static M falseMask() { return false; }
+    static M bitSet(I bits, Sint32 bit) { return (bits & bit) != 0; }
+    static M toMask(I v) { return v != 0; }
+    static I fromMask(M m) { return m ? 1 : 0; }
+
+    static F sel(M m, F a, F b) { return m ? a : b; }
+    static I sel(M m, I a, I b) { return m ? a : b; }
+    static M selM(M m, M a, M b) { return m ? a : b; }
+};
+
+} // namespace
+
+void stepVecEnvScalar(VecEnvLanes& lanes) {
+    vecenv::stepLanes<ScalarLanes>(lanes);
+}
+
+void VecEnvFighters::resize(int count) {
+    for (std::vector<float>* v : {&x, &y, &vx, &vy}) {
+        v->assign(count, 0.0f);
+    }
+    for (std::vector<Sint32>* v : {&attackTimer, &attackCooldownTimer, &hurtTimer, &invincibilityTimer,
+                                   &blockCooldownTimer, &attackRateCooldownTimer, &health, &direction, &state,
+                                   &isOnGround, &logicWidth, &logicHeight, &attackDamage, &attackCooldownTicks,
+                                   &buttons, &prevButtons, &attackPressTick, &attackPressConsumed,
+                                   &inputBufferTicks, &hitboxRightX, &hitboxLeftX, &hitboxY, &hitboxW, &hitboxH,
+                                   &attackActiveStart, &attackActiveEnd, &lyingHeight}) {
+        v->assign(count, 0);
+    }
+}
+
+// --- VecEnv ---
+VecEnv::VecEnv(int newMatchCount) : matchCount(newMatchCount < 1 ? 1 : newMatchCount) {
+    lanes.count = (matchCount + VECENV_LANE_PADDING - 1) / VECENV_LANE_PADDING * VECENV_LANE_PADDING;
+    lanes.fighters[0].resize(lanes.count);
+    lanes.fighters[1].resize(lanes.count);
+    lanes.tick.assign(lanes.count, 0);
+    lanes.roundTimer.assign(lanes.count, 0);
+    lanes.done.assign(lanes.count, 0);
+    lanes.winner.assign(lanes.count, -1);
+    // 預設 P1 BlockMan、P2 Godon，都是 10oz
+    for (int m = 0; m < lanes.count; ++m) {
+        setLoadout(m, 0, "BlockMan", 0);
+        setLoadout(m, 1, "Godon", 0);
+    }
+    useAvx2 = isAvx2Available();
+    reset();
+}
+
+bool VecEnv::isAvx2Available() {
+    static const bool available = hasVecEnvAvx2Kernel() && SDL_HasAVX2() == SDL_TRUE;
+    return available;
+}
+
+void VecEnv::setLoadout(int match, int player, const std::string& characterId, int gloveIndex,
+                        const BalanceParams& balance) {
+    VecEnvFighters& f = lanes.fighters[player];
+    int characterIndex = findCharacterIndex(characterId);
+    const CharacterTraits& traits = CHARACTER_TRAITS[characterIndex < 0 ? 0 : characterIndex];
+    if (gloveIndex < 0 || gloveIndex >= GLOVE_TYPE_COUNT) gloveIndex = 0;
+    f.logicWidth[match] = traits.logicWidth;
+    f.logicHeight[match] = traits.logicHeight;
+    f.attackCooldownTicks[match] = static_cast<Sint32>(secondsToTicks(ATTACK_DURATION + balance.gloveCooldown[gloveIndex]));
+    f.attackDamage[match] = balance.gloveDamage[gloveIndex];
+    // 跟 InputHistory::findBufferedPress 相同的上限
+    f.inputBufferTicks[match] = std::max(0, std::min(balance.inputBufferTicks, INPUT_HISTORY_LENGTH - 2));
+
+    // 普攻動畫：第一段有攻擊框的幀對應到哪些 tick (之後的攻擊框假設跟第一個相同)
+    int index = characterIndex < 0 ? 0 : characterIndex;
+    const AnimationInfo* attack = AnimationDataManager::getAnimationInfo(index, AnimationType::ATTACK);
+    const int attackTicks = static_cast<int>(secondsToTicks(ATTACK_DURATION));
+    f.attackActiveStart[match] = 0;
+    f.attackActiveEnd[match] = 0;
+    SDL_Rect right = {0, 0, 0, 0}, left = {0, 0, 0, 0};
+    for (int tick = 0; attack && tick < attackTicks; ++tick) {
+        const FrameBoxes& boxes = attack->boxes[attack->frameAt(static_cast<Uint32>(tick))];
+        bool started = f.attackActiveEnd[match] > f.attackActiveStart[match];
+        if (boxes.hasHitbox && !started) {
+            f.attackActiveStart[match] = tick;
+            f.attackActiveEnd[match] = tick + 1;
+            right = boxes.hitbox[0];
+            left = boxes.hitbox[1];
+        } else if (boxes.hasHitbox && f.attackActiveEnd[match] == tick) {
+            f.attackActiveEnd[match] = tick + 1;
+        }
+    }
+    f.hitboxRightX[match] = right.x;
+    f.hitboxLeftX[match] = left.x;
+    f.hitboxY[match] = right.y;
+    f.hitboxW[match] = right.w;
+    f.hitboxH[match] = right.h;
+    const AnimationInfo* lying = AnimationDataManager::getAnimationInfo(index, AnimationType::LYING);
+    f.lyingHeight[match] = (lying && !lying->boxes.empty()) ? lying->boxes[0].hurtbox[0].h : traits.logicHeight;
+}
+
+void VecEnv::reset() {
+    for (int m = 0; m < lanes.count; ++m) {
+        resetMatch(m);
+    }
+}
+
+// 與 Game::resetPlayersForRound / startNewRound 相同的初始狀態
+void VecEnv::resetMatch(int match) {
+    for (int p = 0; p < 2; ++p) {
+        VecEnvFighters& f = lanes.fighters[p];
+        f.x[match] = (p == 0) ? 100.0f : SCREEN_WIDTH - 100.0f - PLAYER_LOGIC_WIDTH;
+        f.y[match] = GROUND_LEVEL - PLAYER_LOGIC_HEIGHT;
+        f.vx[match] = 0.0f;
+        f.vy[match] = 0.0f;
+        f.health[match] = PLAYER_DEFAULT_HEALTH;
+        f.direction[match] = (p == 0) ? 1 : -1;
+        f.state[match] = vecenv::STATE_IDLE;
+        f.isOnGround[match] = 1;
+        f.attackTimer[match] = 0;
+        f.attackCooldownTimer[match] = 0;
+        f.hurtTimer[match] = 0;
+        f.invincibilityTimer[match] = 0;
+        f.blockCooldownTimer[match] = 0;
+        f.attackRateCooldownTimer[match] = 0;
+        f.buttons[match] = 0;
+        f.prevButtons[match] = 0;
+        f.attackPressTick[match] = 0;
+        f.attackPressConsumed[match] = 1;
+    }
+    lanes.tick[match] = 0;
+    lanes.roundTimer[match] = static_cast<Sint32>(secondsToTicks(ROUND_TIME_LIMIT));
+    lanes.done[match] = 0;
+    lanes.winner[match] = -1;
+}
+
+void VecEnv::step(const Uint16* actions) {
+    for (int m = 0; m < lanes.count; ++m) {
+        if (lanes.done[m]) resetMatch(m);
+    }
+    for (int m = 0; m < matchCount; ++m) {
+        lanes.fighters[0].buttons[m] = actions[m * 2] & VECENV_ACTION_MASK;
+        lanes.fighters[1].buttons[m] = actions[m * 2 + 1] & VECENV_ACTION_MASK;
+    }
+    if (useAvx2) {
+        stepVecEnvAvx2(lanes);
+    } else {
+        stepVecEnvScalar(lanes);
+    }
+}
+
+// --- 命令列參數 ---
+void parseVecEnvArgs(int argc, char* argv[], VecEnvOptions& out) {
+    for (int i = 1; i < argc; ++i) {
+        bool validate = strcmp(argv[i], "--vecenv-validate") == 0;
+        bool benchmark = strcmp(argv[i], "--vecenv-bench") == 0;
+        if (!validate && !benchmark) continue;
+        out.validate |= validate;
+        out.benchmark |= benchmark;
+        // 後面可以接比賽數與 tick 數
+        if (i + 1 < argc && isdigit(static_cast<unsigned char>(argv[i + 1][0]))) out.matches = atoi(argv[++i]);
+        if (i + 1 < argc && isdigit(static_cast<unsigned char>(argv[i + 1][0]))) out.ticks = atoi(argv[++i]);
+    }
+}
+
+// --- 與純量模擬逐 tick 比對 ---
+namespace {
+
+// 比較一個玩家的所有欄位，浮點數以位元比較；不同時印出並回傳 false
+bool compareFighter(const VecEnv& env, int match, int player, const Player& p, Uint32 tick) {
+    const VecEnvFighters& f = env.getFighters(player);
+    struct FloatField { const char* name; float env; float sim; };
+    const FloatField floats[] = {
+        {"x", f.x[match], p.x}, {"y", f.y[match], p.y},
+        {"vx", f.vx[match], p.vx}, {"vy", f.vy[match], p.vy},
+    };
+    bool same = true;
+    for (const FloatField& field : floats) {
+        if (memcmp(&field.env, &field.sim, sizeof(float)) != 0) {
+            printf("VecEnv: match %d tick %u players[%d].%s: sim %.9g, env %.9g\n",
+                   match, tick, player, field.name, field.sim, field.env);
+            same = false;
+        }
+    }
+    struct IntField { const char* name; Sint32 env; Sint32 sim; };
+    const IntField ints[] = {
+        {"health", f.health[match], p.health},
+        {"direction", f.direction[match], p.direction},
+        {"state", f.state[match], static_cast<Sint32>(p.state)},
+        {"isOnGround", f.isOnGround[match], p.isOnGround ? 1 : 0},
+        {"attackTimer", f.attackTimer[match], static_cast<Sint32>(p.attackTimer.expiresAt)},
+        {"attackCooldownTimer", f.attackCooldownTimer[match], static_cast<Sint32>(p.attackCooldownTimer.expiresAt)},
+        {"hurtTimer", f.hurtTimer[match], static_cast<Sint32>(p.hurtTimer.expiresAt)},
+        {"invincibilityTimer", f.invincibilityTimer[match], static_cast<Sint32>(p.invincibilityTimer.expiresAt)},
+        {"blockCooldownTimer", f.blockCooldownTimer[match], static_cast<Sint32>(p.blockCooldownTimer.expiresAt)},
+        {"attackRateCooldownTimer", f.attackRateCooldownTimer[match], static_cast<Sint32>(p.attackRateCooldownTimer.expiresAt)},
+    };
+    for (const IntField& field : ints) {
+        if (field.env != field.sim) {
+            printf("VecEnv: match %d tick %u players[%d].%s: sim %d, env %d\n",
+                   match, tick, player, field.name, field.sim, field.env);
+            same = false;
+        }
+    }
+    return same;
+}
+
+// 隨機按住一組按鍵一段時間 (跟腳本 AI 輪流使用，涵蓋 AI 不會做的組合)
+struct RandomPresser {
+    Uint32 state;
+    int holdTicks = 0;
+    Uint16 buttons = 0;
+
+    Uint16 next() {
+        if (holdTicks-- > 0) return buttons;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        buttons = static_cast<Uint16>(state >> 8) & VECENV_ACTION_MASK;
+        holdTicks = static_cast<int>(state % 20);
+        return buttons;
+    }
+};
+
+} // namespace
+
+bool validateVecEnv(int matchCount, int ticks, Uint32 seed, bool useAvx2) {
+    logVerbose = false;
+    VecEnv env(matchCount);
+    env.setUseAvx2(useAvx2);
+    matchCount = env.getMatchCount();
+    printf("VecEnv: validating %d matches x %d ticks against the scalar simulation (%s kernel)\n",
+           matchCount, ticks, env.isUsingAvx2() ? "AVX2" : "scalar");
+
+    // 每場比賽各有一個純量模擬，角色/拳套組合輪流
+    std::vector<Game> games(matchCount);
+    std::vector<ScriptedAI> ais;
+    std::vector<RandomPresser> pressers;
+    for (int m = 0; m < matchCount; ++m) {
+        Game& game = games[m];
+        game.isHeadless = true;
+        game.motionCommandsEnabled = false; // 搓招會放特殊技能，不在環境內
+        std::string ids[2] = {(m & 1) ? "Godon" : "BlockMan", (m & 2) ? "Godon" : "BlockMan"};
+        game.createPlayers(ids[0], ids[1]);
+        for (int p = 0; p < 2; ++p) {
+            game.selectedGloveIndex[p] = (m / 4 + p) % GLOVE_TYPE_COUNT;
+            env.setLoadout(m, p, ids[p], game.selectedGloveIndex[p]);
+        }
+        game.startGameAfterGloveSelection();
+        env.resetMatch(m);
+        for (int p = 0; p < 2; ++p) {
+            ais.push_back(ScriptedAI(seed + m * 2 + p));
+            pressers.push_back(RandomPresser{(seed + m * 2 + p) * 2654435761u | 1u});
+        }
+    }
+
+    std::vector<Uint16> actions(matchCount * 2);
+    int rounds = 0, mismatches = 0;
+    for (Uint32 tick = 0; tick < static_cast<Uint32>(ticks) && mismatches < 10; ++tick) {
+        for (int m = 0; m < matchCount; ++m) {
+            for (int p = 0; p < 2; ++p) {
+                Uint16 buttons = (m % 3 == 2) ? pressers[m * 2 + p].next() : ais[m * 2 + p].decide(games[m], p);
+                actions[m * 2 + p] = buttons & VECENV_ACTION_MASK;
+            }
+        }
+        env.step(actions.data());
+
+        for (int m = 0; m < matchCount; ++m) {
+            Game& game = games[m];
+            TickInput input;
+            input.buttons[0] = actions[m * 2];
+            input.buttons[1] = actions[m * 2 + 1];
+            game.simulateMatchTick(input, FIXED_DELTA_TIME);
+
+            bool same = compareFighter(env, m, 0, game.players[0], tick) &
+                        compareFighter(env, m, 1, game.players[1], tick);
+            bool simDone = (game.currentGameState != GameState::PLAYING);
+            if (simDone != env.isDone(m) || (simDone && game.roundWinnerIndex != env.getWinner(m))) {
+                printf("VecEnv: match %d tick %u round end: sim %d (winner %d), env %d (winner %d)\n",
+                       m, tick, simDone, game.roundWinnerIndex, env.isDone(m), env.getWinner(m));
+                same = false;
+            }
+            if (!same) ++mismatches;
+            if (simDone) {
+                ++rounds;
+                game.startGameAfterGloveSelection(); // 環境下一步會自動重置
+            }
+        }
+    }
+
+    if (mismatches > 0) {
+        printf("VecEnv: FAILED, state differs from the scalar simulation\n");
+        return false;
+    }
+    printf("VecEnv: OK, %lld match-ticks identical (%d rounds finished)\n",
+           static_cast<long long>(matchCount) * ticks, rounds);
+    return true;
+}
+
+// --- 吞吐量 ---
+void benchmarkVecEnv(int matchCount, int ticks) {
+    VecEnv env(matchCount);
+    matchCount = env.getMatchCount();
+
+    // 預先產生一段隨機輸入循環使用，避免量到產生輸入的時間
+    const int ACTION_FRAMES = 64;
+    std::vector<Uint16> actions(static_cast<size_t>(ACTION_FRAMES) * matchCount * 2);
+    RandomPresser presser{12345};
+    for (Uint16& a : actions) a = presser.next();
+
+    for (int pass = 0; pass < 2; ++pass) {
+        bool avx2 = (pass == 1);
+        if (avx2 && !VecEnv::isAvx2Available()) {
+            printf("VecEnv: AVX2 not available on this CPU\n");
+            break;
+        }
+        env.setUseAvx2(avx2);
+        env.reset();
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int t = 0; t < ticks; ++t) {
+            env.step(&actions[static_cast<size_t>(t % ACTION_FRAMES) * matchCount * 2]);
+        }
+        double seconds = static_cast<double>(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+        double steps = static_cast<double>(matchCount) * ticks;
+        printf("VecEnv: %-6s %d matches x %d ticks in %.3f s, %.2f M env-steps/sec\n",
+               avx2 ? "AVX2" : "scalar", matchCount, ticks, seconds, seconds > 0.0 ? steps / seconds / 1e6 : 0.0);
+    }
+}
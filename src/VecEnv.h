@@ -0,0 +1,111 @@
+#ifndef VECENV_H
+#define VECENV_H
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include "Input.h"
+#include "Player.h" // BalanceParams
+#include "SimClock.h"
+
+// --- 向量化環境 (強化學習用) ---
+// 以 structure-of-arrays 同時推進 N 場獨立的比賽 (每場一個回合)，
+// 規則與 Game::applyPlayerInputs / Player::update / Game::checkPlayerCollision 相同，
+// 支援 AVX2 時一次處理 8 場。只涵蓋近身戰鬥 (含普攻的緩衝輸入)：氣功、特殊技能 (含搓招)、
+// 混亂模式與動畫幀不在環境內 (普攻的判定框在設定角色時從動畫資料換算成 tick 範圍，
+// 所以建立環境前要先載入動畫資料；站立時的受擊框假設是整個碰撞尺寸)。
+
+// 環境接受的按鍵 (其餘位元會被忽略)
+const Uint16 VECENV_ACTION_MASK = INPUT_LEFT | INPUT_RIGHT | INPUT_UP | INPUT_DOWN | INPUT_ATTACK | INPUT_BLOCK;
+const int VECENV_LANE_PADDING = 8; // 比賽數補齊成 8 的倍數 (AVX2 一次 8 場)
+
+// 一個玩家位置 (P1 或 P2) 在所有比賽中的狀態，索引為比賽編號
+// 計時器跟 TickTimer 一樣記錄到期的 tick (以該場的 VecEnvLanes::tick 為時鐘)
+struct VecEnvFighters {
+    std::vector<float> x, y, vx, vy;
+    std::vector<Sint32> attackTimer, attackCooldownTimer, hurtTimer;
+    std::vector<Sint32> invincibilityTimer, blockCooldownTimer, attackRateCooldownTimer;
+    std::vector<Sint32> health, direction, state, isOnGround;
+    // 整場固定的角色/拳套數值
+    std::vector<Sint32> logicWidth, logicHeight, attackDamage;
+    std::vector<Sint32> attackCooldownTicks; // 攻擊時間 + 拳套冷卻 (tick)
+    // 判定框 (角色的動畫資料：普攻有攻擊框的幀與躺下的受擊框)
+    std::vector<Sint32> hitboxRightX, hitboxLeftX, hitboxY, hitboxW, hitboxH; // 相對於 (x, y)
+    std::vector<Sint32> attackActiveStart, attackActiveEnd; // 普攻開始後第幾個 tick 有攻擊框 [start, end)
+    std::vector<Sint32> lyingHeight;
+    std::vector<Sint32> buttons; // 本 tick 的輸入
+    // 普攻的緩衝輸入 (對應 InputHistory：上一個 tick 的輸入、最近一次按下普攻的 tick、是否已經出拳)
+    std::vector<Sint32> prevButtons, attackPressTick, attackPressConsumed;
+    std::vector<Sint32> inputBufferTicks; // BalanceParams::inputBufferTicks
+
+    void resize(int count);
+};
+
+// 所有比賽的狀態 (核心函式直接讀寫這個結構)
+struct VecEnvLanes {
+    int count = 0;                 // 已補齊成 VECENV_LANE_PADDING 的倍數
+    VecEnvFighters fighters[2];
+    std::vector<Sint32> tick;       // 模擬時鐘 (回合開始為 0，對應 Game::matchTick)
+    std::vector<Sint32> roundTimer; // 回合結束的 tick
+    std::vector<Sint32> done;      // 本 tick 回合結束
+    std::vector<Sint32> winner;    // 0: P1, 1: P2, -1: 平手
+};
+
+// 推進一個 tick (VecEnv.cpp 為純量版本，VecEnvAvx2.cpp 為 AVX2 版本)
+void stepVecEnvScalar(VecEnvLanes& lanes);
+void stepVecEnvAvx2(VecEnvLanes& lanes);
+bool hasVecEnvAvx2Kernel(); // 編譯器/平台不支援時為 false
+
+class VecEnv {
+public:
+    explicit VecEnv(int matchCount);
+
+    int getMatchCount() const { return matchCount; }
+
+    // 設定某場比賽某個玩家的角色與拳套 (下一次重置時生效)
+    void setLoadout(int match, int player, const std::string& characterId, int gloveIndex,
+                    const BalanceParams& balance = BalanceParams());
+
+    void reset();                // 所有比賽回到回合開始
+    void resetMatch(int match);
+
+    // actions[match * 2 + player]，與鍵盤輸入相同的按鍵位元。
+    // 上一步已結束的比賽會先自動重置再推進 (Gym 的 auto-reset)。
+    void step(const Uint16* actions);
+
+    bool isDone(int match) const { return lanes.done[match] != 0; }
+    int getWinner(int match) const { return lanes.winner[match]; }
+    float getRoundTimer(int match) const { // 剩餘秒數
+        TickTimer timer;
+        timer.expiresAt = static_cast<Uint32>(lanes.roundTimer[match]);
+        return timer.remainingSeconds(static_cast<Uint32>(lanes.tick[match]));
+    }
+    const VecEnvFighters& getFighters(int player) const { return lanes.fighters[player]; }
+
+    // 是否使用 AVX2 核心 (預設在 CPU 支援時使用)
+    void setUseAvx2(bool use) { useAvx2 = use && isAvx2Available(); }
+    bool isUsingAvx2() const { return useAvx2; }
+    static bool isAvx2Available();
+
+private:
+    int matchCount;
+    VecEnvLanes lanes;
+    bool useAvx2;
+};
+
+// --- 命令列參數 (--vecenv-validate / --vecenv-bench [比賽數] [tick 數]) ---
+struct VecEnvOptions {
+    bool validate = false;
+    bool benchmark = false;
+    int matches = 0;  // 0: 使用預設值
+    int ticks = 0;
+};
+void parseVecEnvArgs(int argc, char* argv[], VecEnvOptions& out);
+
+// 與純量模擬 (Game) 逐 tick 比對，回傳 false 表示有任何欄位不同
+bool validateVecEnv(int matchCount, int ticks, Uint32 seed, bool useAvx2);
+
+// 量測每秒可推進的 env-step 數 (純量與 AVX2 各跑一次)
+void benchmarkVecEnv(int matchCount, int ticks);
+
+#endif // VECENV_H
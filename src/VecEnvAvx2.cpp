@@ -0,0 +1,82 @@
+#include "VecEnv.h"
+#include "Constants.h"
+
+// 只有這個檔案的核心以 AVX2 編譯 (其他標頭先在上面引入，不受影響)，執行時由 VecEnv 檢查 CPU 是否支援。
+// 刻意不開 FMA：乘加融合會讓結果與純量模擬不同。非 x86 或其他編譯器則改用純量核心。
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#include <immintrin.h>
+#include "VecEnvKernel.h"
+
+namespace {
+
+// --- AVX2 通道：一次八場，遮罩以全 1 / 全 0 的 32 位元整數表示 ---
+struct Avx2Lanes {
+    static const int WIDTH = 8;
+    typedef __m256 F;
+    typedef __m256i I;
+    typedef __m256i M;
+
+    static F load(const float* p) { return _mm256_loadu_ps(p); }
+    static I load(const Sint32* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(float* p, F v) { _mm256_storeu_ps(p, v); }
+    static void store(Sint32* p, I v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static F constF(float v) { return _mm256_set1_ps(v); }
+    static I constI(Sint32 v) { return _mm256_set1_epi32(v); }
+
+    static F add(F a, F b) { return _mm256_add_ps(a, b); }
+    static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static F div(F a, F b) { return _mm256_div_ps(a, b); }
+    static F abs(F a) { return _mm256_and_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff))); }
+    static I add(I a, I b) { return _mm256_add_epi32(a, b); }
+    static I sub(I a, I b) { return _mm256_sub_epi32(a, b); }
+    static I half(I a) { return _mm256_srai_epi32(a, 1); } // 只用在正數 (角色尺寸)
+    static I truncate(F a) { return _mm256_cvttps_epi32(a); }
+    static F toFloat(I a) { return _mm256_cvtepi32_ps(a); }
+
+    static M lt(F a, F b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+    static M le(F a, F b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LE_OQ)); }
+    static M gt(F a, F b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+    static M ge(F a, F b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_GE_OQ)); }
+    static M eq(I a, I b) { return _mm256_cmpeq_epi32(a, b); }
+    static M lt(I a, I b) { return _mm256_cmpgt_epi32(b, a); }
+    static M le(I a, I b) { return mNot(_mm256_cmpgt_epi32(a, b)); }
+    static M gt(I a, I b) { return _mm256_cmpgt_epi32(a, b); }
+
+    static M mAnd(M a, M b) { return _mm256_and_si256(a, b); }
+    static M mOr(M a, M b) { return _mm256_or_si256(a, b); }
+    static M mNot(M a) { return _mm256_xor_si256(a, _mm256_set1_epi32(-1)); }
+    static M trueMask() { return _mm256_set1_epi32(-1); }
+    static M falseMask() { return _mm256_setzero_si256(); }
+    static M bitSet(I bits, Sint32 bit) { return mNot(_mm256_cmpeq_epi32(_mm256_and_si256(bits, constI(bit)), falseMask())); }
+    static M toMask(I v) { return mNot(_mm256_cmpeq_epi32(v, falseMask())); }
+    static I fromMask(M m) { return _mm256_and_si256(m, constI(1)); }
+
+    static F sel(M m, F a, F b) { return _mm256_blendv_ps(b, a, _mm256_castsi256_ps(m)); }
+    static I sel(M m, I a, I b) { return _mm256_blendv_epi8(b, a, m); }
+    static M selM(M m, M a, M b) { return _mm256_blendv_epi8(b, a, m); }
+};
+
+} // namespace
+
+void stepVecEnvAvx2(VecEnvLanes& lanes) {
+    vecenv::stepLanes<Avx2Lanes>(lanes);
+}
+
+#pragma GCC pop_options
+
+bool hasVecEnvAvx2Kernel() {
+    return true;
+}
+
+#else
+
+void stepVecEnvAvx2(VecEnvLanes&) {}
+
+bool hasVecEnvAvx2Kernel() {
+    return false;
+}
+
+#endif
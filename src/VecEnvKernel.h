@@ -0,0 +1,507 @@
+#ifndef VECENVKERNEL_H
+#define VECENVKERNEL_H
+
+// --- 向量化環境的規則核心 (只給 VecEnv.cpp / VecEnvAvx2.cpp 使用) ---
+// 規則只寫一次，用「通道型別」L 實例化：L::F / L::I / L::M 分別是浮點、整數與遮罩，
+// 純量版本一次一場，AVX2 版本一次八場。所有分支都改寫成遮罩選擇，
+// 運算順序與 Player / Game 的純量程式碼完全相同，結果逐位元一致。
+
+#include "VecEnv.h"
+#include "Constants.h"
+
+namespace vecenv {
+
+const Sint32 STATE_IDLE      = static_cast<Sint32>(Player::PlayerState::IDLE);
+const Sint32 STATE_WALKING   = static_cast<Sint32>(Player::PlayerState::WALKING);
+const Sint32 STATE_JUMPING   = static_cast<Sint32>(Player::PlayerState::JUMPING);
+const Sint32 STATE_FALLING   = static_cast<Sint32>(Player::PlayerState::FALLING);
+const Sint32 STATE_ATTACKING = static_cast<Sint32>(Player::PlayerState::ATTACKING);
+const Sint32 STATE_HURT      = static_cast<Sint32>(Player::PlayerState::HURT);
+const Sint32 STATE_BLOCKING  = static_cast<Sint32>(Player::PlayerState::BLOCKING);
+const Sint32 STATE_DEATH     = static_cast<Sint32>(Player::PlayerState::DEATH);
+const Sint32 STATE_LYING     = static_cast<Sint32>(Player::PlayerState::LYING);
+
+// 一個玩家位置在 L::WIDTH 場比賽中的暫存值
+template <class L>
+struct FighterLanes {
+    typename L::F x, y, vx, vy;
+    typename L::F prevX, prevY; // 本 tick 開始時的位置 (updateFighter 記錄，不寫回)
+    typename L::I attackTimer, attackCooldownTimer, hurtTimer; // 到期的 tick
+    typename L::I invincibilityTimer, blockCooldownTimer, attackRateCooldownTimer;
+    typename L::I attackCooldownTicks;
+    typename L::I now; // 本 tick 的模擬時鐘 (不寫回)
+    typename L::I health, direction, state;
+    typename L::I logicWidth, logicHeight, attackDamage, buttons;
+    typename L::I prevButtons, attackPressTick, attackPressConsumed, inputBufferTicks; // 普攻的緩衝輸入
+    // 普攻動畫的判定框 (整場固定，由 VecEnv::setLoadout 從動畫資料查出)
+    typename L::I hitboxRightX, hitboxLeftX, hitboxY, hitboxW, hitboxH;
+    typename L::I attackActiveStart, attackActiveEnd, lyingHeight;
+    typename L::M isOnGround;
+};
+
+template <class L>
+FighterLanes<L> loadFighter(const VecEnvFighters& s, int i) {
+    FighterLanes<L> f;
+    f.x = L::load(&s.x[i]);
+    f.y = L::load(&s.y[i]);
+    f.vx = L::load(&s.vx[i]);
+    f.vy = L::load(&s.vy[i]);
+    f.attackTimer = L::load(&s.attackTimer[i]);
+    f.attackCooldownTimer = L::load(&s.attackCooldownTimer[i]);
+    f.hurtTimer = L::load(&s.hurtTimer[i]);
+    f.invincibilityTimer = L::load(&s.invincibilityTimer[i]);
+    f.blockCooldownTimer = L::load(&s.blockCooldownTimer[i]);
+    f.attackRateCooldownTimer = L::load(&s.attackRateCooldownTimer[i]);
+    f.attackCooldownTicks = L::load(&s.attackCooldownTicks[i]);
+    f.health = L::load(&s.health[i]);
+    f.direction = L::load(&s.direction[i]);
+    f.state = L::load(&s.state[i]);
+    f.logicWidth = L::load(&s.logicWidth[i]);
+    f.logicHeight = L::load(&s.logicHeight[i]);
+    f.attackDamage = L::load(&s.attackDamage[i]);
+    f.buttons = L::load(&s.buttons[i]);
+    f.prevButtons = L::load(&s.prevButtons[i]);
+    f.attackPressTick = L::load(&s.attackPressTick[i]);
+    f.attackPressConsumed = L::load(&s.attackPressConsumed[i]);
+    f.inputBufferTicks = L::load(&s.inputBufferTicks[i]);
+    f.hitboxRightX = L::load(&s.hitboxRightX[i]);
+    f.hitboxLeftX = L::load(&s.hitboxLeftX[i]);
+    f.hitboxY = L::load(&s.hitboxY[i]);
+    f.hitboxW = L::load(&s.hitboxW[i]);
+    f.hitboxH = L::load(&s.hitboxH[i]);
+    f.attackActiveStart = L::load(&s.attackActiveStart[i]);
+    f.attackActiveEnd = L::load(&s.attackActiveEnd[i]);
+    f.lyingHeight = L::load(&s.lyingHeight[i]);
+    f.isOnGround = L::toMask(L::load(&s.isOnGround[i]));
+    return f;
+}
+
+template <class L>
+void storeFighter(VecEnvFighters& s, int i, const FighterLanes<L>& f) {
+    L::store(&s.x[i], f.x);
+    L::store(&s.y[i], f.y);
+    L::store(&s.vx[i], f.vx);
+    L::store(&s.vy[i], f.vy);
+    L::store(&s.attackTimer[i], f.attackTimer);
+    L::store(&s.attackCooldownTimer[i], f.attackCooldownTimer);
+    L::store(&s.hurtTimer[i], f.hurtTimer);
+    L::store(&s.invincibilityTimer[i], f.invincibilityTimer);
+    L::store(&s.blockCooldownTimer[i], f.blockCooldownTimer);
+    L::store(&s.attackRateCooldownTimer[i], f.attackRateCooldownTimer);
+    L::store(&s.health[i], f.health);
+    L::store(&s.direction[i], f.direction);
+    L::store(&s.state[i], f.state);
+    L::store(&s.prevButtons[i], f.prevButtons);
+    L::store(&s.attackPressTick[i], f.attackPressTick);
+    L::store(&s.attackPressConsumed[i], f.attackPressConsumed);
+    L::store(&s.isOnGround[i], L::fromMask(f.isOnGround));
+}
+
+// m 為真的通道取 a，否則取 b (只選會隨模擬改變的欄位)
+template <class L>
+FighterLanes<L> selectFighter(typename L::M m, const FighterLanes<L>& a, const FighterLanes<L>& b) {
+    FighterLanes<L> r = b;
+    r.x = L::sel(m, a.x, b.x);
+    r.y = L::sel(m, a.y, b.y);
+    r.vx = L::sel(m, a.vx, b.vx);
+    r.vy = L::sel(m, a.vy, b.vy);
+    r.attackTimer = L::sel(m, a.attackTimer, b.attackTimer);
+    r.attackCooldownTimer = L::sel(m, a.attackCooldownTimer, b.attackCooldownTimer);
+    r.hurtTimer = L::sel(m, a.hurtTimer, b.hurtTimer);
+    r.invincibilityTimer = L::sel(m, a.invincibilityTimer, b.invincibilityTimer);
+    r.blockCooldownTimer = L::sel(m, a.blockCooldownTimer, b.blockCooldownTimer);
+    r.attackRateCooldownTimer = L::sel(m, a.attackRateCooldownTimer, b.attackRateCooldownTimer);
+    r.health = L::sel(m, a.health, b.health);
+    r.direction = L::sel(m, a.direction, b.direction);
+    r.state = L::sel(m, a.state, b.state);
+    r.prevButtons = L::sel(m, a.prevButtons, b.prevButtons);
+    r.attackPressTick = L::sel(m, a.attackPressTick, b.attackPressTick);
+    r.attackPressConsumed = L::sel(m, a.attackPressConsumed, b.attackPressConsumed);
+    r.isOnGround = L::selM(m, a.isOnGround, b.isOnGround);
+    return r;
+}
+
+template <class L>
+typename L::M inState(const FighterLanes<L>& f, Sint32 state) {
+    return L::eq(f.state, L::constI(state));
+}
+
+template <class L>
+void setState(FighterLanes<L>& f, typename L::M m, Sint32 state) {
+    f.state = L::sel(m, L::constI(state), f.state);
+}
+
+// TickTimer::isActive
+template <class L>
+typename L::M timerActive(const FighterLanes<L>& f, typename L::I timer) {
+    return L::lt(f.now, timer);
+}
+
+// m 為真的通道啟動計時器 (TickTimer::start)
+template <class L>
+typename L::I startTimer(const FighterLanes<L>& f, typename L::M m, typename L::I timer, typename L::I ticks) {
+    return L::sel(m, L::add(f.now, ticks), timer);
+}
+
+template <class L>
+typename L::I timerTicks(float seconds) {
+    return L::constI(static_cast<Sint32>(secondsToTicks(seconds)));
+}
+
+// Player::executeCommand 開頭的共同條件 (躺下被擊倒中、死亡、受傷時不能行動)
+template <class L>
+typename L::M canAct(const FighterLanes<L>& f) {
+    typename L::M knockedDown = L::mAnd(inState(f, STATE_LYING), timerActive<L>(f, f.hurtTimer));
+    typename L::M down = L::mOr(L::le(f.health, L::constI(0)), inState(f, STATE_HURT));
+    return L::mNot(L::mOr(knockedDown, down));
+}
+
+// CMD_STOP_X
+template <class L>
+void actionStopX(FighterLanes<L>& f, typename L::M m) {
+    m = L::mAnd(L::mAnd(m, canAct(f)), inState(f, STATE_WALKING));
+    f.vx = L::sel(m, L::constF(0.0f), f.vx);
+    setState(f, L::mAnd(m, f.isOnGround), STATE_IDLE);
+}
+
+// --- Game::applyPlayerInputs (不含氣功/技能、搓招與控制反轉) ---
+template <class L>
+void applyInput(FighterLanes<L>& f) {
+    typedef typename L::M M;
+    // 緩衝輸入 (InputHistory)：只需要記住最近一次按下普攻的 tick 與是否已經出拳
+    M attackHeld = L::bitSet(f.buttons, INPUT_ATTACK);
+    M attackPressed = L::mAnd(attackHeld, L::mNot(L::bitSet(f.prevButtons, INPUT_ATTACK)));
+    f.attackPressTick = L::sel(attackPressed, f.now, f.attackPressTick);
+    f.attackPressConsumed = L::sel(attackPressed, L::constI(0), f.attackPressConsumed);
+    f.prevButtons = f.buttons;
+    M buffered = L::mAnd(L::eq(f.attackPressConsumed, L::constI(0)),
+                         L::le(L::sub(f.now, f.attackPressTick), f.inputBufferTicks));
+    M attackRequest = L::mOr(attackHeld, buffered);
+
+    M alive = L::mAnd(L::gt(f.health, L::constI(0)), L::mNot(inState(f, STATE_DEATH)));
+    M block = L::mAnd(alive, L::bitSet(f.buttons, INPUT_BLOCK));
+    M free = L::mAnd(alive, L::mNot(L::bitSet(f.buttons, INPUT_BLOCK)));
+
+    // 按住格擋：BLOCK 再 STOP_X
+    M airborne = L::mOr(L::mOr(inState(f, STATE_ATTACKING), inState(f, STATE_JUMPING)), inState(f, STATE_FALLING));
+    M m = L::mAnd(L::mAnd(block, canAct(f)), f.isOnGround);
+    m = L::mAnd(L::mAnd(m, L::mNot(timerActive<L>(f, f.blockCooldownTimer))), L::mNot(airborne));
+    f.vx = L::sel(m, L::constF(0.0f), f.vx);
+    setState(f, m, STATE_BLOCKING);
+    actionStopX(f, L::mAnd(block, L::mNot(inState(f, STATE_BLOCKING))));
+
+    // 放開格擋：STOP_BLOCK
+    m = L::mAnd(free, inState(f, STATE_BLOCKING));
+    setState(f, m, STATE_IDLE);
+    f.blockCooldownTimer = startTimer<L>(f, L::mAnd(m, L::mNot(timerActive<L>(f, f.blockCooldownTimer))),
+                                         f.blockCooldownTimer, timerTicks<L>(BLOCK_COOLDOWN));
+
+    // 跳躍
+    M notBlocking = L::mNot(inState(f, STATE_BLOCKING));
+    m = L::mAnd(L::mAnd(free, L::bitSet(f.buttons, INPUT_UP)), canAct(f));
+    m = L::mAnd(L::mAnd(m, notBlocking), L::mAnd(f.isOnGround, L::mNot(inState(f, STATE_ATTACKING))));
+    f.vy = L::sel(m, L::constF(-JUMP_STRENGTH), f.vy);
+    f.isOnGround = L::selM(m, L::falseMask(), f.isOnGround);
+    setState(f, m, STATE_JUMPING);
+
+    // 普攻
+    notBlocking = L::mNot(inState(f, STATE_BLOCKING));
+    m = L::mAnd(L::mAnd(free, attackRequest), canAct(f));
+    m = L::mAnd(L::mAnd(m, notBlocking), L::mNot(inState(f, STATE_ATTACKING)));
+    m = L::mAnd(m, L::mNot(inState(f, STATE_HURT)));
+    m = L::mAnd(L::mAnd(m, L::mNot(timerActive<L>(f, f.attackCooldownTimer))),
+                L::mNot(timerActive<L>(f, f.attackRateCooldownTimer)));
+    f.attackTimer = startTimer<L>(f, m, f.attackTimer, timerTicks<L>(ATTACK_DURATION));
+    f.attackCooldownTimer = startTimer<L>(f, m, f.attackCooldownTimer, f.attackCooldownTicks);
+    f.attackRateCooldownTimer = startTimer<L>(f, m, f.attackRateCooldownTimer, timerTicks<L>(ATTACK_RATE_COOLDOWN));
+    f.vx = L::sel(m, L::constF(0.0f), f.vx);
+    setState(f, m, STATE_ATTACKING);
+    f.attackPressConsumed = L::sel(m, L::constI(1), f.attackPressConsumed);
+
+    // 蹲下 (躺下)
+    M busy = L::mOr(L::mOr(inState(f, STATE_ATTACKING), inState(f, STATE_JUMPING)), inState(f, STATE_FALLING));
+    busy = L::mOr(busy, L::mOr(inState(f, STATE_BLOCKING), L::mOr(inState(f, STATE_DEATH), inState(f, STATE_HURT))));
+    m = L::mAnd(L::mAnd(free, L::bitSet(f.buttons, INPUT_DOWN)), canAct(f));
+    m = L::mAnd(L::mAnd(m, f.isOnGround), L::mNot(busy));
+    f.vx = L::sel(m, L::constF(0.0f), f.vx);
+    f.vy = L::sel(m, L::constF(0.0f), f.vy);
+    setState(f, m, STATE_LYING);
+
+    // 放開蹲下鍵：起身 (CMD_STAND_UP)
+    m = L::mAnd(L::mAnd(free, L::mNot(L::bitSet(f.buttons, INPUT_DOWN))), canAct(f));
+    setState(f, L::mAnd(m, inState(f, STATE_LYING)), STATE_IDLE);
+
+    // 左右移動，沒按方向鍵就 STOP_X
+    M left = L::mAnd(free, L::bitSet(f.buttons, INPUT_LEFT));
+    M right = L::mAnd(L::mAnd(free, L::mNot(left)), L::bitSet(f.buttons, INPUT_RIGHT));
+    M canWalk = L::mAnd(L::mAnd(canAct(f), L::mNot(inState(f, STATE_BLOCKING))), L::mNot(inState(f, STATE_ATTACKING)));
+    M walkLeft = L::mAnd(left, canWalk);
+    M walkRight = L::mAnd(right, canWalk);
+    M walk = L::mOr(walkLeft, walkRight);
+    f.vx = L::sel(walkLeft, L::constF(-MOVE_SPEED), L::sel(walkRight, L::constF(MOVE_SPEED), f.vx));
+    f.direction = L::sel(walkLeft, L::constI(-1), L::sel(walkRight, L::constI(1), f.direction));
+    setState(f, L::mAnd(walk, f.isOnGround), STATE_WALKING);
+    actionStopX(f, L::mAnd(L::mAnd(free, L::mNot(left)), L::mNot(L::bitSet(f.buttons, INPUT_RIGHT))));
+}
+
+// --- Player::update ---
+template <class L>
+void updateFighter(FighterLanes<L>& f) {
+    typedef typename L::F F;
+    typedef typename L::M M;
+    const F dt = L::constF(FIXED_DELTA_TIME);
+    const F zero = L::constF(0.0f);
+    f.prevX = f.x;
+    f.prevY = f.y;
+    const FighterLanes<L> before = f;
+    M running = L::mNot(inState(f, STATE_DEATH)); // 死亡時只更新動畫
+    const M hurtOver = L::mNot(timerActive<L>(f, f.hurtTimer)); // 時鐘在 tick 內不變
+
+    setState(f, L::mAnd(inState(f, STATE_ATTACKING), L::mNot(timerActive<L>(f, f.attackTimer))), STATE_IDLE);
+    setState(f, L::mAnd(inState(f, STATE_HURT), hurtOver), STATE_IDLE);
+
+    // 格擋中固定在地面
+    const F groundY = L::constF(static_cast<float>(GROUND_LEVEL - PLAYER_LOGIC_HEIGHT));
+    M blocking = inState(f, STATE_BLOCKING);
+    M physics = L::mNot(blocking);
+    f.vx = L::sel(blocking, zero, f.vx);
+    f.vy = L::sel(blocking, zero, f.vy);
+    f.y = L::sel(blocking, groundY, f.y);
+    f.isOnGround = L::selM(blocking, L::trueMask(), f.isOnGround);
+
+    // 重力與移動
+    M air = L::mAnd(physics, L::mNot(f.isOnGround));
+    f.vy = L::sel(air, L::add(f.vy, L::constF(GRAVITY * FIXED_DELTA_TIME)), f.vy);
+    f.y = L::sel(air, L::add(f.y, L::mul(f.vy, dt)), f.y);
+    f.x = L::sel(physics, L::add(f.x, L::mul(f.vx, dt)), f.x);
+
+    // 地面檢測
+    M ground = L::mAnd(physics, L::ge(L::add(f.y, L::constF(static_cast<float>(PLAYER_LOGIC_HEIGHT))),
+                                      L::constF(static_cast<float>(GROUND_LEVEL))));
+    M landing = L::mAnd(ground, L::mNot(f.isOnGround));
+    f.y = L::sel(ground, groundY, f.y);
+    f.vy = L::sel(ground, zero, f.vy);
+    f.isOnGround = L::selM(ground, L::trueMask(), L::selM(physics, L::falseMask(), f.isOnGround));
+    typename L::I settled = L::sel(L::lt(L::abs(f.vx), L::constF(1.0f)), L::constI(STATE_IDLE), L::constI(STATE_WALKING));
+    M landFromAir = L::mOr(L::mOr(inState(f, STATE_JUMPING), inState(f, STATE_FALLING)),
+                           L::mAnd(inState(f, STATE_HURT), hurtOver));
+    M landFromAttack = L::mAnd(L::mNot(landFromAir), inState(f, STATE_ATTACKING));
+    f.attackTimer = L::sel(L::mAnd(landing, landFromAttack), L::constI(0), f.attackTimer);
+    f.state = L::sel(L::mAnd(landing, L::mOr(landFromAir, landFromAttack)), settled, f.state);
+    M falling = L::mAnd(L::mAnd(physics, L::mNot(ground)), L::mOr(inState(f, STATE_IDLE), inState(f, STATE_WALKING)));
+    setState(f, falling, STATE_FALLING);
+
+    // 邊界
+    f.x = L::sel(L::lt(f.x, zero), zero, f.x);
+    f.x = L::sel(L::gt(L::add(f.x, L::constF(static_cast<float>(PLAYER_LOGIC_WIDTH))), L::constF(static_cast<float>(SCREEN_WIDTH))),
+                 L::constF(static_cast<float>(SCREEN_WIDTH - PLAYER_LOGIC_WIDTH)), f.x);
+
+    // 躺下時離地就起身
+    setState(f, L::mAnd(L::mAnd(inState(f, STATE_LYING), hurtOver), L::mNot(f.isOnGround)), STATE_IDLE);
+
+    f = selectFighter<L>(running, f, before);
+}
+
+// --- Player::takeDamage ---
+template <class L>
+void takeDamage(FighterLanes<L>& f, typename L::M m, typename L::I damage) {
+    typedef typename L::M M;
+    const typename L::F zero = L::constF(0.0f);
+    const typename L::I cleared = L::constI(0);
+    m = L::mAnd(m, L::mAnd(L::mNot(timerActive<L>(f, f.invincibilityTimer)), L::mNot(inState(f, STATE_DEATH))));
+
+    M blocked = L::mAnd(m, inState(f, STATE_BLOCKING));
+    f.blockCooldownTimer = startTimer<L>(f, L::mAnd(blocked, L::mNot(timerActive<L>(f, f.blockCooldownTimer))),
+                                         f.blockCooldownTimer, timerTicks<L>(BLOCK_COOLDOWN));
+
+    M hit = L::mAnd(m, L::mNot(blocked));
+    f.health = L::sel(hit, L::sub(f.health, damage), f.health);
+    M dead = L::mAnd(hit, L::le(f.health, L::constI(0)));
+    M hurt = L::mAnd(hit, L::mNot(dead));
+    f.health = L::sel(dead, L::constI(0), f.health);
+    f.state = L::sel(dead, L::constI(STATE_DEATH), L::sel(hurt, L::constI(STATE_HURT), f.state));
+    f.vx = L::sel(hit, zero, f.vx);
+    f.vy = L::sel(dead, zero, L::sel(hurt, L::constF(-100.0f), f.vy));
+    f.isOnGround = L::selM(dead, L::trueMask(), L::selM(hurt, L::falseMask(), f.isOnGround));
+    f.attackTimer = L::sel(hit, cleared, f.attackTimer);
+    f.hurtTimer = L::sel(dead, cleared, startTimer<L>(f, hurt, f.hurtTimer, timerTicks<L>(HURT_DURATION)));
+    f.invincibilityTimer = L::sel(dead, cleared, startTimer<L>(f, hurt, f.invincibilityTimer, timerTicks<L>(HURT_INVINCIBILITY)));
+    f.blockCooldownTimer = L::sel(dead, cleared, f.blockCooldownTimer);
+    f.attackRateCooldownTimer = L::sel(dead, cleared, f.attackRateCooldownTimer);
+}
+
+// 整數矩形 (對應 SDL_Rect)
+template <class L>
+struct RectLanes {
+    typename L::I x, y, w, h;
+};
+
+// Player::getHitboxWorld (攻擊動畫中有攻擊框的幀；普攻開始後經過的 tick 數換算成幀已經在載入時做好)
+template <class L>
+RectLanes<L> hitbox(const FighterLanes<L>& f, typename L::M& active) {
+    typedef typename L::I I;
+    // 普攻開始後經過的 tick 數 (攻擊計時器清除時遠大於攻擊時間，不會成立)
+    I elapsed = L::sub(L::add(f.now, L::constI(static_cast<Sint32>(secondsToTicks(ATTACK_DURATION)))), f.attackTimer);
+    active = L::mAnd(inState(f, STATE_ATTACKING),
+                     L::mAnd(L::mNot(L::lt(elapsed, f.attackActiveStart)), L::lt(elapsed, f.attackActiveEnd)));
+    RectLanes<L> r;
+    r.w = f.hitboxW;
+    r.h = f.hitboxH;
+    r.x = L::add(L::truncate(f.x), L::sel(L::eq(f.direction, L::constI(1)), f.hitboxRightX, f.hitboxLeftX));
+    r.y = L::add(L::truncate(f.y), f.hitboxY);
+    return r;
+}
+
+// Player::getBoundingBox (站立時為整個碰撞尺寸，躺下時貼齊地面變矮)
+template <class L>
+RectLanes<L> boundingBox(const FighterLanes<L>& f) {
+    typename L::M lying = inState(f, STATE_LYING);
+    RectLanes<L> r;
+    r.x = L::truncate(f.x);
+    r.y = L::sel(lying, L::sub(L::constI(GROUND_LEVEL), f.lyingHeight), L::truncate(f.y));
+    r.w = f.logicWidth;
+    r.h = L::sel(lying, f.lyingHeight, f.logicHeight);
+    return r;
+}
+
+// 掃掠 AABB 的單一軸 (Broadphase.cpp 的 sweepAxis)：回傳有效的通道，並寫入重疊的時間範圍
+template <class L>
+typename L::M sweepAxis(typename L::F aMin, typename L::F aMax, typename L::F bMin, typename L::F bMax, typename L::F d,
+                        typename L::F& enter, typename L::F& exit) {
+    typedef typename L::F F;
+    typedef typename L::M M;
+    const F zero = L::constF(0.0f);
+    M still = L::mAnd(L::ge(d, zero), L::le(d, zero));
+    M positive = L::gt(d, zero);
+    // 位移為 0 的通道除以 0 的結果不會被選到
+    F t0 = L::div(L::sub(bMin, aMax), d);
+    F t1 = L::div(L::sub(bMax, aMin), d);
+    enter = L::sel(still, zero, L::sel(positive, t0, t1));
+    exit = L::sel(still, L::constF(1.0f), L::sel(positive, t1, t0));
+    M overlapping = L::mAnd(L::lt(aMin, bMax), L::gt(aMax, bMin));
+    return L::mOr(L::mNot(still), overlapping);
+}
+
+// 攻擊框掃過受擊框 (Game::resolveCollisions 的 sweepProxies)，兩個框各自跟著玩家移動
+template <class L>
+typename L::M sweepAttack(const RectLanes<L>& attackBox, const FighterLanes<L>& attacker,
+                          const RectLanes<L>& targetBox, const FighterLanes<L>& target, typename L::F& toi) {
+    typedef typename L::F F;
+    typedef typename L::M M;
+    F adx = L::sub(attacker.x, attacker.prevX);
+    F ady = L::sub(attacker.y, attacker.prevY);
+    F bdx = L::sub(target.x, target.prevX);
+    F bdy = L::sub(target.y, target.prevY);
+    F aLeft = L::toFloat(attackBox.x), aRight = L::toFloat(L::add(attackBox.x, attackBox.w));
+    F aTop = L::toFloat(attackBox.y), aBottom = L::toFloat(L::add(attackBox.y, attackBox.h));
+    F bLeft = L::toFloat(targetBox.x), bRight = L::toFloat(L::add(targetBox.x, targetBox.w));
+    F bTop = L::toFloat(targetBox.y), bBottom = L::toFloat(L::add(targetBox.y, targetBox.h));
+    F enterX, exitX, enterY, exitY;
+    M m = sweepAxis<L>(L::sub(aLeft, adx), L::sub(aRight, adx), L::sub(bLeft, bdx), L::sub(bRight, bdx),
+                       L::sub(adx, bdx), enterX, exitX);
+    m = L::mAnd(m, sweepAxis<L>(L::sub(aTop, ady), L::sub(aBottom, ady), L::sub(bTop, bdy), L::sub(bBottom, bdy),
+                                L::sub(ady, bdy), enterY, exitY));
+    // std::max / std::min 的比較方向
+    F enter = L::sel(L::lt(enterX, enterY), enterY, enterX);
+    F exit = L::sel(L::lt(exitY, exitX), exitY, exitX);
+    m = L::mAnd(m, L::mNot(L::ge(enter, exit)));
+    m = L::mAnd(m, L::mNot(L::gt(enter, L::constF(1.0f))));
+    m = L::mAnd(m, L::mNot(L::le(exit, L::constF(0.0f))));
+    toi = L::sel(L::lt(enter, L::constF(0.0f)), L::constF(0.0f), enter);
+    return m;
+}
+
+// 一方的普攻判定 (Game::resolveMeleeHit)：較早的命中可能已經打斷這次攻擊，所以重新檢查攻擊狀態
+template <class L>
+void resolveAttack(FighterLanes<L>& attacker, FighterLanes<L>& defender, typename L::M m) {
+    typename L::M stillActive;
+    hitbox<L>(attacker, stillActive);
+    m = L::mAnd(L::mAnd(m, inState(attacker, STATE_ATTACKING)), stillActive);
+    m = L::mAnd(m, L::mNot(inState(defender, STATE_BLOCKING)));
+    takeDamage<L>(defender, m, attacker.attackDamage);
+}
+
+// --- Game::resolveCollisions (近身攻擊與推擠) ---
+template <class L>
+void collide(FighterLanes<L>& p1, FighterLanes<L>& p2) {
+    typedef typename L::F F;
+    typedef typename L::M M;
+    M alive1 = L::mAnd(L::gt(p1.health, L::constI(0)), L::mNot(inState(p1, STATE_DEATH)));
+    M alive2 = L::mAnd(L::gt(p2.health, L::constI(0)), L::mNot(inState(p2, STATE_DEATH)));
+    M live = L::mAnd(alive1, alive2);
+
+    // 判定框在任何一方受傷前就決定，命中依碰撞時間先後結算 (同時命中時 P1 先)
+    M active1, active2;
+    RectLanes<L> box1 = hitbox<L>(p1, active1);
+    RectLanes<L> box2 = hitbox<L>(p2, active2);
+    RectLanes<L> body1 = boundingBox<L>(p1);
+    RectLanes<L> body2 = boundingBox<L>(p2);
+    F toi1, toi2;
+    M hit1 = L::mAnd(L::mAnd(live, active1), sweepAttack<L>(box1, p1, body2, p2, toi1));
+    M hit2 = L::mAnd(L::mAnd(live, active2), sweepAttack<L>(box2, p2, body1, p1, toi2));
+    M p2First = L::mAnd(hit2, L::mOr(L::mNot(hit1), L::lt(toi2, toi1)));
+    resolveAttack<L>(p2, p1, p2First);
+    resolveAttack<L>(p1, p2, hit1);
+    resolveAttack<L>(p2, p1, L::mAnd(hit2, L::mNot(p2First)));
+
+    // 防止重疊
+    const F width = L::constF(static_cast<float>(PLAYER_LOGIC_WIDTH));
+    F p1Right = L::add(p1.x, width);
+    F p2Right = L::add(p2.x, width);
+    F overlap = L::sub(p1Right, p2.x);
+    M push = L::mAnd(L::mAnd(live, L::gt(p1Right, p2.x)), L::lt(p1.x, p2Right));
+    push = L::mAnd(push, L::gt(overlap, L::constF(0.0f)));
+    F distance = L::div(overlap, L::constF(2.0f));
+    p1.x = L::sel(push, L::sub(p1.x, distance), p1.x);
+    p2.x = L::sel(push, L::add(p2.x, distance), p2.x);
+}
+
+// --- 一個 tick (Game::advanceMatchState 的 PLAYING 分支) ---
+template <class L>
+void stepLanes(VecEnvLanes& lanes) {
+    typedef typename L::I I;
+    typedef typename L::M M;
+    for (int i = 0; i < lanes.count; i += L::WIDTH) {
+        FighterLanes<L> p1 = loadFighter<L>(lanes.fighters[0], i);
+        FighterLanes<L> p2 = loadFighter<L>(lanes.fighters[1], i);
+        const I now = L::load(&lanes.tick[i]);
+        p1.now = now;
+        p2.now = now;
+
+        applyInput<L>(p1);
+        applyInput<L>(p2);
+        const FighterLanes<L> p1AfterInput = p1;
+        const FighterLanes<L> p2AfterInput = p2;
+
+        // 有人死亡：回合結束，本 tick 不再更新
+        M dead1 = L::mAnd(L::le(p1.health, L::constI(0)), inState(p1, STATE_DEATH));
+        M dead2 = L::mAnd(L::le(p2.health, L::constI(0)), inState(p2, STATE_DEATH));
+        M endedByDeath = L::mOr(dead1, dead2);
+        M active = L::mNot(endedByDeath);
+        I winner = L::sel(dead1, L::constI(1), L::constI(0));
+
+        // 時間到：血量多的獲勝，本 tick 仍然繼續更新
+        I roundTimer = L::load(&lanes.roundTimer[i]);
+        M timeUp = L::mAnd(active, L::mNot(L::lt(now, roundTimer)));
+        I byHealth = L::sel(L::gt(p1.health, p2.health), L::constI(0),
+                            L::sel(L::gt(p2.health, p1.health), L::constI(1), L::constI(-1)));
+        winner = L::sel(timeUp, byHealth, winner);
+
+        updateFighter<L>(p1);
+        updateFighter<L>(p2);
+        collide<L>(p1, p2);
+
+        p1 = selectFighter<L>(active, p1, p1AfterInput);
+        p2 = selectFighter<L>(active, p2, p2AfterInput);
+        storeFighter<L>(lanes.fighters[0], i, p1);
+        storeFighter<L>(lanes.fighters[1], i, p2);
+        L::store(&lanes.tick[i], L::add(now, L::constI(1)));
+        M done = L::mOr(endedByDeath, timeUp);
+        L::store(&lanes.done[i], L::fromMask(done));
+        L::store(&lanes.winner[i], L::sel(done, winner, L::constI(-1)));
+    }
+}
+
+} // namespace vecenv
+
+#endif // VECENVKERNEL_H
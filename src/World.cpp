@@ -0,0 +1,82 @@
+#include "World.h"
+#include "SimClock.h"
+#include "TextureManager.h"
+
+World::World() : projectiles(MAX_PROJECTILES) {
+    effects.allocate(EFFECT_COMPONENTS, MAX_EFFECTS);
+}
+
+Uint32 World::nextEffectRandom() {
+    effectRngState ^= effectRngState << 13;
+    effectRngState ^= effectRngState >> 17;
+    effectRngState ^= effectRngState << 5;
+    return effectRngState;
+}
+
+void World::integrate(float deltaTime, Uint32 now) {
+    // 氣功：整批水平移動 (CPU 支援時用 AVX2)，飛出畫面的標記為失效
+    projectiles.integrate(deltaTime);
+
+    // 特效粒子：重力 + 移動，壽命到了標記為失效
+    ArchetypeLanes& e = effects;
+    for (int i = 0; i < e.count; ++i) {
+        e.vy[i] += GRAVITY * deltaTime;
+        e.x[i] += e.vx[i] * deltaTime;
+        e.y[i] += e.vy[i] * deltaTime;
+        e.alive[i] = (now < e.expiresAt[i] && e.y[i] < GROUND_LEVEL) ? 1 : 0;
+    }
+}
+
+void World::removeInactive() {
+    projectiles.removeInactive();
+    effects.removeInactive();
+}
+
+void World::clear() {
+    projectiles.clear();
+    effects.clear();
+}
+
+void World::spawnHitSparks(float x, float y, int direction, bool blocked, Uint32 now) {
+    Uint32 lifetime = secondsToTicks(HIT_SPARK_LIFETIME);
+    for (int k = 0; k < HIT_SPARK_COUNT; ++k) {
+        int i = effects.add();
+        if (i < 0) return; // 粒子滿了就少噴幾個
+        Uint32 r = nextEffectRandom();
+        float spreadX = 0.3f + (r & 0xFF) / 255.0f * 0.7f;         // 0.3 ~ 1.0
+        float spreadY = 0.2f + ((r >> 8) & 0xFF) / 255.0f * 0.8f;  // 0.2 ~ 1.0
+        effects.x[i] = x;
+        effects.y[i] = y + static_cast<float>(static_cast<int>((r >> 16) % 21) - 10);
+        effects.vx[i] = direction * HIT_SPARK_SPEED * spreadX;
+        effects.vy[i] = -HIT_SPARK_SPEED * spreadY;
+        effects.expiresAt[i] = now + lifetime - (r >> 24) % 4; // 錯開消失的時間
+        effects.sprite[i] = blocked ? EFFECT_SPRITE_BLOCK_SPARK : EFFECT_SPRITE_HIT_SPARK;
+    }
+}
+
+void World::render(SDL_Renderer* renderer, Uint32 now) const {
+    // 氣功
+    for (int i = 0; i < projectiles.size(); ++i) {
+        const Projectile proj = projectiles.get(i);
+        SDL_Texture* projTex = TextureManager::getTexture(proj.getSprite().textureId);
+        if (proj.isActive && projTex) {
+            SDL_Rect destRect = {(int)proj.x, (int)proj.y, PROJECTILE_HITBOX_W, PROJECTILE_HITBOX_H};
+            SDL_RenderCopy(renderer, projTex, &proj.getSprite().srcRect, &destRect);
+        }
+    }
+
+    // 特效粒子 (剩下的壽命越短越透明)
+    if (effects.count == 0) return;
+    const float lifetime = static_cast<float>(secondsToTicks(HIT_SPARK_LIFETIME));
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    for (int i = 0; i < effects.count; ++i) {
+        if (!effects.alive[i] || now >= effects.expiresAt[i]) continue;
+        const EffectStyle& style = EFFECT_STYLES[effects.sprite[i]];
+        float remaining = (effects.expiresAt[i] - now) / lifetime;
+        Uint8 alpha = static_cast<Uint8>(255.0f * (remaining > 1.0f ? 1.0f : remaining));
+        SDL_SetRenderDrawColor(renderer, style.r, style.g, style.b, alpha);
+        SDL_Rect rect = {(int)effects.x[i] - style.size / 2, (int)effects.y[i] - style.size / 2, style.size, style.size};
+        SDL_RenderFillRect(renderer, &rect);
+    }
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
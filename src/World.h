@@ -0,0 +1,58 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <SDL2/SDL.h>
+#include "Constants.h"
+#include "Archetype.h"
+#include "Projectile.h"
+
+// --- 特效粒子的外觀 (粒子只存這個表的索引) ---
+struct EffectStyle {
+    int size;
+    Uint8 r, g, b;
+};
+
+enum EffectSpriteId : Uint8 {
+    EFFECT_SPRITE_HIT_SPARK = 0,   // 命中的火花
+    EFFECT_SPRITE_BLOCK_SPARK = 1  // 被格擋的火花
+};
+
+const EffectStyle EFFECT_STYLES[] = {
+    {6, 255, 220, 80},
+    {5, 160, 210, 255},
+};
+
+// 特效粒子 archetype 的元件：位置/速度、重力、壽命、外觀
+const Uint16 EFFECT_COMPONENTS = COMPONENT_MOTION | COMPONENT_GRAVITY | COMPONENT_LIFETIME | COMPONENT_SPRITE;
+
+// --- 場上除了玩家以外的所有實體 ---
+// 每一種實體是一個 archetype (元件組合相同、各元件是緊密的陣列)，移動/壽命/移除/繪製都是系統整批處理，
+// Game 只在 tick 的固定位置呼叫這些系統，新增一種實體只要多一個 archetype，不必在 Game 各處加迴圈。
+// 玩家的狀態機與快照仍在 Player；批次訓練用的 VecEnv 另有一份玩家的 structure-of-arrays (FighterLanes)。
+class World {
+public:
+    World();
+
+    ProjectilePool projectiles; // 氣功 (會命中玩家，存進快照)
+    ArchetypeLanes effects;     // 特效粒子 (只有外觀，不存進快照也不算進狀態雜湊)
+
+    // 移動系統 (氣功飛出畫面、粒子壽命到期都標記為失效)，在模擬 tick 中呼叫
+    void integrate(float deltaTime, Uint32 now);
+    // 移除本 tick 失效的實體
+    void removeInactive();
+    void clear();
+    // 清除特效 (回滾/跳轉重播時，特效不屬於模擬狀態)
+    void clearEffects() { effects.clear(); }
+
+    // 命中點噴出火花 (direction: 火花飛出的水平方向)
+    void spawnHitSparks(float x, float y, int direction, bool blocked, Uint32 now);
+
+    // 繪製系統：氣功與特效粒子
+    void render(SDL_Renderer* renderer, Uint32 now) const;
+
+private:
+    Uint32 effectRngState = 0x9E3779B9u; // 粒子專用亂數 (不影響模擬，所以不用存進快照)
+    Uint32 nextEffectRandom();
+};
+
+#endif // WORLD_H
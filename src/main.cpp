@@ -1,13 +1,95 @@
 #include "Game.h" // 只需要包含 Game.h
+#include "BatchRunner.h"
+#include "VecEnv.h"
 
 int main(int argc, char* argv[]) {
+    // 離線比對兩份狀態雜湊記錄 (--hash-diff a b)，不需要開視窗
+    StateHashOptions hashOptions;
+    parseStateHashArgs(argc, argv, hashOptions);
+    if (!hashOptions.diffPaths[0].empty()) {
+        return StateHashLog::compareFiles(hashOptions.diffPaths[0], hashOptions.diffPaths[1]) ? 0 : 1;
+    }
+
+    // 無畫面模擬 (例如 --headless --matches 100 --p1 godon)
+    HeadlessConfig headlessConfig;
+    if (!parseHeadlessArgs(argc, argv, headlessConfig)) {
+        return 1;
+    }
+
+    // 平衡性批次對戰 (例如 --batch --matches 100 --sweep glove-damage-18=10,12,14)
+    BatchConfig batchConfig;
+    if (!parseBatchArgs(argc, argv, batchConfig)) {
+        return 1;
+    }
+
+    // 向量化環境：跟純量模擬逐 tick 比對，或量測吞吐量
+    VecEnvOptions vecEnvOptions;
+    parseVecEnvArgs(argc, argv, vecEnvOptions);
+
+    // 氣功池核心的基準測試 (--projectile-bench [氣功數] [tick 數])
+    ProjectileBenchOptions projectileBenchOptions;
+    parseProjectileBenchArgs(argc, argv, projectileBenchOptions);
+
     Game game; // 創建 Game 物件
 
+    if (projectileBenchOptions.enabled) {
+        bool ok = game.initializeHeadless() &&
+                  benchmarkProjectiles(projectileBenchOptions.count > 0 ? projectileBenchOptions.count : 10000,
+                                       projectileBenchOptions.ticks > 0 ? projectileBenchOptions.ticks : 1000);
+        game.cleanup();
+        return ok ? 0 : 1;
+    }
+
+    if (vecEnvOptions.validate || vecEnvOptions.benchmark) {
+        bool ok = game.initializeHeadless();
+        if (ok && vecEnvOptions.validate) {
+            int matches = vecEnvOptions.matches > 0 ? vecEnvOptions.matches : 64;
+            int ticks = vecEnvOptions.ticks > 0 ? vecEnvOptions.ticks : 20000;
+            ok = validateVecEnv(matches, ticks, 1, false);
+            if (ok && VecEnv::isAvx2Available()) ok = validateVecEnv(matches, ticks, 1, true);
+        }
+        if (ok && vecEnvOptions.benchmark) {
+            benchmarkVecEnv(vecEnvOptions.matches > 0 ? vecEnvOptions.matches : 4096,
+                            vecEnvOptions.ticks > 0 ? vecEnvOptions.ticks : 2000);
+        }
+        game.cleanup();
+        return ok ? 0 : 1;
+    }
+
+    if (batchConfig.enabled) {
+        bool ok = game.initializeHeadless() && runBalanceBatch(batchConfig);
+        game.cleanup();
+        return ok ? 0 : 1;
+    }
+
+    if (headlessConfig.enabled) {
+        if (game.initializeHeadless()) {
+            game.setupStateHashLog(hashOptions);
+            game.runHeadless(headlessConfig);
+        }
+        game.cleanup();
+        return 0;
+    }
+
+    // 連線對戰參數 (例如 --netplay 7000 127.0.0.1:7001 --player 1)
+    NetplayConfig netConfig;
+    if (!parseNetplayArgs(argc, argv, netConfig)) {
+        return 1;
+    }
+
+    // 輸入延遲量測 (例如 --latency-csv latency.csv --frame-delay 8)
+    LatencyOptions latencyOptions;
+    parseLatencyArgs(argc, argv, latencyOptions);
+
     if (game.initialize()) { // 初始化遊戲
-        game.run(); // 運行遊戲主迴圈
+        game.setupStateHashLog(hashOptions);
+        game.setupLatency(latencyOptions);
+        if (!netConfig.enabled || game.startNetplay(netConfig)) {
+            game.run(); // 運行遊戲主迴圈
+        }
     }
 
     game.cleanup(); // 清理資源
 
     return 0; // 程式結束
-}
\ No newline at end of file
+}